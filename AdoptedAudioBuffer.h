@@ -0,0 +1,99 @@
+//=======================================================================
+/** @file AdoptedAudioBuffer.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioBufferView.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+//=============================================================
+/** Audio held in memory that was allocated outside the library, which the buffer takes
+ * ownership of. When the last copy of the buffer is destroyed, it calls a deleter you
+ * provide to free the memory.
+ *
+ * This lets audio you generate yourself (e.g. in a buffer from your own allocator, or from a
+ * mapped file) be handed around and saved with AudioFile::save() without copying it into an
+ * AudioFile. Copies of the buffer share the same samples, which are never copied.
+ */
+template <class T>
+class AdoptedAudioBuffer
+{
+public:
+    
+    //=============================================================
+    typedef std::function<void()> Deleter;
+    
+    //=============================================================
+    /** Creates an empty buffer */
+    AdoptedAudioBuffer();
+    
+    /** Takes ownership of the samples in a view. The deleter is called once no copies of the
+     * buffer are left. For views of separate channels, the array of channel pointers is copied,
+     * so only the samples themselves need to outlive the view.
+     */
+    AdoptedAudioBuffer (const AudioBufferView<T>& samples, Deleter deleter);
+    
+    /** Takes ownership of separate buffers for each channel
+     * @param channels an array of numChannels pointers to the first sample of each channel
+     */
+    AdoptedAudioBuffer (T* const* channels, int numChannels, int numSamples, Deleter deleter);
+    
+    //=============================================================
+    /** @Returns the number of channels */
+    int getNumChannels() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamples() const;
+    
+    /** @Returns a view of the samples, which is valid for as long as this buffer (or a copy of it) is */
+    AudioBufferView<T> getView() const;
+    
+    /** Allows the buffer to be used (e.g. saved) as a read-only view */
+    operator AudioBufferView<const T>() const;
+    
+private:
+    
+    //=============================================================
+    struct Storage
+    {
+        ~Storage();
+        
+        std::vector<T*> channels;
+        AudioBufferView<T> view;
+        Deleter deleter;
+    };
+    
+    //=============================================================
+    std::shared_ptr<Storage> storage;
+};
+
+#include "AdoptedAudioBuffer.inl"
@@ -0,0 +1,99 @@
+//=======================================================================
+/** @file AdoptedAudioBuffer.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+AdoptedAudioBuffer<T>::AdoptedAudioBuffer()
+{
+}
+
+//=============================================================
+template <class T>
+AdoptedAudioBuffer<T>::AdoptedAudioBuffer (const AudioBufferView<T>& samples, Deleter deleter)
+ :  storage (std::make_shared<Storage>())
+{
+    storage->view = samples;
+    storage->deleter = std::move (deleter);
+    
+    // views of separate channels point to an array of channel pointers that belongs to the
+    // caller, so the buffer keeps its own copy
+    if (samples.getNumChannels() > 0 && samples.getSampleStride() == 1)
+    {
+        for (int channel = 0; channel < samples.getNumChannels(); channel++)
+            storage->channels.push_back (samples.getPointer (channel));
+        
+        storage->view = AudioBufferView<T> (storage->channels.data(), samples.getNumChannels(), samples.getNumSamples());
+    }
+}
+
+//=============================================================
+template <class T>
+AdoptedAudioBuffer<T>::AdoptedAudioBuffer (T* const* channels, int numChannels, int numSamples, Deleter deleter)
+ :  AdoptedAudioBuffer (AudioBufferView<T> (channels, numChannels, numSamples), std::move (deleter))
+{
+}
+
+//=============================================================
+template <class T>
+int AdoptedAudioBuffer<T>::getNumChannels() const
+{
+    return storage != nullptr ? storage->view.getNumChannels() : 0;
+}
+
+//=============================================================
+template <class T>
+int AdoptedAudioBuffer<T>::getNumSamples() const
+{
+    return storage != nullptr ? storage->view.getNumSamples() : 0;
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T> AdoptedAudioBuffer<T>::getView() const
+{
+    return storage != nullptr ? storage->view : AudioBufferView<T>();
+}
+
+//=============================================================
+template <class T>
+AdoptedAudioBuffer<T>::operator AudioBufferView<const T>() const
+{
+    return getView();
+}
+
+//=============================================================
+template <class T>
+AdoptedAudioBuffer<T>::Storage::~Storage()
+{
+    if (deleter)
+        deleter();
+}
@@ -0,0 +1,121 @@
+//=======================================================================
+/** @file AudioBufferView.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include <cassert>
+#include <cstddef>
+
+//=============================================================
+/** A view of audio samples held in memory that belongs to someone else, which lets you pass
+ * your own buffers (or parts of them) to the library without copying them.
+ *
+ * Samples are accessed by channel and then by sample index, i.e. view (channel, sampleIndex).
+ * A view can either point to a separate buffer for each channel, or describe where the
+ * samples are with strides from a single pointer, which covers planar buffers, interleaved
+ * frames (with or without padding at the end of each frame) and so on.
+ *
+ * A view doesn't own anything, so the samples (and for views of separate channels, the array
+ * of channel pointers) must outlive it. Use AudioBufferView<const T> for read-only samples -
+ * any view converts to one.
+ */
+template <class T>
+class AudioBufferView
+{
+public:
+    
+    //=============================================================
+    /** Creates an empty view */
+    AudioBufferView();
+    
+    /** Creates a view of separate buffers for each channel
+     * @param channels an array of numChannels pointers to the first sample of each channel
+     */
+    AudioBufferView (T* const* channels, int numChannels, int numSamples);
+    
+    /** Creates a view of samples laid out with fixed strides, where a sample is at:
+     *
+     *      firstSample[channel * channelStride + sampleIndex * sampleStride]
+     *
+     * e.g. a channelStride of numSamples and sampleStride of 1 for planar audio in one buffer
+     */
+    AudioBufferView (T* firstSample, int numChannels, int numSamples, std::ptrdiff_t channelStride, std::ptrdiff_t sampleStride);
+    
+    /** Converts a view of modifiable samples to a read-only view */
+    template <class OtherType>
+    AudioBufferView (const AudioBufferView<OtherType>& other);
+    
+    //=============================================================
+    /** Creates a view of interleaved frames
+     * @param frameStride the number of samples from the start of one frame to the start of the next
+     */
+    static AudioBufferView interleaved (T* frames, int numChannels, int numSamples, std::ptrdiff_t frameStride);
+    
+    /** Creates a view of interleaved frames of numChannels samples */
+    static AudioBufferView interleaved (T* frames, int numChannels, int numSamples);
+    
+    //=============================================================
+    /** @Returns the number of channels */
+    int getNumChannels() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamples() const;
+    
+    /** @Returns the number of samples from one sample of a channel to the next */
+    std::ptrdiff_t getSampleStride() const;
+    
+    /** @Returns a pointer to a given sample. The channel's next sample is getSampleStride() samples on */
+    T* getPointer (int channel, int sampleIndex = 0) const;
+    
+    /** @Returns a given sample */
+    T& operator() (int channel, int sampleIndex) const;
+    
+    //=============================================================
+    /** @Returns a view of a range of the samples in every channel */
+    AudioBufferView getSampleRange (int startSample, int numSamplesInRange) const;
+    
+    /** @Returns a view of some of the channels */
+    AudioBufferView getChannelRange (int firstChannel, int numChannelsInRange) const;
+    
+private:
+    
+    //=============================================================
+    template <class> friend class AudioBufferView;
+    
+    //=============================================================
+    T* const* channelPointers {nullptr};
+    T* data {nullptr};
+    std::ptrdiff_t channelStride {0};
+    std::ptrdiff_t sampleStride {1};
+    std::ptrdiff_t sampleOffset {0};
+    int numChannels {0};
+    int numSamples {0};
+};
+
+#include "AudioBufferView.inl"
@@ -0,0 +1,156 @@
+//=======================================================================
+/** @file AudioBufferView.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+AudioBufferView<T>::AudioBufferView()
+{
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T>::AudioBufferView (T* const* channels, int numChannelsInView, int numSamplesInView)
+ :  channelPointers (channels),
+    numChannels (numChannelsInView),
+    numSamples (numSamplesInView)
+{
+    assert (numChannels >= 0 && numSamples >= 0);
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T>::AudioBufferView (T* firstSample, int numChannelsInView, int numSamplesInView, std::ptrdiff_t channelStrideInView, std::ptrdiff_t sampleStrideInView)
+ :  data (firstSample),
+    channelStride (channelStrideInView),
+    sampleStride (sampleStrideInView),
+    numChannels (numChannelsInView),
+    numSamples (numSamplesInView)
+{
+    assert (numChannels >= 0 && numSamples >= 0);
+}
+
+//=============================================================
+template <class T>
+template <class OtherType>
+AudioBufferView<T>::AudioBufferView (const AudioBufferView<OtherType>& other)
+ :  channelPointers (other.channelPointers),
+    data (other.data),
+    channelStride (other.channelStride),
+    sampleStride (other.sampleStride),
+    sampleOffset (other.sampleOffset),
+    numChannels (other.numChannels),
+    numSamples (other.numSamples)
+{
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T> AudioBufferView<T>::interleaved (T* frames, int numChannels, int numSamples, std::ptrdiff_t frameStride)
+{
+    assert (frameStride >= numChannels);
+    return AudioBufferView (frames, numChannels, numSamples, 1, frameStride);
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T> AudioBufferView<T>::interleaved (T* frames, int numChannels, int numSamples)
+{
+    return interleaved (frames, numChannels, numSamples, numChannels);
+}
+
+//=============================================================
+template <class T>
+int AudioBufferView<T>::getNumChannels() const
+{
+    return numChannels;
+}
+
+//=============================================================
+template <class T>
+int AudioBufferView<T>::getNumSamples() const
+{
+    return numSamples;
+}
+
+//=============================================================
+template <class T>
+std::ptrdiff_t AudioBufferView<T>::getSampleStride() const
+{
+    return sampleStride;
+}
+
+//=============================================================
+template <class T>
+T* AudioBufferView<T>::getPointer (int channel, int sampleIndex) const
+{
+    assert (channel >= 0 && channel < numChannels);
+    
+    T* channelStart = channelPointers != nullptr ? channelPointers[channel] : data + channel * channelStride;
+    return channelStart + sampleOffset + sampleIndex * sampleStride;
+}
+
+//=============================================================
+template <class T>
+T& AudioBufferView<T>::operator() (int channel, int sampleIndex) const
+{
+    assert (sampleIndex >= 0 && sampleIndex < numSamples);
+    return *getPointer (channel, sampleIndex);
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T> AudioBufferView<T>::getSampleRange (int startSample, int numSamplesInRange) const
+{
+    assert (startSample >= 0 && numSamplesInRange >= 0 && startSample + numSamplesInRange <= numSamples);
+    
+    AudioBufferView range (*this);
+    range.sampleOffset += startSample * sampleStride;
+    range.numSamples = numSamplesInRange;
+    return range;
+}
+
+//=============================================================
+template <class T>
+AudioBufferView<T> AudioBufferView<T>::getChannelRange (int firstChannel, int numChannelsInRange) const
+{
+    assert (firstChannel >= 0 && numChannelsInRange >= 0 && firstChannel + numChannelsInRange <= numChannels);
+    
+    AudioBufferView range (*this);
+    range.numChannels = numChannelsInRange;
+    
+    if (channelPointers != nullptr)
+        range.channelPointers += firstChannel;
+    else
+        range.data += firstChannel * channelStride;
+    
+    return range;
+}
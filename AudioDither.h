@@ -0,0 +1,89 @@
+//=======================================================================
+/** @file AudioDither.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFileTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//=============================================================
+/** Quantises one channel of floating point samples to the integer codes of a lower bit
+ * depth, with dither and (optionally) noise shaping, before they are encoded.
+ *
+ * The dither noise comes from a hash of the channel and the position of each sample in the
+ * file, rather than a sequential random number generator, so it can be computed for many
+ * samples at once, and a file is always saved with the same noise however its samples are
+ * split into blocks. Noise shaping feeds back the error of each sample, so the samples of a
+ * channel must be quantised in order.
+ */
+template <class T>
+class AudioDither
+{
+public:
+    
+    //=============================================================
+    /** Constructor
+     * @param channel the channel this will quantise, which chooses its noise
+     */
+    AudioDither (DitherType ditherType, int bitDepth, int channel);
+    
+    //=============================================================
+    /** @Returns true if samples of type T are dithered when they are saved at the given bit
+     * depth. Only floating point samples saved as 8, 16 or 24-bit integers are dithered.
+     */
+    static bool isUsed (DitherType ditherType, int bitDepth, bool isFloatingPoint);
+    
+    /** Quantises a run of samples to integer codes, e.g. in the range [-32767, 32767] for 16-bit audio
+     * @param firstSampleIndex the position in the file of the first sample
+     */
+    void quantise (const T* source, std::ptrdiff_t sourceStride, int numSamples, int64_t firstSampleIndex, int32_t* codes);
+    
+private:
+    
+    //=============================================================
+    static constexpr int numSamplesPerBlock = 256;
+    
+    //=============================================================
+    static uint32_t hash (uint32_t value);
+    
+    //=============================================================
+    template <typename ComputeType>
+    void quantiseRun (const T* source, std::ptrdiff_t sourceStride, int numSamples, int64_t firstSampleIndex, int32_t* codes);
+    
+    //=============================================================
+    DitherType type;
+    int32_t maxCode;
+    uint32_t channelSeed;
+    double errors[3] {0., 0., 0.};
+};
+
+#include "AudioDither.inl"
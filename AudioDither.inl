@@ -0,0 +1,154 @@
+//=======================================================================
+/** @file AudioDither.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <algorithm>
+
+//=============================================================
+template <class T>
+AudioDither<T>::AudioDither (DitherType ditherType, int bitDepth, int channel)
+ :  type (ditherType),
+    maxCode (static_cast<int32_t> ((1 << (bitDepth - 1)) - 1)),
+    channelSeed (hash (static_cast<uint32_t> (channel) * 0x9E3779B9u + 0x2545F491u))
+{
+}
+
+//=============================================================
+template <class T>
+bool AudioDither<T>::isUsed (DitherType ditherType, int bitDepth, bool isFloatingPoint)
+{
+    return std::is_floating_point<T>::value && ditherType != DitherType::None && ! isFloatingPoint && bitDepth <= 24;
+}
+
+//=============================================================
+template <class T>
+void AudioDither<T>::quantise (const T* source, std::ptrdiff_t sourceStride, int numSamples, int64_t firstSampleIndex, int32_t* codes)
+{
+    // only floating point samples are dithered (see isUsed())
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        // a float has enough precision for 16-bit codes and below, and twice as many fit in a vector
+        if (std::is_same<T, float>::value && maxCode <= SignedInt16_Max)
+            quantiseRun<float> (source, sourceStride, numSamples, firstSampleIndex, codes);
+        else
+            quantiseRun<double> (source, sourceStride, numSamples, firstSampleIndex, codes);
+    }
+}
+
+//=============================================================
+template <class T>
+template <typename ComputeType>
+void AudioDither<T>::quantiseRun (const T* source, std::ptrdiff_t sourceStride, int numSamples, int64_t firstSampleIndex, int32_t* codes)
+{
+    // members are copied, as the compiler can't tell that writing codes doesn't change them
+    const int32_t maximum = maxCode;
+    const uint32_t seed = channelSeed;
+    const ComputeType scale = static_cast<ComputeType> (maximum);
+    const ComputeType noiseScale = static_cast<ComputeType> (1. / 65536.);
+    
+    // values are offset to be positive, so truncating them rounds to the nearest code. Values
+    // are never more than a few steps outside the range of codes
+    const int32_t offset = maximum + 16;
+    const ComputeType roundingOffset = static_cast<ComputeType> (offset) + static_cast<ComputeType> (0.5);
+    
+    ComputeType scaled[numSamplesPerBlock];
+    ComputeType noise[numSamplesPerBlock];
+    
+    // each step below is a separate loop with no branches, so the compiler can vectorise them
+    for (int start = 0; start < numSamples; start += numSamplesPerBlock)
+    {
+        int numSamplesInBlock = std::min (numSamplesPerBlock, numSamples - start);
+        const T* blockSource = source + start * sourceStride;
+        int32_t* blockCodes = codes + start;
+        
+        for (int i = 0; i < numSamplesInBlock; i++)
+        {
+            ComputeType sample = static_cast<ComputeType> (blockSource[i * sourceStride]);
+            sample = sample > 1 ? 1 : sample;
+            sample = sample < -1 ? -1 : sample;
+            scaled[i] = sample * scale;
+        }
+        
+        // the difference of two uniform values has a triangular distribution in (-1, 1)
+        uint32_t blockIndex = static_cast<uint32_t> (firstSampleIndex + start);
+        
+        for (int i = 0; i < numSamplesInBlock; i++)
+        {
+            uint32_t random = hash (seed ^ (blockIndex + static_cast<uint32_t> (i)));
+            noise[i] = static_cast<ComputeType> (static_cast<int32_t> (random >> 16) - static_cast<int32_t> (random & 0xFFFF)) * noiseScale;
+        }
+        
+        if (type == DitherType::NoiseShaped)
+        {
+            // error feedback through a three-tap filter (from Wannamaker's "Psychoacoustically
+            // Optimal Noise Shaping"), which moves noise out of the range where hearing is most
+            // sensitive. This depends on the previous samples, so it can't be vectorised. The
+            // error is taken before clipping, so it can never grow without bound
+            double error0 = errors[0], error1 = errors[1], error2 = errors[2];
+            
+            for (int i = 0; i < numSamplesInBlock; i++)
+            {
+                double wanted = scaled[i] - (1.623 * error0 - 0.982 * error1 + 0.109 * error2);
+                int32_t code = static_cast<int32_t> (wanted + noise[i] + (offset + 0.5)) - offset;
+                
+                error2 = error1;
+                error1 = error0;
+                error0 = code - wanted;
+                
+                blockCodes[i] = std::min (std::max (code, -maximum), maximum);
+            }
+            
+            errors[0] = error0;
+            errors[1] = error1;
+            errors[2] = error2;
+        }
+        else
+        {
+            for (int i = 0; i < numSamplesInBlock; i++)
+            {
+                int32_t code = static_cast<int32_t> (scaled[i] + noise[i] + roundingOffset) - offset;
+                blockCodes[i] = std::min (std::max (code, -maximum), maximum);
+            }
+        }
+    }
+}
+
+//=============================================================
+template <class T>
+uint32_t AudioDither<T>::hash (uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7FEB352Du;
+    value ^= value >> 15;
+    value *= 0x846CA68Bu;
+    value ^= value >> 16;
+    return value;
+}
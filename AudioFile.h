@@ -31,6 +31,14 @@
 #pragma once
 #include "AudioFileTypes.h"
 #include "AudioSampleConverter.h"
+#include "AudioSampleBuffer.h"
+#include "AdoptedAudioBuffer.h"
+#include "AudioBufferView.h"
+#include "AudioDither.h"
+#include "AudioResampler.h"
+#include "AudioHeader.h"
+#include "AudioFileWriterPool.h"
+#include "MemoryMappedFile.h"
 
 #if defined (_MSC_VER)
     #undef max
@@ -43,11 +51,17 @@
 #include <cassert>
 #include <string>
 #include <cstring>
+#include <cstdio>
 #include <fstream>
 #include <unordered_map>
 #include <iterator>
 #include <algorithm>
 #include <limits>
+#include <cmath>
+#include <functional>
+#include <atomic>
+#include <system_error>
+#include <thread>
 
 // disable some warnings on Windows
 #if defined (_MSC_VER)
@@ -86,16 +100,102 @@ public:
      * @Returns true if the file was successfully loaded
      */
     bool load (std::string filePath);
+    
+    /** Loads a range of samples from an audio file, reading only the file's header and the
+     * samples in the range rather than the whole file. If the range extends past the end of
+     * the file, the samples up to the end of the file are loaded.
+     * @param startSample the index (per channel) of the first sample to load
+     * @param numSamples the number of samples per channel to load
+     * @Returns true if the samples were successfully loaded
+     */
+    bool load (std::string filePath, int startSample, int numSamples);
+    
+    /** Loads a section of an audio file, given in seconds, reading only the file's header and
+     * the samples in the section. This rounds the start and length to the nearest sample.
+     * @Returns true if the samples were successfully loaded
+     */
+    bool loadTimeRange (std::string filePath, double startTimeInSeconds, double lengthInSeconds);
+    
+    /** Loads an audio file converted to a given sample rate and number of channels. The file
+     * is read a block at a time, and each block is decoded, mixed and resampled before the
+     * next is read, so only the converted audio is ever held in memory. Only floating point
+     * samples can be converted.
+     *
+     * When there are fewer new channels than channels in the file, new channel k is the
+     * average of the file's channels k, k + numChannels, k + 2 * numChannels and so on (so
+     * mono is the average of every channel). When there are more, the file's channels are
+     * repeated (so a mono file is copied to every channel). If you have used setChannelsToLoad(),
+     * only those channels are decoded and mixed, in the order you gave them.
+     * @Returns true if the file was successfully loaded
+     */
+    bool loadAs (std::string filePath, uint32_t newSampleRate, int numChannels);
+    
+    /** Loads an audio file converted to a given sample rate, with channels that are mixed from
+     * the file's channels by a matrix, reading the file a block at a time (see above)
+     * @param mixMatrix a row for each new channel, holding the gain of every channel in the file
+     * (or of every channel given to setChannelsToLoad()), e.g. { { 0.5, 0.5 } } to mix a stereo
+     * file to mono
+     * @Returns true if the file was successfully loaded
+     */
+    bool loadAs (std::string filePath, uint32_t newSampleRate, const std::vector<std::vector<T>>& mixMatrix);
 
     /** Saves an audio file to a given file path.
      * @Returns true if the file was successfully saved
      */
     bool save (std::string filePath, AudioFileFormat format = AudioFileFormat::Wave);
+    
+    /** Saves the audio in a view of your own buffers to a given file path, rather than the
+     * samples of this AudioFile, using this AudioFile's bit depth, sample rate and iXML chunk.
+     * The samples are read straight from the view, without copying them.
+     * @Returns true if the file was successfully saved
+     */
+    bool save (std::string filePath, const AudioBufferView<const T>& audio, AudioFileFormat format = AudioFileFormat::Wave);
+    
+    /** Saves an audio file to a given file path by creating the file at its final size, mapping
+     * it into memory and encoding the samples straight into it (on several threads, if you
+     * have used setNumEncodingThreads()). This avoids copying the whole file through a buffer,
+     * which makes saving large files to fast disks quicker.
+     *
+     * This uses MemoryMappedFile, so you need to link against the AudioFile library.
+     * @param sync whether to wait for the file to be written to disk before returning
+     * @Returns true if the file was successfully saved
+     */
+    bool saveMapped (std::string filePath, AudioFileFormat format = AudioFileFormat::Wave, MappedFileSync sync = MappedFileSync::Kernel);
+    
+    /** Saves an audio file to a given file path on a background thread, so you can carry on
+     * using (and changing) this AudioFile straight away. The file is saved with the audio and
+     * settings as they are when this is called: the samples are copied before this returns
+     * (which takes far less time than encoding and writing them), so nothing you do to this
+     * AudioFile afterwards can change what is saved.
+     * @param onFinished an optional function to call with the result of the save, which is
+     * called on the writer thread (see AudioFileWriterPool::add())
+     * @param pool the writer threads to save with. By default this is a pool of two threads
+     * shared by the whole program
+     * @Returns a handle that can be used to wait for or cancel the save
+     */
+    SaveHandle saveAsync (std::string filePath, AudioFileFormat format = AudioFileFormat::Wave, std::function<void (SaveStatus)> onFinished = {},
+                          AudioFileWriterPool& pool = AudioFileWriterPool::getDefaultPool());
         
     //=============================================================
     /** Loads an audio file from data in memory */
     bool loadFromMemory (std::vector<uint8_t>& fileData);
     
+    /** @Returns the number of bytes the audio takes up when it is saved in the given format
+     * (as saveToMemory() would encode it), or 0 if it can't be saved in that format
+     */
+    size_t computeEncodedSize (AudioFileFormat format = AudioFileFormat::Wave) const;
+    
+    /** Encodes the audio as a complete file, in the given format, into memory you provide,
+     * which must have room for computeEncodedSize() bytes.
+     * @Returns true if the audio was encoded
+     */
+    bool saveToMemory (uint8_t* destination, size_t capacity, AudioFileFormat format = AudioFileFormat::Wave);
+    
+    /** Encodes the audio as a complete file in the given format.
+     * @Returns the bytes of the file, or an empty vector if the audio couldn't be encoded
+     */
+    std::vector<uint8_t> saveToMemory (AudioFileFormat format = AudioFileFormat::Wave);
+    
     //=============================================================
     /** @Returns the sample rate */
     uint32_t getSampleRate() const;
@@ -118,6 +218,9 @@ public:
     /** @Returns the length in seconds of the audio file based on the number of samples and sample rate */
     double getLengthInSeconds() const;
     
+    /** @Returns true if the samples in the most recently loaded file were stored as floating point values */
+    bool isFloatingPointFormat() const;
+    
     /** Prints a summary of the audio file to the console */
     void printSummary() const;
     
@@ -126,7 +229,18 @@ public:
     /** Set the audio buffer for this AudioFile by copying samples from another buffer.
      * @Returns true if the buffer was copied successfully.
      */
-    bool setAudioBuffer (AudioBuffer& newBuffer);
+    bool setAudioBuffer (const AudioBuffer& newBuffer);
+    
+    /** Set the audio buffer for this AudioFile by taking over the channels of a buffer you no
+     * longer need, without copying any samples.
+     * @Returns true if the buffer was taken over successfully.
+     */
+    bool setAudioBuffer (AudioBuffer&& newBuffer);
+    
+    /** Set the audio buffer for this AudioFile by copying the samples in a view of your own buffers
+     * @Returns true if the buffer was copied successfully.
+     */
+    bool setAudioBuffer (const AudioBufferView<const T>& newBuffer);
     
     /** Sets the audio buffer to a given number of channels and number of samples per channel. This will try to preserve
      * the existing audio, adding zeros to any new channels or new samples in a given channel.
@@ -147,15 +261,47 @@ public:
     /** Sets the sample rate for the audio file. If you use the save() function, this sample rate will be used */
     void setSampleRate (uint32_t newSampleRate);
     
+    /** Converts the audio to a new sample rate (unlike setSampleRate(), which only changes the
+     * rate the samples are played back at), using an AudioResampler. The audio keeps its
+     * length in seconds. Only floating point samples can be resampled.
+     * @Returns true if the audio was resampled, or false if either sample rate is zero
+     */
+    bool resample (uint32_t newSampleRate);
+    
+    /** Sets how floating point samples are dithered when they are saved at 8, 16 or 24 bits.
+     * Dithering replaces the distortion of truncating each sample with a low level of noise,
+     * and noise shaping moves most of that noise to high frequencies. The noise is the same
+     * every time a file is saved. By default this is DitherType::None
+     */
+    void setDither (DitherType newDitherType);
+    
+    /** Sets how many threads encode the samples when a large file is saved. The frames are
+     * split into ranges that are encoded at the same time, straight into the file data, and
+     * the file is exactly the same as it would be if it were encoded on one thread. Pass 0
+     * to use one thread per processor core. By default this is 1
+     */
+    void setNumEncodingThreads (int numThreads);
+    
     //=============================================================
     /** Sets whether the library should log error messages to the console. By default this is true */
     void shouldLogErrorsToConsole (bool logErrors);
     
+    /** Sets which channels of a file are loaded, e.g. { 4, 5 } to load only the fifth and sixth
+     * channels of a multichannel file (as channels 0 and 1 of this AudioFile). Only the chosen
+     * channels are decoded, so loading a few channels of a wide file is much faster and takes
+     * much less memory. Loading fails if a file doesn't have one of the channels. By default
+     * (or if you pass an empty list) every channel is loaded.
+     */
+    void setChannelsToLoad (const std::vector<int>& channels);
+    
     //=============================================================
     /** A vector of vectors holding the audio samples for the AudioFile. You can 
      * access the samples by channel and then by sample index, i.e:
      *
      *      samples[channel][sampleIndex]
+     *
+     * Copying an AudioFile copies its samples. To share samples between copies, move them
+     * into an AudioSampleBuffer (see AudioSampleBuffer.h).
      */
     AudioBuffer samples;
     
@@ -165,15 +311,57 @@ public:
     std::string iXMLChunk;
     
 private:
+    
+    //=============================================================
+    // reads the bit patterns of floating point samples straight into an AudioFile<int32_t>
+    friend bool loadRawSampleValues (std::vector<uint8_t>& fileData, AudioFile<int32_t>& rawAudio, bool logErrorsToConsole);
         
     //=============================================================
     AudioFileFormat determineAudioFileFormat (std::vector<uint8_t>& fileData);
     bool decodeWaveFile (std::vector<uint8_t>& fileData);
     bool decodeAiffFile (std::vector<uint8_t>& fileData);
+    bool decodeSampleRange (const std::string& filePath, const AudioHeader<T>& header, int startSample, int numSamples);
+    bool decodeInterleavedSamples (const uint8_t* frameData, int numChannelsInData, int numSamples, AudioFileFormat format);
+    bool getChannelsToDecode (int numChannelsInData, std::vector<int>& channels);
+    bool decodeMixedAndResampled (const std::string& filePath, const AudioHeader<T>& header, uint32_t newSampleRate, const std::vector<std::vector<T>>& mixMatrix);
+    static std::vector<std::vector<T>> createMixMatrix (int numChannelsInFile, int numChannels);
     
     //=============================================================
-    bool saveToWaveFile (std::string filePath);
-    bool saveToAiffFile (std::string filePath);
+    /** The samples to save: the first sample of each channel, and the number of samples from
+     * one sample of a channel to the next (1 for separate channels, or the number of channels
+     * for interleaved frames)
+     */
+    struct SamplesToSave
+    {
+        std::vector<const T*> channels;
+        std::ptrdiff_t sampleStride = 1;
+        int numSamplesPerChannel = 0;
+        
+        /** @Returns true if the samples are one block of interleaved frames */
+        bool isInterleaved() const;
+    };
+    
+    //=============================================================
+    SamplesToSave getSamplesToSave() const;
+    bool saveSamples (const SamplesToSave& samplesToSave, std::string filePath, AudioFileFormat format);
+    
+    //=============================================================
+    /** Files are encoded as a header, the sample data and a trailer (any chunks after the sample data) */
+    bool encodeFileChunks (const SamplesToSave& samplesToSave, AudioFileFormat format, std::vector<uint8_t>& header, std::vector<uint8_t>& trailer) const;
+    bool encodeWaveFileChunks (const SamplesToSave& samplesToSave, std::vector<uint8_t>& fileData, std::vector<uint8_t>& trailer) const;
+    bool encodeAiffFileChunks (const SamplesToSave& samplesToSave, std::vector<uint8_t>& fileData, std::vector<uint8_t>& trailer) const;
+    bool encodeFileData (const SamplesToSave& samplesToSave, AudioFileFormat format, const std::vector<uint8_t>& header, const std::vector<uint8_t>& trailer, uint8_t* destination);
+    size_t getNumSampleDataBytes (const SamplesToSave& samplesToSave) const;
+    
+    //=============================================================
+    bool encodeInterleavedSamples (const SamplesToSave& samplesToSave, uint8_t* frames, AudioFileFormat format, bool isFloatingPoint);
+    void encodeSampleRange (const SamplesToSave& samplesToSave, uint8_t* frames, AudioFileFormat format, bool isFloatingPoint, int startSample, int endSample);
+    void encodeDitheredSamples (const SamplesToSave& samplesToSave, uint8_t* frames, AudioFileFormat format, int startSample, int endSample, int startChannel, int endChannel);
+    int getNumEncodingThreads (int numChannels, int numSamples) const;
+    bool isSaveCancelled() const;
+    static void runInParallel (int numJobs, const std::function<void (int)>& job);
+    int getNumRepeatedFrames (const SamplesToSave& samplesToSave, int sampleIndex) const;
+    void repeatFrame (uint8_t* frame, size_t numBytesPerFrame, int numRepeats);
     
     //=============================================================
     void clearAudioBuffer();
@@ -187,12 +375,12 @@ private:
     //=============================================================
     uint32_t getAiffSampleRate (std::vector<uint8_t>& fileData, int sampleRateStartIndex);
     bool tenByteMatch (std::vector<uint8_t>& v1, int startIndex1, std::vector<uint8_t>& v2, int startIndex2);
-    void addSampleRateToAiffData (std::vector<uint8_t>& fileData, uint32_t sampleRate);
+    void addSampleRateToAiffData (std::vector<uint8_t>& fileData, uint32_t sampleRate) const;
     
     //=============================================================
-    void addStringToFileData (std::vector<uint8_t>& fileData, std::string s);
-    void addInt32ToFileData (std::vector<uint8_t>& fileData, int32_t i, Endianness endianness = Endianness::LittleEndian);
-    void addInt16ToFileData (std::vector<uint8_t>& fileData, int16_t i, Endianness endianness = Endianness::LittleEndian);
+    void addStringToFileData (std::vector<uint8_t>& fileData, std::string s) const;
+    void addInt32ToFileData (std::vector<uint8_t>& fileData, int32_t i, Endianness endianness = Endianness::LittleEndian) const;
+    void addInt16ToFileData (std::vector<uint8_t>& fileData, int16_t i, Endianness endianness = Endianness::LittleEndian) const;
     
     //=============================================================
     bool writeDataToFile (std::vector<uint8_t>& fileData, std::string filePath);
@@ -200,11 +388,22 @@ private:
     //=============================================================
     void reportError (std::string errorMessage);
     
+    //=============================================================
+    static constexpr int silenceBlockSize = 1024;
+    static constexpr int numSamplesPerDecodingBlock = 16384;
+    static constexpr int minimumSamplesPerEncodingThread = 1 << 16;
+    
     //=============================================================
     AudioFileFormat audioFileFormat;
     uint32_t sampleRate;
     int bitDepth;
+    bool floatingPointFormat {false};
     bool logErrorsToConsole {true};
+    DitherType ditherType {DitherType::None};
+    int numEncodingThreads {1};
+    const std::atomic<bool>* saveCancelled {nullptr};
+    std::vector<int> channelsToLoad;
+    
 };
 
 
@@ -119,6 +119,13 @@ double AudioFile<T>::getLengthInSeconds() const
     return (double)getNumSamplesPerChannel() / (double)sampleRate;
 }
 
+//=============================================================
+template <class T>
+bool AudioFile<T>::isFloatingPointFormat() const
+{
+    return floatingPointFormat;
+}
+
 //=============================================================
 template <class T>
 void AudioFile<T>::printSummary() const
@@ -134,7 +141,7 @@ void AudioFile<T>::printSummary() const
 
 //=============================================================
 template <class T>
-bool AudioFile<T>::setAudioBuffer (AudioBuffer& newBuffer)
+bool AudioFile<T>::setAudioBuffer (const AudioBuffer& newBuffer)
 {
     int numChannels = (int)newBuffer.size();
     
@@ -153,14 +160,67 @@ bool AudioFile<T>::setAudioBuffer (AudioBuffer& newBuffer)
     {
         assert (newBuffer[k].size() == numSamples);
         
+        samples[k] = newBuffer[k];
         samples[k].resize (numSamples);
+    }
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::setAudioBuffer (AudioBuffer&& newBuffer)
+{
+    if (newBuffer.size() == 0)
+    {
+        assert (false && "The buffer you are trying to use has no channels");
+        return false;
+    }
+    
+    size_t numSamples = newBuffer[0].size();
+    
+    for (size_t k = 0; k < newBuffer.size(); k++)
+    {
+        assert (newBuffer[k].size() == numSamples);
+        newBuffer[k].resize (numSamples);
+    }
+    
+    samples = std::move (newBuffer);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::setAudioBuffer (const AudioBufferView<const T>& newBuffer)
+{
+    if (newBuffer.getNumChannels() <= 0)
+    {
+        assert (false && "The buffer you are trying to use has no channels");
+        return false;
+    }
+    
+    std::vector<std::vector<T>> newSamples (newBuffer.getNumChannels());
+    
+    for (int channel = 0; channel < newBuffer.getNumChannels(); channel++)
+    {
+        const T* source = newBuffer.getPointer (channel);
         
-        for (size_t i = 0; i < numSamples; i++)
+        if (newBuffer.getSampleStride() == 1)
+        {
+            newSamples[channel].assign (source, source + newBuffer.getNumSamples());
+        }
+        else
         {
-            samples[k][i] = newBuffer[k][i];
+            newSamples[channel].resize (newBuffer.getNumSamples());
+            
+            for (int i = 0; i < newBuffer.getNumSamples(); i++)
+                newSamples[channel][i] = source[i * newBuffer.getSampleStride()];
         }
     }
     
+    samples = std::move (newSamples);
+    
     return true;
 }
 
@@ -176,15 +236,10 @@ void AudioFile<T>::setAudioBufferSize (int numChannels, int numSamples)
 template <class T>
 void AudioFile<T>::setNumSamplesPerChannel (int numSamples)
 {
-    int originalSize = getNumSamplesPerChannel();
-    
     for (int i = 0; i < getNumChannels();i++)
     {
-        samples[i].resize (numSamples);
-        
         // set any new samples to zero
-        if (numSamples > originalSize)
-            std::fill (samples[i].begin() + originalSize, samples[i].end(), (T)0.);
+        samples[i].resize (numSamples, T());
     }
 }
 
@@ -203,8 +258,7 @@ void AudioFile<T>::setNumChannels (int numChannels)
     {
         for (int i = originalNumChannels; i < numChannels; i++)
         {
-            samples[i].resize (originalNumSamplesPerChannel);
-            std::fill (samples[i].begin(), samples[i].end(), (T)0.);
+            samples[i].resize (originalNumSamplesPerChannel, T());
         }
     }
 }
@@ -223,6 +277,77 @@ void AudioFile<T>::setSampleRate (uint32_t newSampleRate)
     sampleRate = newSampleRate;
 }
 
+//=============================================================
+template <class T>
+bool AudioFile<T>::resample (uint32_t newSampleRate)
+{
+    if (sampleRate == 0 || newSampleRate == 0)
+    {
+        reportError ("ERROR: Can't resample audio to or from a sample rate of zero");
+        return false;
+    }
+    
+    if (newSampleRate == sampleRate || getNumChannels() == 0)
+    {
+        sampleRate = newSampleRate;
+        return true;
+    }
+    
+    int numChannels = getNumChannels();
+    int numSamples = getNumSamplesPerChannel();
+    
+    AudioResampler<T> resampler (sampleRate, newSampleRate, numChannels);
+    std::vector<std::vector<T>> newSamples (numChannels, std::vector<T> (static_cast<size_t> (resampler.getNumOutputSamples (numSamples))));
+    
+    std::vector<const T*> inputChannels (numChannels);
+    std::vector<T*> outputChannels (numChannels);
+    int numOutputSamples = static_cast<int> (newSamples[0].size());
+    int numWritten = 0;
+    
+    auto getOutputView = [&]()
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            outputChannels[channel] = newSamples[channel].data() + numWritten;
+        
+        return AudioBufferView<T> (outputChannels.data(), numChannels, numOutputSamples - numWritten);
+    };
+    
+    // the input is passed in blocks, so the resampler only ever holds a block of it
+    const int numSamplesPerBlock = 65536;
+    
+    for (int start = 0; start < numSamples; start += numSamplesPerBlock)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            inputChannels[channel] = samples[channel].data() + start;
+        
+        AudioBufferView<const T> input (inputChannels.data(), numChannels, std::min (numSamplesPerBlock, numSamples - start));
+        numWritten += resampler.process (input, getOutputView());
+    }
+    
+    numWritten += resampler.flush (getOutputView());
+    
+    assert (numWritten == numOutputSamples);
+    
+    samples = std::move (newSamples);
+    sampleRate = newSampleRate;
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+void AudioFile<T>::setDither (DitherType newDitherType)
+{
+    ditherType = newDitherType;
+}
+
+//=============================================================
+template <class T>
+void AudioFile<T>::setNumEncodingThreads (int numThreads)
+{
+    numEncodingThreads = std::max (numThreads, 0);
+}
+
 //=============================================================
 template <class T>
 void AudioFile<T>::shouldLogErrorsToConsole (bool logErrors)
@@ -230,10 +355,30 @@ void AudioFile<T>::shouldLogErrorsToConsole (bool logErrors)
     logErrorsToConsole = logErrors;
 }
 
+//=============================================================
+template <class T>
+void AudioFile<T>::setChannelsToLoad (const std::vector<int>& channels)
+{
+    channelsToLoad = channels;
+}
+
 //=============================================================
 template <class T>
 bool AudioFile<T>::load (std::string filePath)
 {
+    // when only some of the channels are wanted, the sample data is read a block at a time
+    // so that the other channels never have to be held in memory
+    if (! channelsToLoad.empty())
+    {
+        AudioHeader<T> header;
+        header.shouldLogErrorsToConsole (logErrorsToConsole);
+        
+        if (! header.loadHeader (filePath))
+            return false;
+        
+        return decodeSampleRange (filePath, header, 0, header.getNumSamplesPerChannel());
+    }
+    
     std::ifstream file (filePath, std::ios::binary);
     
     // check the file exists
@@ -276,6 +421,73 @@ bool AudioFile<T>::load (std::string filePath)
     }
 }
 
+//=============================================================
+template <class T>
+bool AudioFile<T>::load (std::string filePath, int startSample, int numSamples)
+{
+    AudioHeader<T> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeader (filePath))
+        return false;
+    
+    return decodeSampleRange (filePath, header, startSample, numSamples);
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::loadTimeRange (std::string filePath, double startTimeInSeconds, double lengthInSeconds)
+{
+    AudioHeader<T> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeader (filePath))
+        return false;
+    
+    double startSample = std::round (startTimeInSeconds * header.getSampleRate());
+    double numSamples = std::round (lengthInSeconds * header.getSampleRate());
+    double maximumNumSamples = static_cast<double> (std::numeric_limits<int>::max());
+    
+    return decodeSampleRange (filePath, header, static_cast<int> (std::min (startSample, maximumNumSamples)), static_cast<int> (std::min (numSamples, maximumNumSamples)));
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::loadAs (std::string filePath, uint32_t newSampleRate, int numChannels)
+{
+    AudioHeader<T> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeader (filePath))
+        return false;
+    
+    if (numChannels < 1)
+    {
+        reportError ("ERROR: audio must be loaded with at least one channel");
+        return false;
+    }
+    
+    std::vector<int> channelsToMix;
+    
+    if (! getChannelsToDecode (header.getNumChannels(), channelsToMix))
+        return false;
+    
+    return decodeMixedAndResampled (filePath, header, newSampleRate, createMixMatrix (static_cast<int> (channelsToMix.size()), numChannels));
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::loadAs (std::string filePath, uint32_t newSampleRate, const std::vector<std::vector<T>>& mixMatrix)
+{
+    AudioHeader<T> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeader (filePath))
+        return false;
+    
+    return decodeMixedAndResampled (filePath, header, newSampleRate, mixMatrix);
+}
+
 //=============================================================
 template <class T>
 bool AudioFile<T>::loadFromMemory (std::vector<uint8_t>& fileData)
@@ -384,67 +596,18 @@ bool AudioFile<T>::decodeWaveFile (std::vector<uint8_t>& fileData)
     int numSamples = dataChunkSize / (numChannels * bitDepth / 8);
     int samplesStartIndex = indexOfDataChunk + 8;
     
+    floatingPointFormat = bitDepth == 32 && audioFormat == WavAudioFormat::IEEEFloat;
+    
     clearAudioBuffer();
-    samples.resize (numChannels);
     
-    for (int i = 0; i < numSamples; i++)
+    if (samplesStartIndex + static_cast<size_t> (numSamples) * numBytesPerBlock > fileData.size())
     {
-        for (int channel = 0; channel < numChannels; channel++)
-        {
-            int sampleIndex = samplesStartIndex + (numBytesPerBlock * i) + channel * numBytesPerSample;
-            
-            if ((sampleIndex + (bitDepth / 8) - 1) >= fileData.size())
-            {
-                reportError ("ERROR: read file error as the metadata indicates more samples than there are in the file data");
-                return false;
-            }
-            
-            if (bitDepth == 8)
-            {
-                T sample = AudioSampleConverter<T>::unsignedByteToSample (fileData[sampleIndex]);
-                samples[channel].push_back (sample);
-            }
-            else if (bitDepth == 16)
-            {
-                int16_t sampleAsInt = twoBytesToInt (fileData, sampleIndex);
-                T sample = AudioSampleConverter<T>::sixteenBitIntToSample (sampleAsInt);
-                samples[channel].push_back (sample);
-            }
-            else if (bitDepth == 24)
-            {
-                int32_t sampleAsInt = 0;
-                sampleAsInt = (fileData[sampleIndex + 2] << 16) | (fileData[sampleIndex + 1] << 8) | fileData[sampleIndex];
-                
-                if (sampleAsInt & 0x800000) //  if the 24th bit is set, this is a negative number in 24-bit world
-                    sampleAsInt = sampleAsInt | ~0xFFFFFF; // so make sure sign is extended to the 32 bit float
-
-                T sample = AudioSampleConverter<T>::twentyFourBitIntToSample (sampleAsInt);
-                samples[channel].push_back (sample);
-            }
-            else if (bitDepth == 32)
-            {
-                int32_t sampleAsInt = fourBytesToInt (fileData, sampleIndex);
-                T sample;
-                
-                if (audioFormat == WavAudioFormat::IEEEFloat && std::is_floating_point<T>::value) 
-                {
-                    float f;
-                    memcpy (&f, &sampleAsInt, sizeof(int32_t));
-                    sample = (T)f;
-                }
-                else // assume PCM
-                {
-                    sample = AudioSampleConverter<T>::thirtyTwoBitIntToSample (sampleAsInt);
-                }
-                
-                samples[channel].push_back (sample);
-            }
-            else
-            {
-                assert (false);
-            }
-        }
+        reportError ("ERROR: read file error as the metadata indicates more samples than there are in the file data");
+        return false;
     }
+    
+    if (! decodeInterleavedSamples (fileData.data() + samplesStartIndex, numChannels, numSamples, AudioFileFormat::Wave))
+        return false;
 
     // -----------------------------------------------------------
     // iXML CHUNK
@@ -459,147 +622,314 @@ bool AudioFile<T>::decodeWaveFile (std::vector<uint8_t>& fileData)
 
 //=============================================================
 template <class T>
-bool AudioFile<T>::decodeAiffFile (std::vector<uint8_t>& fileData)
+bool AudioFile<T>::decodeSampleRange (const std::string& filePath, const AudioHeader<T>& header, int startSample, int numSamples)
 {
-    // -----------------------------------------------------------
-    // HEADER CHUNK
-    std::string headerChunkID (fileData.begin(), fileData.begin() + 4);
-    //int32_t fileSizeInBytes = fourBytesToInt (fileData, 4, Endianness::BigEndian) + 8;
-    std::string format (fileData.begin() + 8, fileData.begin() + 12);
+    if (startSample < 0 || numSamples < 0 || startSample > header.getNumSamplesPerChannel())
+    {
+        reportError ("ERROR: the range of samples to load isn't in the file");
+        return false;
+    }
     
-    int audioFormat = format == "AIFF" ? AIFFAudioFormat::Uncompressed : format == "AIFC" ? AIFFAudioFormat::Compressed : AIFFAudioFormat::Error;
+    numSamples = std::min (numSamples, header.getNumSamplesPerChannel() - startSample);
     
-    // -----------------------------------------------------------
-    // try and find the start points of key chunks
-    int indexOfCommChunk = getIndexOfChunk (fileData, "COMM", 12, Endianness::BigEndian);
-    int indexOfSoundDataChunk = getIndexOfChunk (fileData, "SSND", 12, Endianness::BigEndian);
-    int indexOfXMLChunk = getIndexOfChunk (fileData, "iXML", 12, Endianness::BigEndian);
+    int numChannels = header.getNumChannels();
+    std::vector<int> channels;
     
-    // if we can't find the data or format chunks, or the IDs/formats don't seem to be as expected
-    // then it is unlikely we'll able to read this file, so abort
-    if (indexOfSoundDataChunk == -1 || indexOfCommChunk == -1 || headerChunkID != "FORM" || audioFormat == AIFFAudioFormat::Error)
-    {
-        reportError ("ERROR: this doesn't seem to be a valid AIFF file");
+    if (! getChannelsToDecode (numChannels, channels))
         return false;
+    
+    int numBytesPerSample = header.getBitDepth() / 8;
+    size_t numBytesPerFrame = static_cast<size_t> (numChannels * numBytesPerSample);
+    
+    // read only the bytes of the frames in the range, a block at a time
+    std::ifstream file (filePath, std::ios::binary);
+    file.seekg (static_cast<std::streamoff> (header.getSampleDataOffset() + numBytesPerFrame * startSample));
+    
+    std::vector<uint8_t> frameData (numBytesPerFrame * std::min (numSamples, numSamplesPerDecodingBlock));
+    std::vector<std::vector<T>> decodedSamples (channels.size(), std::vector<T> (numSamples));
+    std::vector<T*> destinations (channels.size());
+    
+    for (int start = 0; start < numSamples; start += numSamplesPerDecodingBlock)
+    {
+        int numInBlock = std::min (numSamplesPerDecodingBlock, numSamples - start);
+        file.read (reinterpret_cast<char*> (frameData.data()), static_cast<std::streamsize> (numBytesPerFrame * numInBlock));
+        
+        if (! file.good() || static_cast<size_t> (file.gcount()) != numBytesPerFrame * numInBlock)
+        {
+            reportError ("ERROR: Couldn't read the samples from the file\n" + filePath);
+            return false;
+        }
+        
+        for (size_t i = 0; i < channels.size(); i++)
+            destinations[i] = decodedSamples[i].data() + start;
+        
+        AudioSampleConverter<T>::decodeFrames (frameData.data(), numChannels, numInBlock, header.getBitDepth(), header.getAudioFormat(), header.isFloatingPointFormat(),
+                                               channels.data(), static_cast<int> (channels.size()), destinations.data());
     }
+    
+    audioFileFormat = header.getAudioFormat();
+    sampleRate = header.getSampleRate();
+    bitDepth = header.getBitDepth();
+    floatingPointFormat = header.isFloatingPointFormat();
+    iXMLChunk = header.getIXMLChunk();
+    
+    samples = std::move (decodedSamples);
+    
+    return true;
+}
 
-    // -----------------------------------------------------------
-    // COMM CHUNK
-    int p = indexOfCommChunk;
-    std::string commChunkID (fileData.begin() + p, fileData.begin() + p + 4);
-    //int32_t commChunkSize = fourBytesToInt (fileData, p + 4, Endianness::BigEndian);
-    int16_t numChannels = twoBytesToInt (fileData, p + 8, Endianness::BigEndian);
-    int32_t numSamplesPerChannel = fourBytesToInt (fileData, p + 10, Endianness::BigEndian);
-    bitDepth = (int) twoBytesToInt (fileData, p + 14, Endianness::BigEndian);
-    sampleRate = getAiffSampleRate (fileData, p + 16);
+//=============================================================
+template <class T>
+bool AudioFile<T>::decodeMixedAndResampled (const std::string& filePath, const AudioHeader<T>& header, uint32_t newSampleRate, const std::vector<std::vector<T>>& mixMatrix)
+{
+    int numChannelsInFile = header.getNumChannels();
+    int numChannels = static_cast<int> (mixMatrix.size());
+    int numSamples = header.getNumSamplesPerChannel();
+    std::vector<int> channelsToMix;
     
-    if (bitDepth > sizeof (T) * 8)
-    {
-        std::string message = "ERROR: you are trying to read a ";
-        message += std::to_string (bitDepth);
-        message += "-bit file using a ";
-        message += std::to_string (sizeof (T) * 8);
-        message += "-bit sample type";
-        reportError (message);
+    if (! getChannelsToDecode (numChannelsInFile, channelsToMix))
         return false;
-    }
     
-    // check the sample rate was properly decoded
-    if (sampleRate == 0)
+    int numChannelsToMix = static_cast<int> (channelsToMix.size());
+    
+    if (newSampleRate == 0)
     {
-        reportError ("ERROR: this AIFF file has an unsupported sample rate");
+        reportError ("ERROR: Can't resample audio to a sample rate of zero");
         return false;
     }
     
-    // check the number of channels is mono or stereo
-    if (numChannels < 1 ||numChannels > 2)
+    if (numChannels == 0)
     {
-        reportError ("ERROR: this AIFF file seems to be neither mono nor stereo (perhaps multi-track, or corrupted?)");
+        reportError ("ERROR: the mix matrix has no channels");
         return false;
     }
     
-    // check bit depth is either 8, 16, 24 or 32-bit
-    if (bitDepth != 8 && bitDepth != 16 && bitDepth != 24 && bitDepth != 32)
+    for (auto& gains : mixMatrix)
     {
-        reportError ("ERROR: this file has a bit depth that is not 8, 16, 24 or 32 bits");
-        return false;
+        if (static_cast<int> (gains.size()) != numChannelsToMix)
+        {
+            reportError ("ERROR: the mix matrix needs a gain for each of the " + std::to_string (numChannelsToMix) + " channels being loaded");
+            return false;
+        }
     }
     
-    // -----------------------------------------------------------
-    // SSND CHUNK
-    int s = indexOfSoundDataChunk;
-    std::string soundDataChunkID (fileData.begin() + s, fileData.begin() + s + 4);
-    int32_t soundDataChunkSize = fourBytesToInt (fileData, s + 4, Endianness::BigEndian);
-    int32_t offset = fourBytesToInt (fileData, s + 8, Endianness::BigEndian);
-    //int32_t blockSize = fourBytesToInt (fileData, s + 12, Endianness::BigEndian);
+    std::ifstream file (filePath, std::ios::binary);
+    file.seekg (static_cast<std::streamoff> (header.getSampleDataOffset()));
     
-    int numBytesPerSample = bitDepth / 8;
-    int numBytesPerFrame = numBytesPerSample * numChannels;
-    int totalNumAudioSampleBytes = numSamplesPerChannel * numBytesPerFrame;
-    int samplesStartIndex = s + 16 + (int)offset;
-        
-    // sanity check the data
-    if ((soundDataChunkSize - 8) != totalNumAudioSampleBytes || totalNumAudioSampleBytes > static_cast<long>(fileData.size() - samplesStartIndex))
-    {
-        reportError ("ERROR: the metadatafor this file doesn't seem right");
-        return false;
-    }
+    // only a block of the file is held at a time: its frames, the decoded channels to mix, and those mixed to the new channels
+    size_t numBytesPerFrame = static_cast<size_t> (numChannelsInFile * (header.getBitDepth() / 8));
+    std::vector<uint8_t> frameData (numBytesPerFrame * numSamplesPerDecodingBlock);
     
-    clearAudioBuffer();
-    samples.resize (numChannels);
+    std::vector<std::vector<T>> decodedBlock (numChannelsToMix, std::vector<T> (numSamplesPerDecodingBlock));
+    std::vector<std::vector<T>> mixedBlock (numChannels, std::vector<T> (numSamplesPerDecodingBlock));
+    std::vector<T*> decodedChannels;
+    std::vector<const T*> mixedChannels;
+    
+    for (auto& channelSamples : decodedBlock)
+        decodedChannels.push_back (channelSamples.data());
+    
+    for (auto& channelSamples : mixedBlock)
+        mixedChannels.push_back (channelSamples.data());
+    
+    bool needsResampling = newSampleRate != header.getSampleRate();
+    AudioResampler<T> resampler (header.getSampleRate(), newSampleRate, numChannels);
+    
+    int numOutputSamples = needsResampling ? static_cast<int> (resampler.getNumOutputSamples (numSamples)) : numSamples;
+    std::vector<std::vector<T>> newSamples (numChannels, std::vector<T> (numOutputSamples));
+    std::vector<T*> outputChannels (numChannels);
+    int numWritten = 0;
     
-    for (int i = 0; i < numSamplesPerChannel; i++)
+    auto getOutputView = [&]()
     {
         for (int channel = 0; channel < numChannels; channel++)
+            outputChannels[channel] = newSamples[channel].data() + numWritten;
+        
+        return AudioBufferView<T> (outputChannels.data(), numChannels, numOutputSamples - numWritten);
+    };
+    
+    for (int start = 0; start < numSamples; start += numSamplesPerDecodingBlock)
+    {
+        int numInBlock = std::min (numSamplesPerDecodingBlock, numSamples - start);
+        file.read (reinterpret_cast<char*> (frameData.data()), static_cast<std::streamsize> (numBytesPerFrame * numInBlock));
+        
+        if (! file.good() || static_cast<size_t> (file.gcount()) != numBytesPerFrame * numInBlock)
         {
-            int sampleIndex = samplesStartIndex + (numBytesPerFrame * i) + channel * numBytesPerSample;
-            
-            if ((sampleIndex + (bitDepth / 8) - 1) >= fileData.size())
-            {
-                reportError ("ERROR: read file error as the metadata indicates more samples than there are in the file data");
-                return false;
-            }
+            reportError ("ERROR: Couldn't read the samples from the file\n" + filePath);
+            return false;
+        }
+        
+        AudioSampleConverter<T>::decodeFrames (frameData.data(), numChannelsInFile, numInBlock, header.getBitDepth(), header.getAudioFormat(), header.isFloatingPointFormat(),
+                                               channelsToMix.data(), numChannelsToMix, decodedChannels.data());
+        
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            T* mixed = mixedBlock[channel].data();
+            std::fill (mixed, mixed + numInBlock, T());
             
-            if (bitDepth == 8)
-            {
-                T sample = AudioSampleConverter<T>::signedByteToSample (static_cast<int8_t> (fileData[sampleIndex]));
-                samples[channel].push_back (sample);
-            }
-            else if (bitDepth == 16)
+            for (int channelToMix = 0; channelToMix < numChannelsToMix; channelToMix++)
             {
-                int16_t sampleAsInt = twoBytesToInt (fileData, sampleIndex, Endianness::BigEndian);
-                T sample = AudioSampleConverter<T>::sixteenBitIntToSample (sampleAsInt);
-                samples[channel].push_back (sample);
-            }
-            else if (bitDepth == 24)
-            {
-                int32_t sampleAsInt = 0;
-                sampleAsInt = (fileData[sampleIndex] << 16) | (fileData[sampleIndex + 1] << 8) | fileData[sampleIndex + 2];
+                T gain = mixMatrix[channel][channelToMix];
                 
-                if (sampleAsInt & 0x800000) //  if the 24th bit is set, this is a negative number in 24-bit world
-                    sampleAsInt = sampleAsInt | ~0xFFFFFF; // so make sure sign is extended to the 32 bit float
-
-                T sample = AudioSampleConverter<T>::twentyFourBitIntToSample (sampleAsInt);
-                samples[channel].push_back (sample);
-            }
-            else if (bitDepth == 32)
-            {
-                int32_t sampleAsInt = fourBytesToInt (fileData, sampleIndex, Endianness::BigEndian);
-                T sample;
+                if (gain == T())
+                    continue;
                 
-                if (audioFormat == AIFFAudioFormat::Compressed)
-                    sample = (T)reinterpret_cast<float&> (sampleAsInt);
-                else // assume PCM
-                    sample = AudioSampleConverter<T>::thirtyTwoBitIntToSample (sampleAsInt);
+                const T* decoded = decodedChannels[channelToMix];
                 
-                samples[channel].push_back (sample);
-            }
-            else
-            {
-                assert (false);
+                for (int i = 0; i < numInBlock; i++)
+                    mixed[i] += gain * decoded[i];
             }
         }
+        
+        if (needsResampling)
+        {
+            numWritten += resampler.process (AudioBufferView<const T> (mixedChannels.data(), numChannels, numInBlock), getOutputView());
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+                std::copy (mixedChannels[channel], mixedChannels[channel] + numInBlock, newSamples[channel].begin() + numWritten);
+            
+            numWritten += numInBlock;
+        }
+    }
+    
+    if (needsResampling)
+        numWritten += resampler.flush (getOutputView());
+    
+    assert (numWritten == numOutputSamples);
+    
+    audioFileFormat = header.getAudioFormat();
+    sampleRate = newSampleRate;
+    bitDepth = header.getBitDepth();
+    floatingPointFormat = header.isFloatingPointFormat();
+    iXMLChunk = header.getIXMLChunk();
+    
+    samples = std::move (newSamples);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+std::vector<std::vector<T>> AudioFile<T>::createMixMatrix (int numChannelsInFile, int numChannels)
+{
+    std::vector<std::vector<T>> mixMatrix (numChannels, std::vector<T> (numChannelsInFile, T()));
+    
+    if (numChannels >= numChannelsInFile)
+    {
+        // repeat the file's channels
+        for (int channel = 0; channel < numChannels; channel++)
+            mixMatrix[channel][channel % numChannelsInFile] = T (1);
+    }
+    else
+    {
+        // average the file's channels that fold onto each new channel
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            int numFolded = (numChannelsInFile - channel + numChannels - 1) / numChannels;
+            
+            for (int channelInFile = channel; channelInFile < numChannelsInFile; channelInFile += numChannels)
+                mixMatrix[channel][channelInFile] = T (1) / static_cast<T> (numFolded);
+        }
+    }
+    
+    return mixMatrix;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::decodeAiffFile (std::vector<uint8_t>& fileData)
+{
+    // -----------------------------------------------------------
+    // HEADER CHUNK
+    std::string headerChunkID (fileData.begin(), fileData.begin() + 4);
+    //int32_t fileSizeInBytes = fourBytesToInt (fileData, 4, Endianness::BigEndian) + 8;
+    std::string format (fileData.begin() + 8, fileData.begin() + 12);
+    
+    int audioFormat = format == "AIFF" ? AIFFAudioFormat::Uncompressed : format == "AIFC" ? AIFFAudioFormat::Compressed : AIFFAudioFormat::Error;
+    
+    // -----------------------------------------------------------
+    // try and find the start points of key chunks
+    int indexOfCommChunk = getIndexOfChunk (fileData, "COMM", 12, Endianness::BigEndian);
+    int indexOfSoundDataChunk = getIndexOfChunk (fileData, "SSND", 12, Endianness::BigEndian);
+    int indexOfXMLChunk = getIndexOfChunk (fileData, "iXML", 12, Endianness::BigEndian);
+    
+    // if we can't find the data or format chunks, or the IDs/formats don't seem to be as expected
+    // then it is unlikely we'll able to read this file, so abort
+    if (indexOfSoundDataChunk == -1 || indexOfCommChunk == -1 || headerChunkID != "FORM" || audioFormat == AIFFAudioFormat::Error)
+    {
+        reportError ("ERROR: this doesn't seem to be a valid AIFF file");
+        return false;
+    }
+
+    // -----------------------------------------------------------
+    // COMM CHUNK
+    int p = indexOfCommChunk;
+    std::string commChunkID (fileData.begin() + p, fileData.begin() + p + 4);
+    //int32_t commChunkSize = fourBytesToInt (fileData, p + 4, Endianness::BigEndian);
+    int16_t numChannels = twoBytesToInt (fileData, p + 8, Endianness::BigEndian);
+    int32_t numSamplesPerChannel = fourBytesToInt (fileData, p + 10, Endianness::BigEndian);
+    bitDepth = (int) twoBytesToInt (fileData, p + 14, Endianness::BigEndian);
+    sampleRate = getAiffSampleRate (fileData, p + 16);
+    
+    if (bitDepth > sizeof (T) * 8)
+    {
+        std::string message = "ERROR: you are trying to read a ";
+        message += std::to_string (bitDepth);
+        message += "-bit file using a ";
+        message += std::to_string (sizeof (T) * 8);
+        message += "-bit sample type";
+        reportError (message);
+        return false;
+    }
+    
+    // check the sample rate was properly decoded
+    if (sampleRate == 0)
+    {
+        reportError ("ERROR: this AIFF file has an unsupported sample rate");
+        return false;
+    }
+    
+    // check the number of channels is mono or stereo
+    if (numChannels < 1 ||numChannels > 2)
+    {
+        reportError ("ERROR: this AIFF file seems to be neither mono nor stereo (perhaps multi-track, or corrupted?)");
+        return false;
     }
+    
+    // check bit depth is either 8, 16, 24 or 32-bit
+    if (bitDepth != 8 && bitDepth != 16 && bitDepth != 24 && bitDepth != 32)
+    {
+        reportError ("ERROR: this file has a bit depth that is not 8, 16, 24 or 32 bits");
+        return false;
+    }
+    
+    // -----------------------------------------------------------
+    // SSND CHUNK
+    int s = indexOfSoundDataChunk;
+    std::string soundDataChunkID (fileData.begin() + s, fileData.begin() + s + 4);
+    int32_t soundDataChunkSize = fourBytesToInt (fileData, s + 4, Endianness::BigEndian);
+    int32_t offset = fourBytesToInt (fileData, s + 8, Endianness::BigEndian);
+    //int32_t blockSize = fourBytesToInt (fileData, s + 12, Endianness::BigEndian);
+    
+    int numBytesPerSample = bitDepth / 8;
+    int numBytesPerFrame = numBytesPerSample * numChannels;
+    int totalNumAudioSampleBytes = numSamplesPerChannel * numBytesPerFrame;
+    int samplesStartIndex = s + 16 + (int)offset;
+        
+    // sanity check the data
+    if ((soundDataChunkSize - 8) != totalNumAudioSampleBytes || totalNumAudioSampleBytes > static_cast<long>(fileData.size() - samplesStartIndex))
+    {
+        reportError ("ERROR: the metadatafor this file doesn't seem right");
+        return false;
+    }
+    
+    floatingPointFormat = bitDepth == 32 && audioFormat == AIFFAudioFormat::Compressed;
+    
+    clearAudioBuffer();
+    
+    if (! decodeInterleavedSamples (fileData.data() + samplesStartIndex, numChannels, numSamplesPerChannel, AudioFileFormat::Aiff))
+        return false;
 
     // -----------------------------------------------------------
     // iXML CHUNK
@@ -612,6 +942,56 @@ bool AudioFile<T>::decodeAiffFile (std::vector<uint8_t>& fileData)
     return true;
 }
 
+//=============================================================
+template <class T>
+bool AudioFile<T>::decodeInterleavedSamples (const uint8_t* frameData, int numChannelsInData, int numSamples, AudioFileFormat format)
+{
+    std::vector<int> channels;
+    
+    if (! getChannelsToDecode (numChannelsInData, channels))
+        return false;
+    
+    // decode into plain vectors, which are then moved into the buffer without copying
+    std::vector<std::vector<T>> decodedSamples (channels.size());
+    std::vector<T*> destinations;
+    
+    for (auto& channelSamples : decodedSamples)
+    {
+        channelSamples.resize (numSamples);
+        destinations.push_back (channelSamples.data());
+    }
+    
+    AudioSampleConverter<T>::decodeFrames (frameData, numChannelsInData, numSamples, bitDepth, format, floatingPointFormat, channels.data(), static_cast<int> (channels.size()), destinations.data());
+    
+    samples = std::move (decodedSamples);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::getChannelsToDecode (int numChannelsInData, std::vector<int>& channels)
+{
+    for (int channel : channelsToLoad)
+    {
+        if (channel < 0 || channel >= numChannelsInData)
+        {
+            reportError ("ERROR: this file doesn't have a channel " + std::to_string (channel) + " to load");
+            return false;
+        }
+    }
+    
+    channels = channelsToLoad;
+    
+    if (channels.empty())
+    {
+        for (int channel = 0; channel < numChannelsInData; channel++)
+            channels.push_back (channel);
+    }
+    
+    return true;
+}
+
 //=============================================================
 template <class T>
 uint32_t AudioFile<T>::getAiffSampleRate (std::vector<uint8_t>& fileData, int sampleRateStartIndex)
@@ -640,7 +1020,7 @@ bool AudioFile<T>::tenByteMatch (std::vector<uint8_t>& v1, int startIndex1, std:
 
 //=============================================================
 template <class T>
-void AudioFile<T>::addSampleRateToAiffData (std::vector<uint8_t>& fileData, uint32_t sampleRate)
+void AudioFile<T>::addSampleRateToAiffData (std::vector<uint8_t>& fileData, uint32_t sampleRate) const
 {
     if (aiffSampleRateTable.count (sampleRate) > 0)
     {
@@ -652,14 +1032,165 @@ void AudioFile<T>::addSampleRateToAiffData (std::vector<uint8_t>& fileData, uint
 //=============================================================
 template <class T>
 bool AudioFile<T>::save (std::string filePath, AudioFileFormat format)
+{
+    return saveSamples (getSamplesToSave(), filePath, format);
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::save (std::string filePath, const AudioBufferView<const T>& audio, AudioFileFormat format)
+{
+    SamplesToSave samplesToSave;
+    samplesToSave.sampleStride = audio.getSampleStride();
+    samplesToSave.numSamplesPerChannel = audio.getNumSamples();
+    
+    for (int channel = 0; channel < audio.getNumChannels(); channel++)
+        samplesToSave.channels.push_back (audio.getPointer (channel));
+    
+    return saveSamples (samplesToSave, filePath, format);
+}
+
+//=============================================================
+template <class T>
+typename AudioFile<T>::SamplesToSave AudioFile<T>::getSamplesToSave() const
+{
+    SamplesToSave samplesToSave;
+    samplesToSave.numSamplesPerChannel = getNumSamplesPerChannel();
+    
+    for (int channel = 0; channel < getNumChannels(); channel++)
+        samplesToSave.channels.push_back (samples[channel].data());
+    
+    return samplesToSave;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::saveSamples (const SamplesToSave& samplesToSave, std::string filePath, AudioFileFormat format)
+{
+    std::vector<uint8_t> header, trailer;
+    
+    if (! encodeFileChunks (samplesToSave, format, header, trailer))
+    {
+        reportError ("ERROR: couldn't save file to " + filePath);
+        return false;
+    }
+    
+    std::vector<uint8_t> fileData (header.size() + getNumSampleDataBytes (samplesToSave) + trailer.size());
+    
+    if (! encodeFileData (samplesToSave, format, header, trailer, fileData.data()))
+        return false;
+    
+    // try to write the file
+    return writeDataToFile (fileData, filePath);
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::saveMapped (std::string filePath, AudioFileFormat format, MappedFileSync sync)
+{
+    SamplesToSave samplesToSave = getSamplesToSave();
+    std::vector<uint8_t> header, trailer;
+    
+    if (! encodeFileChunks (samplesToSave, format, header, trailer))
+    {
+        reportError ("ERROR: couldn't save file to " + filePath);
+        return false;
+    }
+    
+    MemoryMappedFile file;
+    
+    if (! file.create (filePath, header.size() + getNumSampleDataBytes (samplesToSave) + trailer.size()))
+    {
+        reportError ("ERROR: couldn't create file " + filePath);
+        return false;
+    }
+    
+    // a file that couldn't be encoded or written to disk is removed, rather than left incomplete
+    if (! encodeFileData (samplesToSave, format, header, trailer, file.writableData())
+        || (sync == MappedFileSync::OnClose && ! file.flush()))
+    {
+        file.close();
+        std::remove (filePath.c_str());
+        reportError ("ERROR: couldn't save file to " + filePath);
+        return false;
+    }
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+size_t AudioFile<T>::computeEncodedSize (AudioFileFormat format) const
+{
+    SamplesToSave samplesToSave = getSamplesToSave();
+    std::vector<uint8_t> header, trailer;
+    
+    if (! encodeFileChunks (samplesToSave, format, header, trailer))
+        return 0;
+    
+    return header.size() + getNumSampleDataBytes (samplesToSave) + trailer.size();
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::saveToMemory (uint8_t* destination, size_t capacity, AudioFileFormat format)
+{
+    SamplesToSave samplesToSave = getSamplesToSave();
+    std::vector<uint8_t> header, trailer;
+    
+    if (! encodeFileChunks (samplesToSave, format, header, trailer))
+    {
+        reportError ("ERROR: couldn't encode the audio");
+        return false;
+    }
+    
+    if (destination == nullptr || capacity < header.size() + getNumSampleDataBytes (samplesToSave) + trailer.size())
+    {
+        reportError ("ERROR: there isn't enough room to encode the audio");
+        return false;
+    }
+    
+    return encodeFileData (samplesToSave, format, header, trailer, destination);
+}
+
+//=============================================================
+template <class T>
+std::vector<uint8_t> AudioFile<T>::saveToMemory (AudioFileFormat format)
+{
+    std::vector<uint8_t> fileData (computeEncodedSize (format));
+    
+    if (fileData.empty() || ! saveToMemory (fileData.data(), fileData.size(), format))
+        return {};
+    
+    return fileData;
+}
+
+//=============================================================
+template <class T>
+SaveHandle AudioFile<T>::saveAsync (std::string filePath, AudioFileFormat format, std::function<void (SaveStatus)> onFinished, AudioFileWriterPool& pool)
+{
+    // the snapshot is copied on this thread, so the writer thread never reads samples that
+    // this AudioFile's owner can still change
+    auto snapshot = std::make_shared<AudioFile<T>> (*this);
+    
+    return pool.add ([snapshot, filePath, format] (const std::atomic<bool>& cancelled)
+    {
+        snapshot->saveCancelled = &cancelled;
+        return snapshot->save (filePath, format);
+    }, std::move (onFinished));
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::encodeFileChunks (const SamplesToSave& samplesToSave, AudioFileFormat format, std::vector<uint8_t>& header, std::vector<uint8_t>& trailer) const
 {
     if (format == AudioFileFormat::Wave)
     {
-        return saveToWaveFile (filePath);
+        return encodeWaveFileChunks (samplesToSave, header, trailer);
     }
     else if (format == AudioFileFormat::Aiff)
     {
-        return saveToAiffFile (filePath);
+        return encodeAiffFileChunks (samplesToSave, header, trailer);
     }
     
     return false;
@@ -667,11 +1198,36 @@ bool AudioFile<T>::save (std::string filePath, AudioFileFormat format)
 
 //=============================================================
 template <class T>
-bool AudioFile<T>::saveToWaveFile (std::string filePath)
+bool AudioFile<T>::encodeFileData (const SamplesToSave& samplesToSave, AudioFileFormat format, const std::vector<uint8_t>& header, const std::vector<uint8_t>& trailer, uint8_t* destination)
 {
-    std::vector<uint8_t> fileData;
+    // only WAV files store floating point samples
+    bool isFloatingPoint = format == AudioFileFormat::Wave && bitDepth == 32 && std::is_floating_point<T>::value;
+    size_t numSampleDataBytes = getNumSampleDataBytes (samplesToSave);
+    
+    std::copy (header.begin(), header.end(), destination);
+    
+    if (! encodeInterleavedSamples (samplesToSave, destination + header.size(), format, isFloatingPoint))
+        return false;
+    
+    std::copy (trailer.begin(), trailer.end(), destination + header.size() + numSampleDataBytes);
+    return true;
+}
+
+//=============================================================
+template <class T>
+size_t AudioFile<T>::getNumSampleDataBytes (const SamplesToSave& samplesToSave) const
+{
+    return samplesToSave.channels.size() * static_cast<size_t> (samplesToSave.numSamplesPerChannel) * static_cast<size_t> (bitDepth / 8);
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::encodeWaveFileChunks (const SamplesToSave& samplesToSave, std::vector<uint8_t>& fileData, std::vector<uint8_t>& trailer) const
+{
+    int numChannels = static_cast<int> (samplesToSave.channels.size());
+    int numSamplesPerChannel = samplesToSave.numSamplesPerChannel;
     
-    int32_t dataChunkSize = getNumSamplesPerChannel() * (getNumChannels() * bitDepth / 8);
+    int32_t dataChunkSize = numSamplesPerChannel * (numChannels * bitDepth / 8);
     int16_t audioFormat = bitDepth == 32 && std::is_floating_point<T>::value ? WavAudioFormat::IEEEFloat : WavAudioFormat::PCM;
     int32_t formatChunkSize = audioFormat == WavAudioFormat::PCM ? 16 : 18;
     int32_t iXMLChunkSize = static_cast<int32_t> (iXMLChunk.size());
@@ -697,13 +1253,13 @@ bool AudioFile<T>::saveToWaveFile (std::string filePath)
     addStringToFileData (fileData, "fmt ");
     addInt32ToFileData (fileData, formatChunkSize); // format chunk size (16 for PCM)
     addInt16ToFileData (fileData, audioFormat); // audio format
-    addInt16ToFileData (fileData, (int16_t)getNumChannels()); // num channels
+    addInt16ToFileData (fileData, (int16_t)numChannels); // num channels
     addInt32ToFileData (fileData, (int32_t)sampleRate); // sample rate
     
-    int32_t numBytesPerSecond = (int32_t) ((getNumChannels() * sampleRate * bitDepth) / 8);
+    int32_t numBytesPerSecond = (int32_t) ((numChannels * sampleRate * bitDepth) / 8);
     addInt32ToFileData (fileData, numBytesPerSecond);
     
-    int16_t numBytesPerBlock = getNumChannels() * (bitDepth / 8);
+    int16_t numBytesPerBlock = numChannels * (bitDepth / 8);
     addInt16ToFileData (fileData, numBytesPerBlock);
     
     addInt16ToFileData (fileData, (int16_t)bitDepth);
@@ -716,81 +1272,33 @@ bool AudioFile<T>::saveToWaveFile (std::string filePath)
     addStringToFileData (fileData, "data");
     addInt32ToFileData (fileData, dataChunkSize);
     
-    for (int i = 0; i < getNumSamplesPerChannel(); i++)
-    {
-        for (int channel = 0; channel < getNumChannels(); channel++)
-        {
-            if (bitDepth == 8)
-            {
-                uint8_t byte = AudioSampleConverter<T>::sampleToUnsignedByte (samples[channel][i]);
-                fileData.push_back (byte);
-            }
-            else if (bitDepth == 16)
-            {
-                int16_t sampleAsInt = AudioSampleConverter<T>::sampleToSixteenBitInt (samples[channel][i]);
-                addInt16ToFileData (fileData, sampleAsInt);
-            }
-            else if (bitDepth == 24)
-            {
-                int32_t sampleAsIntAgain = AudioSampleConverter<T>::sampleToTwentyFourBitInt (samples[channel][i]);
-                
-                uint8_t bytes[3];
-                bytes[2] = (uint8_t) (sampleAsIntAgain >> 16) & 0xFF;
-                bytes[1] = (uint8_t) (sampleAsIntAgain >>  8) & 0xFF;
-                bytes[0] = (uint8_t) sampleAsIntAgain & 0xFF;
-                
-                fileData.push_back (bytes[0]);
-                fileData.push_back (bytes[1]);
-                fileData.push_back (bytes[2]);
-            }
-            else if (bitDepth == 32)
-            {
-                int32_t sampleAsInt;
-                
-                if (audioFormat == WavAudioFormat::IEEEFloat)
-                    sampleAsInt = (int32_t) reinterpret_cast<int32_t&> (samples[channel][i]);
-                else // assume PCM
-                    sampleAsInt = AudioSampleConverter<T>::sampleToThirtyTwoBitInt (samples[channel][i]);
-                
-                addInt32ToFileData (fileData, sampleAsInt, Endianness::LittleEndian);
-            }
-            else
-            {
-                assert (false && "Trying to write a file with unsupported bit depth");
-                return false;
-            }
-        }
-    }
+    // (the sample data goes here)
     
     // -----------------------------------------------------------
     // iXML CHUNK
     if (iXMLChunkSize > 0) 
     {
-        addStringToFileData (fileData, "iXML");
-        addInt32ToFileData (fileData, iXMLChunkSize);
-        addStringToFileData (fileData, iXMLChunk);
+        addStringToFileData (trailer, "iXML");
+        addInt32ToFileData (trailer, iXMLChunkSize);
+        addStringToFileData (trailer, iXMLChunk);
     }
     
     // check that the various sizes we put in the metadata are correct
-    if (fileSizeInBytes != static_cast<int32_t> (fileData.size() - 8) || dataChunkSize != (getNumSamplesPerChannel() * getNumChannels() * (bitDepth / 8)))
-    {
-        reportError ("ERROR: couldn't save file to " + filePath);
-        return false;
-    }
+    size_t fileSize = fileData.size() + getNumSampleDataBytes (samplesToSave) + trailer.size();
     
-    // try to write the file
-    return writeDataToFile (fileData, filePath);
+    return fileSizeInBytes == static_cast<int32_t> (fileSize - 8) && dataChunkSize == (numSamplesPerChannel * numChannels * (bitDepth / 8));
 }
 
 //=============================================================
 template <class T>
-bool AudioFile<T>::saveToAiffFile (std::string filePath)
+bool AudioFile<T>::encodeAiffFileChunks (const SamplesToSave& samplesToSave, std::vector<uint8_t>& fileData, std::vector<uint8_t>& trailer) const
 {
-    std::vector<uint8_t> fileData;
+    int numChannels = static_cast<int> (samplesToSave.channels.size());
+    int numSamplesPerChannel = samplesToSave.numSamplesPerChannel;
     
     int32_t numBytesPerSample = bitDepth / 8;
-    int32_t numBytesPerFrame = numBytesPerSample * getNumChannels();
-    int32_t totalNumAudioSampleBytes = getNumSamplesPerChannel() * numBytesPerFrame;
+    int32_t numBytesPerFrame = numBytesPerSample * numChannels;
+    int32_t totalNumAudioSampleBytes = numSamplesPerChannel * numBytesPerFrame;
     int32_t soundDataChunkSize = totalNumAudioSampleBytes + 8;
     int32_t iXMLChunkSize = static_cast<int32_t> (iXMLChunk.size());
     
@@ -814,8 +1322,8 @@ bool AudioFile<T>::saveToAiffFile (std::string filePath)
     // COMM CHUNK
     addStringToFileData (fileData, "COMM");
     addInt32ToFileData (fileData, 18, Endianness::BigEndian); // commChunkSize
-    addInt16ToFileData (fileData, getNumChannels(), Endianness::BigEndian); // num channels
-    addInt32ToFileData (fileData, getNumSamplesPerChannel(), Endianness::BigEndian); // num samples per channel
+    addInt16ToFileData (fileData, numChannels, Endianness::BigEndian); // num channels
+    addInt32ToFileData (fileData, numSamplesPerChannel, Endianness::BigEndian); // num samples per channel
     addInt16ToFileData (fileData, bitDepth, Endianness::BigEndian); // bit depth
     addSampleRateToAiffData (fileData, sampleRate);
     
@@ -826,65 +1334,21 @@ bool AudioFile<T>::saveToAiffFile (std::string filePath)
     addInt32ToFileData (fileData, 0, Endianness::BigEndian); // offset
     addInt32ToFileData (fileData, 0, Endianness::BigEndian); // block size
     
-    for (int i = 0; i < getNumSamplesPerChannel(); i++)
-    {
-        for (int channel = 0; channel < getNumChannels(); channel++)
-        {
-            if (bitDepth == 8)
-            {
-                uint8_t byte = static_cast<uint8_t> (AudioSampleConverter<T>::sampleToSignedByte (samples[channel][i]));
-                fileData.push_back (byte);
-            }
-            else if (bitDepth == 16)
-            {
-                int16_t sampleAsInt = AudioSampleConverter<T>::sampleToSixteenBitInt (samples[channel][i]);
-                addInt16ToFileData (fileData, sampleAsInt, Endianness::BigEndian);
-            }
-            else if (bitDepth == 24)
-            {
-                int32_t sampleAsIntAgain = AudioSampleConverter<T>::sampleToTwentyFourBitInt (samples[channel][i]);
-                
-                uint8_t bytes[3];
-                bytes[0] = (uint8_t) (sampleAsIntAgain >> 16) & 0xFF;
-                bytes[1] = (uint8_t) (sampleAsIntAgain >>  8) & 0xFF;
-                bytes[2] = (uint8_t) sampleAsIntAgain & 0xFF;
-                
-                fileData.push_back (bytes[0]);
-                fileData.push_back (bytes[1]);
-                fileData.push_back (bytes[2]);
-            }
-            else if (bitDepth == 32)
-            {
-                // write samples as signed integers (no implementation yet for floating point, but looking at WAV implementation should help)
-                int32_t sampleAsInt = AudioSampleConverter<T>::sampleToThirtyTwoBitInt (samples[channel][i]);
-                addInt32ToFileData (fileData, sampleAsInt, Endianness::BigEndian);
-            }
-            else
-            {
-                assert (false && "Trying to write a file with unsupported bit depth");
-                return false;
-            }
-        }
-    }
+    // (the sample data goes here)
 
     // -----------------------------------------------------------
     // iXML CHUNK
     if (iXMLChunkSize > 0)
     {
-        addStringToFileData (fileData, "iXML");
-        addInt32ToFileData (fileData, iXMLChunkSize, Endianness::BigEndian);
-        addStringToFileData (fileData, iXMLChunk);
+        addStringToFileData (trailer, "iXML");
+        addInt32ToFileData (trailer, iXMLChunkSize, Endianness::BigEndian);
+        addStringToFileData (trailer, iXMLChunk);
     }
     
     // check that the various sizes we put in the metadata are correct
-    if (fileSizeInBytes != static_cast<int32_t> (fileData.size() - 8) || soundDataChunkSize != getNumSamplesPerChannel() *  numBytesPerFrame + 8)
-    {
-        reportError ("ERROR: couldn't save file to " + filePath);
-        return false;
-    }
+    size_t fileSize = fileData.size() + getNumSampleDataBytes (samplesToSave) + trailer.size();
     
-    // try to write the file
-    return writeDataToFile (fileData, filePath);
+    return fileSizeInBytes == static_cast<int32_t> (fileSize - 8) && soundDataChunkSize == numSamplesPerChannel *  numBytesPerFrame + 8;
 }
 
 //=============================================================
@@ -895,11 +1359,7 @@ bool AudioFile<T>::writeDataToFile (std::vector<uint8_t>& fileData, std::string
     
     if (outputFile.is_open())
     {
-        for (size_t i = 0; i < fileData.size(); i++)
-        {
-            char value = (char) fileData[i];
-            outputFile.write (&value, sizeof (char));
-        }
+        outputFile.write (reinterpret_cast<const char*> (fileData.data()), static_cast<std::streamsize> (fileData.size()));
         
         outputFile.close();
         
@@ -911,7 +1371,7 @@ bool AudioFile<T>::writeDataToFile (std::vector<uint8_t>& fileData, std::string
 
 //=============================================================
 template <class T>
-void AudioFile<T>::addStringToFileData (std::vector<uint8_t>& fileData, std::string s)
+void AudioFile<T>::addStringToFileData (std::vector<uint8_t>& fileData, std::string s) const
 {
     for (size_t i = 0; i < s.length();i++)
         fileData.push_back ((uint8_t) s[i]);
@@ -919,7 +1379,7 @@ void AudioFile<T>::addStringToFileData (std::vector<uint8_t>& fileData, std::str
 
 //=============================================================
 template <class T>
-void AudioFile<T>::addInt32ToFileData (std::vector<uint8_t>& fileData, int32_t i, Endianness endianness)
+void AudioFile<T>::addInt32ToFileData (std::vector<uint8_t>& fileData, int32_t i, Endianness endianness) const
 {
     uint8_t bytes[4];
     
@@ -944,7 +1404,7 @@ void AudioFile<T>::addInt32ToFileData (std::vector<uint8_t>& fileData, int32_t i
 
 //=============================================================
 template <class T>
-void AudioFile<T>::addInt16ToFileData (std::vector<uint8_t>& fileData, int16_t i, Endianness endianness)
+void AudioFile<T>::addInt16ToFileData (std::vector<uint8_t>& fileData, int16_t i, Endianness endianness) const
 {
     uint8_t bytes[2];
     
@@ -963,6 +1423,252 @@ void AudioFile<T>::addInt16ToFileData (std::vector<uint8_t>& fileData, int16_t i
     fileData.push_back (bytes[1]);
 }
 
+//=============================================================
+template <class T>
+int AudioFile<T>::getNumRepeatedFrames (const SamplesToSave& samplesToSave, int sampleIndex) const
+{
+    if (sampleIndex % silenceBlockSize != 0)
+        return 0;
+    
+    int numChannels = static_cast<int> (samplesToSave.channels.size());
+    int numSamples = std::min (silenceBlockSize, samplesToSave.numSamplesPerChannel - sampleIndex);
+    
+    // samples are compared by their bit patterns rather than with ==, which would treat
+    // -0.0 as equal to 0.0 and so lose its sign when the first frame is repeated
+    if (samplesToSave.isInterleaved())
+    {
+        const T* frames = samplesToSave.channels[0] + sampleIndex * samplesToSave.sampleStride;
+        size_t numBytesToCompare = static_cast<size_t> (numSamples - 1) * numChannels * sizeof (T);
+        return std::memcmp (frames, frames + numChannels, numBytesToCompare) == 0 ? numSamples : 0;
+    }
+    
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        const T* channelSamples = samplesToSave.channels[channel] + sampleIndex * samplesToSave.sampleStride;
+        
+        if (samplesToSave.sampleStride == 1)
+        {
+            if (std::memcmp (channelSamples, channelSamples + 1, static_cast<size_t> (numSamples - 1) * sizeof (T)) != 0)
+                return 0;
+        }
+        else
+        {
+            for (int i = 1; i < numSamples; i++)
+                if (std::memcmp (channelSamples, channelSamples + i * samplesToSave.sampleStride, sizeof (T)) != 0)
+                    return 0;
+        }
+    }
+    
+    return numSamples;
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::encodeInterleavedSamples (const SamplesToSave& samplesToSave, uint8_t* frames, AudioFileFormat format, bool isFloatingPoint)
+{
+    int numChannels = static_cast<int> (samplesToSave.channels.size());
+    int numSamples = samplesToSave.numSamplesPerChannel;
+    
+    if (numChannels == 0 || numSamples == 0)
+        return true;
+    
+    if (bitDepth != 8 && bitDepth != 16 && bitDepth != 24 && bitDepth != 32)
+    {
+        assert (false && "Trying to write a file with unsupported bit depth");
+        return false;
+    }
+    
+    bool dither = AudioDither<T>::isUsed (ditherType, bitDepth, isFloatingPoint);
+    int numThreads = getNumEncodingThreads (numChannels, numSamples);
+    
+    if (dither && ditherType == DitherType::NoiseShaped)
+    {
+        // noise shaping depends on every earlier sample of a channel, so each thread encodes whole channels
+        numThreads = std::min (numThreads, numChannels);
+        
+        runInParallel (numThreads, [&] (int job)
+        {
+            encodeDitheredSamples (samplesToSave, frames, format, 0, numSamples, (numChannels * job) / numThreads, (numChannels * (job + 1)) / numThreads);
+        });
+        
+        return ! isSaveCancelled();
+    }
+    
+    // each thread encodes a range of whole blocks, so silence is found in exactly the same blocks
+    // as it would be on one thread, and the dither noise only depends on the sample index
+    int numBlocks = (numSamples + silenceBlockSize - 1) / silenceBlockSize;
+    
+    runInParallel (numThreads, [&] (int job)
+    {
+        int startSample = static_cast<int> ((static_cast<int64_t> (numBlocks) * job) / numThreads) * silenceBlockSize;
+        int endSample = std::min (static_cast<int> ((static_cast<int64_t> (numBlocks) * (job + 1)) / numThreads) * silenceBlockSize, numSamples);
+        
+        if (dither)
+            encodeDitheredSamples (samplesToSave, frames, format, startSample, endSample, 0, numChannels);
+        else
+            encodeSampleRange (samplesToSave, frames, format, isFloatingPoint, startSample, endSample);
+    });
+    
+    return ! isSaveCancelled();
+}
+
+//=============================================================
+template <class T>
+void AudioFile<T>::encodeSampleRange (const SamplesToSave& samplesToSave, uint8_t* frames, AudioFileFormat format, bool isFloatingPoint, int startSample, int endSample)
+{
+    int numChannels = static_cast<int> (samplesToSave.channels.size());
+    size_t numBytesPerSample = static_cast<size_t> (bitDepth / 8);
+    size_t numBytesPerFrame = numBytesPerSample * numChannels;
+    
+    std::vector<const T*> sources (numChannels);
+    
+    // samples that are neither in separate channels nor in interleaved frames are gathered
+    // into separate channels a block at a time
+    bool gatherSamples = samplesToSave.sampleStride != 1 && ! samplesToSave.isInterleaved();
+    std::vector<T> gatheredSamples (gatherSamples ? static_cast<size_t> (silenceBlockSize) * numChannels : 0);
+    
+    for (int i = startSample; i < endSample && ! isSaveCancelled(); i += silenceBlockSize)
+    {
+        int numRepeatedFrames = getNumRepeatedFrames (samplesToSave, i);
+        int numSamplesToEncode = numRepeatedFrames > 0 ? 1 : std::min (silenceBlockSize, endSample - i);
+        uint8_t* blockFrames = frames + numBytesPerFrame * i;
+        
+        if (samplesToSave.isInterleaved())
+        {
+            // the samples are already in the order they are stored in the file
+            AudioSampleConverter<T>::encodeSamples (samplesToSave.channels[0] + i * samplesToSave.sampleStride, numSamplesToEncode * numChannels,
+                                                    bitDepth, format, isFloatingPoint, blockFrames, numBytesPerSample);
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+            {
+                sources[channel] = samplesToSave.channels[channel] + i * samplesToSave.sampleStride;
+                
+                if (gatherSamples)
+                {
+                    T* gathered = gatheredSamples.data() + channel * silenceBlockSize;
+                    
+                    for (int k = 0; k < numSamplesToEncode; k++)
+                        gathered[k] = sources[channel][k * samplesToSave.sampleStride];
+                    
+                    sources[channel] = gathered;
+                }
+            }
+            
+            AudioSampleConverter<T>::encodeFrames (sources.data(), numChannels, numSamplesToEncode, bitDepth, format, isFloatingPoint, blockFrames);
+        }
+        
+        // a block of identical frames (usually digital silence) is written by repeating the first one
+        if (numRepeatedFrames > 1)
+            repeatFrame (blockFrames, numBytesPerFrame, numRepeatedFrames - 1);
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioFile<T>::encodeDitheredSamples (const SamplesToSave& samplesToSave, uint8_t* frames, AudioFileFormat format, int startSample, int endSample, int startChannel, int endChannel)
+{
+    int numChannels = static_cast<int> (samplesToSave.channels.size());
+    size_t numBytesPerSample = static_cast<size_t> (bitDepth / 8);
+    size_t numBytesPerFrame = numBytesPerSample * numChannels;
+    
+    std::vector<AudioDither<T>> dithers;
+    
+    for (int channel = startChannel; channel < endChannel; channel++)
+        dithers.emplace_back (ditherType, bitDepth, channel);
+    
+    // each block is quantised to integer codes, then encoded while it is still in the cache.
+    // Digital silence is dithered too, so there is no shortcut for silent blocks here
+    int32_t codes[silenceBlockSize];
+    
+    for (int i = startSample; i < endSample && ! isSaveCancelled(); i += silenceBlockSize)
+    {
+        int numSamplesInBlock = std::min (silenceBlockSize, endSample - i);
+        
+        for (int channel = startChannel; channel < endChannel; channel++)
+        {
+            dithers[channel - startChannel].quantise (samplesToSave.channels[channel] + i * samplesToSave.sampleStride, samplesToSave.sampleStride, numSamplesInBlock, i, codes);
+            AudioSampleConverter<int32_t>::encodeSamples (codes, numSamplesInBlock, bitDepth, format, false,
+                                                          frames + numBytesPerFrame * i + numBytesPerSample * channel, numBytesPerFrame);
+        }
+    }
+}
+
+//=============================================================
+template <class T>
+int AudioFile<T>::getNumEncodingThreads (int numChannels, int numSamples) const
+{
+    int numThreads = numEncodingThreads > 0 ? numEncodingThreads : static_cast<int> (std::thread::hardware_concurrency());
+    
+    // small files aren't worth starting threads for
+    int64_t numSamplesInFile = static_cast<int64_t> (numChannels) * numSamples;
+    int64_t maximumNumThreads = std::max (numSamplesInFile / minimumSamplesPerEncodingThread, static_cast<int64_t> (1));
+    
+    return static_cast<int> (std::min (static_cast<int64_t> (std::max (numThreads, 1)), maximumNumThreads));
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::isSaveCancelled() const
+{
+    return saveCancelled != nullptr && saveCancelled->load (std::memory_order_relaxed);
+}
+
+//=============================================================
+template <class T>
+void AudioFile<T>::runInParallel (int numJobs, const std::function<void (int)>& job)
+{
+    std::vector<std::thread> threads;
+    
+    for (int i = 1; i < numJobs; i++)
+    {
+        try
+        {
+            threads.emplace_back (job, i);
+        }
+        catch (const std::system_error&)
+        {
+            // if no more threads can be started, the job is done on this thread instead
+            job (i);
+        }
+    }
+    
+    job (0);
+    
+    for (auto& thread : threads)
+        thread.join();
+}
+
+//=============================================================
+template <class T>
+bool AudioFile<T>::SamplesToSave::isInterleaved() const
+{
+    if (sampleStride != static_cast<std::ptrdiff_t> (channels.size()))
+        return false;
+    
+    for (size_t channel = 1; channel < channels.size(); channel++)
+        if (channels[channel] != channels[0] + channel)
+            return false;
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+void AudioFile<T>::repeatFrame (uint8_t* frame, size_t numBytesPerFrame, int numRepeats)
+{
+    if (std::all_of (frame, frame + numBytesPerFrame, [&] (uint8_t byte) { return byte == frame[0]; }))
+    {
+        std::fill (frame + numBytesPerFrame, frame + numBytesPerFrame * (numRepeats + 1), frame[0]);
+    }
+    else
+    {
+        for (int i = 1; i <= numRepeats; i++)
+            std::copy (frame, frame + numBytesPerFrame, frame + numBytesPerFrame * i);
+    }
+}
+
 //=============================================================
 template <class T>
 void AudioFile<T>::clearAudioBuffer()
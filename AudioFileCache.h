@@ -0,0 +1,207 @@
+//=======================================================================
+/** @file AudioFileCache.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+//=============================================================
+/** Identifies a particular version of a file on disk by its absolute path,
+ * modification time and size.
+ */
+struct AudioFileIdentity
+{
+    std::string filePath;
+    int64_t modificationTime = 0;
+    uint64_t size = 0;
+
+    /** Reads the identity of the file at the given path.
+     * @Returns false if the file doesn't exist or can't be read
+     */
+    bool read (const std::string& path);
+
+    /** @Returns a 64-bit hash of the path, modification time and size (never zero) */
+    uint64_t getHash() const;
+
+    /** @Returns the absolute, normalised version of a file path */
+    static std::string getNormalisedPath (const std::string& path);
+
+    bool operator== (const AudioFileIdentity& other) const;
+    bool operator!= (const AudioFileIdentity& other) const;
+};
+
+//=============================================================
+/** A thread-safe, in-process cache of decoded audio files.
+ *
+ * Files are identified by their path, modification time and size, so a file that
+ * changes on disk is decoded again on the next request. Decoded files are handed
+ * out as shared, immutable AudioFile objects - a cache hit is a pointer copy and
+ * never copies any samples. The cache is bounded by a byte budget and evicts the
+ * least recently used files first. Files that are evicted while still in use stay
+ * alive until the last user releases them.
+ */
+template <class T>
+class AudioFileCache
+{
+public:
+
+    //=============================================================
+    typedef std::shared_ptr<const AudioFile<T>> SharedAudioFile;
+
+    //=============================================================
+    /** Counters describing how the cache has been used */
+    struct Statistics
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t waits = 0;   // loads that waited for another thread to decode the same file
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+        size_t numEntries = 0;
+        size_t sizeInBytes = 0;
+    };
+
+    //=============================================================
+    /** Constructor
+     * @param maxSizeInBytes the maximum number of bytes of decoded audio the cache will hold
+     */
+    AudioFileCache (size_t maxSizeInBytes = 512 * 1024 * 1024);
+
+    /** Destructor */
+    ~AudioFileCache();
+
+    AudioFileCache (const AudioFileCache&) = delete;
+    AudioFileCache& operator= (const AudioFileCache&) = delete;
+
+    //=============================================================
+    /** Returns the decoded audio for the file at the given path, decoding and caching
+     * it if it isn't already in the cache (or the file has changed since it was cached).
+     * @Returns the decoded file, or nullptr if the file couldn't be loaded
+     */
+    SharedAudioFile load (const std::string& filePath);
+
+    /** Removes any cached audio for the file at the given path */
+    void invalidate (const std::string& filePath);
+
+    /** Removes all cached audio */
+    void clear();
+
+    //=============================================================
+    /** Sets the maximum number of bytes of decoded audio to hold, evicting files if necessary */
+    void setMaximumSizeInBytes (size_t newMaximumSizeInBytes);
+
+    /** @Returns the maximum number of bytes of decoded audio the cache will hold */
+    size_t getMaximumSizeInBytes() const;
+
+    //=============================================================
+    /** Sets whether cached files should be watched for changes (using inotify), so that
+     * their audio is released as soon as the file changes rather than on the next load.
+     * @Returns true if file watching is enabled, or false if it isn't supported on this platform
+     */
+    bool setWatchForFileChanges (bool shouldWatch);
+
+    //=============================================================
+    /** @Returns the hit, miss, wait, eviction and invalidation counters along with the current usage */
+    Statistics getStatistics() const;
+
+    /** Resets the hit, miss, wait, eviction and invalidation counters to zero */
+    void resetStatistics();
+
+    //=============================================================
+    /** Sets whether the cache should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+
+    //=============================================================
+    /** @Returns the number of bytes used by the decoded audio in an AudioFile */
+    static size_t getSizeInBytes (const AudioFile<T>& audioFile);
+
+private:
+
+    //=============================================================
+    struct Entry
+    {
+        AudioFileIdentity identity;
+        SharedAudioFile audioFile;
+        size_t sizeInBytes = 0;
+        int watchDescriptor = -1;
+    };
+
+    typedef typename std::list<Entry>::iterator EntryIterator;
+
+    /** A file that a thread is decoding, which other threads loading the same version of it wait for */
+    struct PendingLoad
+    {
+        AudioFileIdentity identity;
+        std::shared_future<SharedAudioFile> result;
+    };
+
+    //=============================================================
+    void insertEntry (const AudioFileIdentity& identity, SharedAudioFile audioFile);
+    void removeEntry (EntryIterator entry);
+    void evictToFit (size_t numBytesNeeded);
+    void erasePendingLoad (const AudioFileIdentity& identity);
+
+    //=============================================================
+    void addWatch (Entry& entry);
+    void removeWatch (Entry& entry);
+    void stopWatching();
+    void watchForFileChanges();
+
+    //=============================================================
+    void reportError (std::string errorMessage);
+
+    //=============================================================
+    mutable std::mutex lock;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<std::string, EntryIterator> entriesByKey;
+    std::unordered_map<std::string, PendingLoad> pendingLoads;
+
+    size_t maximumSizeInBytes;
+    size_t sizeInBytes {0};
+    Statistics statistics;
+    std::atomic<bool> logErrorsToConsole {true};
+
+    //=============================================================
+    bool watchingForFileChanges {false};
+    int inotifyFileDescriptor {-1};
+    int wakeUpFileDescriptor {-1};
+    std::unordered_map<int, std::string> keysByWatchDescriptor;
+    std::thread watcherThread;
+};
+
+#include "AudioFileCache.inl"
@@ -0,0 +1,541 @@
+//=======================================================================
+/** @file AudioFileCache.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <filesystem>
+#include <iterator>
+
+#if defined (__linux__)
+    #include <sys/inotify.h>
+    #include <sys/eventfd.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+//=============================================================
+inline bool AudioFileIdentity::read (const std::string& path)
+{
+    filePath = getNormalisedPath (path);
+
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size (filePath, error);
+
+    if (error)
+        return false;
+
+    auto lastWriteTime = std::filesystem::last_write_time (filePath, error);
+
+    if (error)
+        return false;
+
+    size = static_cast<uint64_t> (fileSize);
+    modificationTime = static_cast<int64_t> (lastWriteTime.time_since_epoch().count());
+    return true;
+}
+
+//=============================================================
+inline uint64_t AudioFileIdentity::getHash() const
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    auto addBytes = [&hash] (const void* data, size_t numBytes)
+    {
+        for (size_t i = 0; i < numBytes; i++)
+        {
+            hash ^= static_cast<const uint8_t*> (data)[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    addBytes (filePath.data(), filePath.size());
+    addBytes (&modificationTime, sizeof (modificationTime));
+    addBytes (&size, sizeof (size));
+
+    return hash == 0 ? 1 : hash;
+}
+
+//=============================================================
+inline std::string AudioFileIdentity::getNormalisedPath (const std::string& path)
+{
+    std::error_code error;
+    std::filesystem::path absolutePath = std::filesystem::absolute (path, error);
+
+    if (error)
+        return path;
+
+    return absolutePath.lexically_normal().string();
+}
+
+//=============================================================
+inline bool AudioFileIdentity::operator== (const AudioFileIdentity& other) const
+{
+    return filePath == other.filePath && modificationTime == other.modificationTime && size == other.size;
+}
+
+//=============================================================
+inline bool AudioFileIdentity::operator!= (const AudioFileIdentity& other) const
+{
+    return ! (*this == other);
+}
+
+//=============================================================
+template <class T>
+AudioFileCache<T>::AudioFileCache (size_t maxSizeInBytes)
+ :  maximumSizeInBytes (maxSizeInBytes)
+{
+}
+
+//=============================================================
+template <class T>
+AudioFileCache<T>::~AudioFileCache()
+{
+    stopWatching();
+}
+
+//=============================================================
+template <class T>
+typename AudioFileCache<T>::SharedAudioFile AudioFileCache<T>::load (const std::string& filePath)
+{
+    AudioFileIdentity identity;
+
+    if (! identity.read (filePath))
+    {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            statistics.misses++;
+        }
+
+        invalidate (filePath);
+        reportError ("ERROR: File doesn't exist or otherwise can't load file\n" + filePath);
+        return nullptr;
+    }
+
+    const std::string& key = identity.filePath;
+    std::promise<SharedAudioFile> promise;
+
+    {
+        std::unique_lock<std::mutex> guard (lock);
+
+        auto existing = entriesByKey.find (key);
+
+        if (existing != entriesByKey.end())
+        {
+            EntryIterator entry = existing->second;
+
+            if (entry->identity == identity)
+            {
+                entries.splice (entries.begin(), entries, entry);
+                statistics.hits++;
+                return entry->audioFile;
+            }
+
+            // the file has changed since we cached it
+            removeEntry (entry);
+            statistics.invalidations++;
+        }
+
+        // if another thread is already decoding this version of the file, wait for it rather than
+        // decoding it twice. A decode of an older version is left to finish without being cached
+        auto pending = pendingLoads.find (key);
+
+        if (pending != pendingLoads.end() && pending->second.identity == identity)
+        {
+            std::shared_future<SharedAudioFile> pendingLoad = pending->second.result;
+            statistics.waits++;
+            guard.unlock();
+            return pendingLoad.get();
+        }
+
+        pendingLoads[key] = { identity, promise.get_future().share() };
+        statistics.misses++;
+    }
+
+    SharedAudioFile result;
+
+    try
+    {
+        auto audioFile = std::make_shared<AudioFile<T>>();
+        audioFile->shouldLogErrorsToConsole (logErrorsToConsole);
+
+        if (audioFile->load (key))
+            result = audioFile;
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            erasePendingLoad (identity);
+        }
+
+        promise.set_exception (std::current_exception());
+        throw;
+    }
+
+    // only cache the result if the file didn't change while we were decoding it
+    AudioFileIdentity identityAfterLoading;
+    bool fileIsUnchanged = identityAfterLoading.read (key) && identityAfterLoading == identity;
+
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        erasePendingLoad (identity);
+
+        if (result != nullptr && fileIsUnchanged)
+            insertEntry (identity, result);
+    }
+
+    promise.set_value (result);
+    return result;
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::invalidate (const std::string& filePath)
+{
+    std::lock_guard<std::mutex> guard (lock);
+
+    auto existing = entriesByKey.find (AudioFileIdentity::getNormalisedPath (filePath));
+
+    if (existing != entriesByKey.end())
+    {
+        removeEntry (existing->second);
+        statistics.invalidations++;
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::clear()
+{
+    std::lock_guard<std::mutex> guard (lock);
+
+    while (! entries.empty())
+        removeEntry (entries.begin());
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::setMaximumSizeInBytes (size_t newMaximumSizeInBytes)
+{
+    std::lock_guard<std::mutex> guard (lock);
+    maximumSizeInBytes = newMaximumSizeInBytes;
+    evictToFit (0);
+}
+
+//=============================================================
+template <class T>
+size_t AudioFileCache<T>::getMaximumSizeInBytes() const
+{
+    std::lock_guard<std::mutex> guard (lock);
+    return maximumSizeInBytes;
+}
+
+//=============================================================
+template <class T>
+bool AudioFileCache<T>::setWatchForFileChanges (bool shouldWatch)
+{
+    if (! shouldWatch)
+    {
+        stopWatching();
+        return false;
+    }
+
+    if (watcherThread.joinable())
+        return true;
+
+#if defined (__linux__)
+    inotifyFileDescriptor = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    wakeUpFileDescriptor = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (inotifyFileDescriptor < 0 || wakeUpFileDescriptor < 0)
+    {
+        if (inotifyFileDescriptor >= 0)
+            close (inotifyFileDescriptor);
+
+        if (wakeUpFileDescriptor >= 0)
+            close (wakeUpFileDescriptor);
+
+        inotifyFileDescriptor = -1;
+        wakeUpFileDescriptor = -1;
+
+        reportError ("ERROR: couldn't start watching files for changes");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        watchingForFileChanges = true;
+
+        for (auto& entry : entries)
+            addWatch (entry);
+    }
+
+    watcherThread = std::thread ([this] { watchForFileChanges(); });
+    return true;
+#else
+    reportError ("ERROR: watching files for changes is not supported on this platform");
+    return false;
+#endif
+}
+
+//=============================================================
+template <class T>
+typename AudioFileCache<T>::Statistics AudioFileCache<T>::getStatistics() const
+{
+    std::lock_guard<std::mutex> guard (lock);
+
+    Statistics result = statistics;
+    result.numEntries = entries.size();
+    result.sizeInBytes = sizeInBytes;
+    return result;
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::resetStatistics()
+{
+    std::lock_guard<std::mutex> guard (lock);
+    statistics = Statistics();
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+size_t AudioFileCache<T>::getSizeInBytes (const AudioFile<T>& audioFile)
+{
+    size_t numBytes = sizeof (AudioFile<T>) + audioFile.iXMLChunk.capacity();
+
+    for (auto& channel : audioFile.samples)
+        numBytes += channel.capacity() * sizeof (T);
+
+    return numBytes;
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::insertEntry (const AudioFileIdentity& identity, SharedAudioFile audioFile)
+{
+    size_t numBytes = getSizeInBytes (*audioFile);
+
+    // files larger than the whole budget are handed out but never cached
+    if (numBytes > maximumSizeInBytes)
+        return;
+
+    evictToFit (numBytes);
+
+    Entry entry;
+    entry.identity = identity;
+    entry.audioFile = std::move (audioFile);
+    entry.sizeInBytes = numBytes;
+
+    entries.push_front (std::move (entry));
+    entriesByKey[identity.filePath] = entries.begin();
+    sizeInBytes += numBytes;
+
+    addWatch (entries.front());
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::removeEntry (EntryIterator entry)
+{
+    removeWatch (*entry);
+    sizeInBytes -= entry->sizeInBytes;
+    entriesByKey.erase (entry->identity.filePath);
+    entries.erase (entry);
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::evictToFit (size_t numBytesNeeded)
+{
+    while (! entries.empty() && sizeInBytes + numBytesNeeded > maximumSizeInBytes)
+    {
+        removeEntry (std::prev (entries.end()));
+        statistics.evictions++;
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::erasePendingLoad (const AudioFileIdentity& identity)
+{
+    // a thread loading a newer version of the file may have replaced this load with its own
+    auto pending = pendingLoads.find (identity.filePath);
+
+    if (pending != pendingLoads.end() && pending->second.identity == identity)
+        pendingLoads.erase (pending);
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::addWatch (Entry& entry)
+{
+#if defined (__linux__)
+    if (! watchingForFileChanges || entry.watchDescriptor >= 0)
+        return;
+
+    int watchDescriptor = inotify_add_watch (inotifyFileDescriptor, entry.identity.filePath.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+
+    if (watchDescriptor >= 0)
+    {
+        entry.watchDescriptor = watchDescriptor;
+        keysByWatchDescriptor[watchDescriptor] = entry.identity.filePath;
+    }
+#else
+    (void) entry;
+#endif
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::removeWatch (Entry& entry)
+{
+#if defined (__linux__)
+    if (entry.watchDescriptor < 0)
+        return;
+
+    if (inotifyFileDescriptor >= 0)
+        inotify_rm_watch (inotifyFileDescriptor, entry.watchDescriptor);
+
+    keysByWatchDescriptor.erase (entry.watchDescriptor);
+    entry.watchDescriptor = -1;
+#else
+    (void) entry;
+#endif
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::stopWatching()
+{
+#if defined (__linux__)
+    if (! watcherThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        watchingForFileChanges = false;
+    }
+
+    uint64_t wakeUp = 1;
+
+    if (write (wakeUpFileDescriptor, &wakeUp, sizeof (wakeUp)) < 0)
+        reportError ("ERROR: couldn't stop watching files for changes");
+
+    watcherThread.join();
+
+    std::lock_guard<std::mutex> guard (lock);
+
+    for (auto& entry : entries)
+        removeWatch (entry);
+
+    close (inotifyFileDescriptor);
+    close (wakeUpFileDescriptor);
+    inotifyFileDescriptor = -1;
+    wakeUpFileDescriptor = -1;
+#endif
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::watchForFileChanges()
+{
+#if defined (__linux__)
+    alignas (inotify_event) char buffer[4096];
+
+    pollfd fileDescriptors[2];
+    fileDescriptors[0] = { inotifyFileDescriptor, POLLIN, 0 };
+    fileDescriptors[1] = { wakeUpFileDescriptor, POLLIN, 0 };
+
+    while (true)
+    {
+        if (poll (fileDescriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        if (fileDescriptors[1].revents != 0)
+            break;
+
+        ssize_t numBytesRead;
+
+        while ((numBytesRead = read (inotifyFileDescriptor, buffer, sizeof (buffer))) > 0)
+        {
+            std::lock_guard<std::mutex> guard (lock);
+
+            for (char* position = buffer; position < buffer + numBytesRead;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*> (position);
+                position += sizeof (inotify_event) + event->len;
+
+                auto watched = keysByWatchDescriptor.find (event->wd);
+
+                if (watched == keysByWatchDescriptor.end())
+                    continue;
+
+                auto existing = entriesByKey.find (watched->second);
+
+                if (existing == entriesByKey.end() || existing->second->watchDescriptor != event->wd)
+                    continue;
+
+                if (event->mask & IN_IGNORED)
+                {
+                    // the kernel has already dropped this watch
+                    keysByWatchDescriptor.erase (watched);
+                    existing->second->watchDescriptor = -1;
+                }
+
+                removeEntry (existing->second);
+                statistics.invalidations++;
+            }
+        }
+    }
+#endif
+}
+
+//=============================================================
+template <class T>
+void AudioFileCache<T>::reportError (std::string errorMessage)
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
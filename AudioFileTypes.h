@@ -46,6 +46,7 @@
 #include <iterator>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
 
 // disable some warnings on Windows
 #if defined (_MSC_VER)
@@ -100,6 +101,23 @@ static std::unordered_map <uint32_t, std::vector<uint8_t>> aiffSampleRateTable =
     {5644800, {64, 21, 172, 68, 0, 0, 0, 0, 0, 0}}
 };
 
+//=============================================================
+/** The ways floating point samples can be dithered when they are saved as integers */
+enum class DitherType
+{
+    None,           // samples are simply truncated
+    Triangular,     // triangular (TPDF) dither of up to one step either way, then rounded
+    NoiseShaped     // triangular dither, with the noise moved towards high frequencies
+};
+
+//=============================================================
+/** When a file saved through a memory mapping is written to disk */
+enum class MappedFileSync
+{
+    Kernel,         // the operating system writes the file back in its own time
+    OnClose         // saving waits until the file has been written to disk
+};
+
 //=============================================================
 enum WavAudioFormat
 {
@@ -138,6 +156,54 @@ enum class Endianness
     BigEndian
 };
 
+//=============================================================
+/** A fixed point sample in Q15 format, i.e. a 16-bit integer where 32768 represents 1.0.
+ * This can be used as the sample type of an AudioFile on hardware that only processes
+ * audio with integer arithmetic. Samples are converted to and from files using only
+ * integer arithmetic, saturating rather than wrapping when they don't fit.
+ */
+struct Q15
+{
+    int16_t value;
+    
+    bool operator== (const Q15& other) const { return value == other.value; }
+    bool operator!= (const Q15& other) const { return value != other.value; }
+};
+
+//=============================================================
+/** A fixed point sample in Q31 format, i.e. a 32-bit integer where 2147483648 represents 1.0
+ * (see Q15)
+ */
+struct Q31
+{
+    int32_t value;
+    
+    bool operator== (const Q31& other) const { return value == other.value; }
+    bool operator!= (const Q31& other) const { return value != other.value; }
+};
+
+//=============================================================
+/** Describes whether a sample type is one of the fixed point types, and if so, its size */
+template <typename T>
+struct FixedPointFormat
+{
+    static constexpr bool isFixedPoint = false;
+};
+
+template <>
+struct FixedPointFormat<Q15>
+{
+    static constexpr bool isFixedPoint = true;
+    static constexpr int numBits = 16;
+};
+
+template <>
+struct FixedPointFormat<Q31>
+{
+    static constexpr bool isFixedPoint = true;
+    static constexpr int numBits = 32;
+};
+
 
 #if defined (_MSC_VER)
     __pragma(warning (pop))
@@ -0,0 +1,183 @@
+//=======================================================================
+/** @file AudioFileWriterPool.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//=============================================================
+/** The state of a save running in the background */
+enum class SaveStatus
+{
+    Queued,         // waiting for a writer thread
+    Saving,         // being encoded and written
+    Saved,          // the file was saved
+    Failed,         // the file couldn't be saved
+    Cancelled       // the save was cancelled before the file was written
+};
+
+//=============================================================
+/** A handle to a save running in the background (see AudioFile::saveAsync()). Copies of a
+ * handle refer to the same save, and the save carries on if every handle is destroyed.
+ */
+class SaveHandle
+{
+public:
+    
+    //=============================================================
+    /** Creates a handle that doesn't refer to any save */
+    SaveHandle() = default;
+    
+    //=============================================================
+    /** @Returns true if the handle refers to a save */
+    bool isValid() const;
+    
+    /** @Returns the current state of the save */
+    SaveStatus getStatus() const;
+    
+    /** @Returns true once the save has been saved, has failed or has been cancelled, and its
+     * callback (if it has one) has returned. Within the callback itself this is already true
+     */
+    bool isFinished() const;
+    
+    //=============================================================
+    /** Waits until the save has finished (and its callback, if it has one, has returned).
+     * This can also be called from within the callback, which doesn't wait for itself.
+     * @Returns the state the save finished in
+     */
+    SaveStatus wait() const;
+    
+    /** Waits for up to a given time for the save to finish.
+     * @Returns true if the save has finished
+     */
+    bool waitFor (int milliseconds) const;
+    
+    /** Cancels the save. A save that hasn't started yet is cancelled straight away, and one that
+     * is being encoded stops before its file is written. A file that is already being written
+     * is still saved.
+     */
+    void cancel();
+    
+private:
+    
+    //=============================================================
+    friend class AudioFileWriterPool;
+    
+    struct State
+    {
+        mutable std::mutex lock;
+        std::condition_variable finished;
+        SaveStatus status {SaveStatus::Queued};
+        std::atomic<bool> cancelled {false};
+        std::function<void (SaveStatus)> onFinished;
+        std::thread::id callbackThread;
+        bool callbackReturned {false};
+    };
+    
+    static bool isFinished (SaveStatus status);
+    static bool hasFinished (const State& state);
+    static void finish (State& state, SaveStatus status);
+    
+    //=============================================================
+    std::shared_ptr<State> state;
+};
+
+//=============================================================
+/** A fixed number of threads that save files in the background, in the order they are added.
+ *
+ * AudioFile::saveAsync() uses a pool shared by the whole program unless you give it one.
+ * When a pool is destroyed, it finishes any saves that are still queued first.
+ */
+class AudioFileWriterPool
+{
+public:
+    
+    //=============================================================
+    /** A save to run on a writer thread. It is passed a flag that is set if the save is
+     * cancelled, and @Returns true if the file was saved
+     */
+    typedef std::function<bool (const std::atomic<bool>& cancelled)> SaveJob;
+    
+    //=============================================================
+    /** Constructor
+     * @param numThreads the number of files that can be saved at the same time
+     */
+    AudioFileWriterPool (int numThreads = 2);
+    
+    ~AudioFileWriterPool();
+    
+    AudioFileWriterPool (const AudioFileWriterPool&) = delete;
+    AudioFileWriterPool& operator= (const AudioFileWriterPool&) = delete;
+    
+    //=============================================================
+    /** @Returns the pool used by AudioFile::saveAsync() by default */
+    static AudioFileWriterPool& getDefaultPool();
+    
+    //=============================================================
+    /** Queues a save.
+     * @param onFinished an optional function to call with the final state of the save. It is
+     * called on the writer thread, or on the thread that cancels the save if it hadn't started
+     * @Returns a handle to the save
+     */
+    SaveHandle add (SaveJob job, std::function<void (SaveStatus)> onFinished = {});
+    
+    /** @Returns the number of writer threads */
+    int getNumThreads() const;
+    
+private:
+    
+    //=============================================================
+    struct QueuedSave
+    {
+        SaveJob job;
+        std::shared_ptr<SaveHandle::State> state;
+    };
+    
+    //=============================================================
+    void runWriterThread();
+    void runSave (QueuedSave& save);
+    
+    //=============================================================
+    std::mutex queueLock;
+    std::condition_variable queueChanged;
+    std::deque<QueuedSave> queue;
+    std::vector<std::thread> threads;
+    bool stopping {false};
+};
+
+#include "AudioFileWriterPool.inl"
@@ -0,0 +1,243 @@
+//=======================================================================
+/** @file AudioFileWriterPool.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <algorithm>
+
+//=============================================================
+inline bool SaveHandle::isValid() const
+{
+    return state != nullptr;
+}
+
+//=============================================================
+inline SaveStatus SaveHandle::getStatus() const
+{
+    if (state == nullptr)
+        return SaveStatus::Failed;
+    
+    std::lock_guard<std::mutex> guard (state->lock);
+    return state->status;
+}
+
+//=============================================================
+inline bool SaveHandle::isFinished() const
+{
+    if (state == nullptr)
+        return true;
+    
+    std::lock_guard<std::mutex> guard (state->lock);
+    return hasFinished (*state);
+}
+
+//=============================================================
+inline SaveStatus SaveHandle::wait() const
+{
+    if (state == nullptr)
+        return SaveStatus::Failed;
+    
+    std::unique_lock<std::mutex> guard (state->lock);
+    state->finished.wait (guard, [this] { return hasFinished (*state); });
+    return state->status;
+}
+
+//=============================================================
+inline bool SaveHandle::waitFor (int milliseconds) const
+{
+    if (state == nullptr)
+        return true;
+    
+    std::unique_lock<std::mutex> guard (state->lock);
+    return state->finished.wait_for (guard, std::chrono::milliseconds (milliseconds), [this] { return hasFinished (*state); });
+}
+
+//=============================================================
+inline void SaveHandle::cancel()
+{
+    if (state == nullptr)
+        return;
+    
+    bool cancelledBeforeStarting = false;
+    
+    {
+        std::lock_guard<std::mutex> guard (state->lock);
+        state->cancelled = true;
+        cancelledBeforeStarting = state->status == SaveStatus::Queued;
+    }
+    
+    // a save that hasn't started is finished here, and skipped when a writer thread reaches it
+    if (cancelledBeforeStarting)
+        finish (*state, SaveStatus::Cancelled);
+}
+
+//=============================================================
+inline bool SaveHandle::isFinished (SaveStatus status)
+{
+    return status == SaveStatus::Saved || status == SaveStatus::Failed || status == SaveStatus::Cancelled;
+}
+
+//=============================================================
+inline bool SaveHandle::hasFinished (const State& state)
+{
+    // other threads wait for the callback too, so they can rely on it having run, but the
+    // callback's own thread mustn't wait for itself
+    return isFinished (state.status) && (state.callbackReturned || state.callbackThread == std::this_thread::get_id());
+}
+
+//=============================================================
+inline void SaveHandle::finish (State& state, SaveStatus status)
+{
+    std::function<void (SaveStatus)> onFinished;
+    
+    // the final status is published before the callback is called, so the callback can query
+    // (or wait for) its own save
+    {
+        std::lock_guard<std::mutex> guard (state.lock);
+        std::swap (onFinished, state.onFinished);
+        state.status = status;
+        state.callbackThread = std::this_thread::get_id();
+    }
+    
+    if (onFinished)
+        onFinished (status);
+    
+    {
+        std::lock_guard<std::mutex> guard (state.lock);
+        state.callbackReturned = true;
+    }
+    
+    state.finished.notify_all();
+}
+
+//=============================================================
+inline AudioFileWriterPool::AudioFileWriterPool (int numThreads)
+{
+    for (int i = 0; i < std::max (numThreads, 1); i++)
+        threads.emplace_back ([this] { runWriterThread(); });
+}
+
+//=============================================================
+inline AudioFileWriterPool::~AudioFileWriterPool()
+{
+    {
+        std::lock_guard<std::mutex> guard (queueLock);
+        stopping = true;
+    }
+    
+    queueChanged.notify_all();
+    
+    for (auto& thread : threads)
+        thread.join();
+}
+
+//=============================================================
+inline AudioFileWriterPool& AudioFileWriterPool::getDefaultPool()
+{
+    static AudioFileWriterPool defaultPool;
+    return defaultPool;
+}
+
+//=============================================================
+inline SaveHandle AudioFileWriterPool::add (SaveJob job, std::function<void (SaveStatus)> onFinished)
+{
+    SaveHandle handle;
+    handle.state = std::make_shared<SaveHandle::State>();
+    handle.state->onFinished = std::move (onFinished);
+    
+    {
+        std::lock_guard<std::mutex> guard (queueLock);
+        queue.push_back ({std::move (job), handle.state});
+    }
+    
+    queueChanged.notify_one();
+    return handle;
+}
+
+//=============================================================
+inline int AudioFileWriterPool::getNumThreads() const
+{
+    return static_cast<int> (threads.size());
+}
+
+//=============================================================
+inline void AudioFileWriterPool::runWriterThread()
+{
+    for (;;)
+    {
+        QueuedSave save;
+        
+        {
+            std::unique_lock<std::mutex> guard (queueLock);
+            queueChanged.wait (guard, [this] { return stopping || ! queue.empty(); });
+            
+            // queued saves are still finished when the pool is stopping
+            if (queue.empty())
+                return;
+            
+            save = std::move (queue.front());
+            queue.pop_front();
+        }
+        
+        runSave (save);
+    }
+}
+
+//=============================================================
+inline void AudioFileWriterPool::runSave (QueuedSave& save)
+{
+    SaveHandle::State& state = *save.state;
+    
+    {
+        std::lock_guard<std::mutex> guard (state.lock);
+        
+        // it was cancelled while it was queued
+        if (state.cancelled || state.status != SaveStatus::Queued)
+            return;
+        
+        state.status = SaveStatus::Saving;
+    }
+    
+    bool saved = false;
+    
+    try
+    {
+        saved = save.job (state.cancelled);
+    }
+    catch (...)
+    {
+        saved = false;
+    }
+    
+    if (saved)
+        SaveHandle::finish (state, SaveStatus::Saved);
+    else
+        SaveHandle::finish (state, state.cancelled ? SaveStatus::Cancelled : SaveStatus::Failed);
+}
@@ -4,6 +4,7 @@
 #include "AudioSampleConverter.h"
 #include <iostream>
 #include <fstream>
+#include <streambuf>
 #include <string>
 
 
@@ -19,6 +20,12 @@ public:
      */
     bool loadHeader(std::string filePath);
 
+    /** Loads only the header information from the data of an audio file in memory. The data
+     *  must hold the whole file, so the header can check that all of the samples are there.
+     *  @Returns true if the header was successfully loaded.
+     */
+    bool loadHeaderFromMemory(const uint8_t* fileData, size_t fileSize);
+
     /** @Returns the sample rate */
     uint32_t getSampleRate() const;
 
@@ -28,21 +35,52 @@ public:
     /** @Returns the bit depth of each sample */
     int getBitDepth() const;
 
+    /** @Returns the number of samples per channel */
+    int getNumSamplesPerChannel() const;
+
+    /** @Returns the length in seconds of the audio file based on the number of samples and sample rate */
+    double getLengthInSeconds() const;
+
+    /** @Returns true if the samples in the file are stored as floating point values */
+    bool isFloatingPointFormat() const;
+
     /** @Returns the audio file format */
     AudioFileFormat getAudioFormat() const;
 
+    /** @Returns the position in the file of the first byte of the first sample. The samples
+     *  follow as interleaved frames of getNumChannels() * getBitDepth() / 8 bytes.
+     */
+    uint64_t getSampleDataOffset() const;
+
+    /** @Returns the contents of the file's iXML chunk, or an empty string if it doesn't have one */
+    std::string getIXMLChunk() const;
+
     /** Sets whether the library should log error messages to the console. By default, this is true */
     void shouldLogErrorsToConsole(bool logErrors);
 
 private:
+    // Reads file data in memory through a stream, without copying it
+    struct MemoryBuffer : public std::streambuf
+    {
+        MemoryBuffer(const uint8_t* data, size_t size);
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override;
+        pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+    };
+
     // Header parsing functions
-    bool decodeWaveFileHeader(std::ifstream& file);
-    bool decodeAiffFileHeader(std::ifstream& file);
+    bool decodeHeader(std::istream& file, const std::string& description);
+    bool decodeWaveFileHeader(std::istream& file);
+    bool decodeAiffFileHeader(std::istream& file, bool isCompressed);
+    bool checkSampleDataFitsInFile(std::istream& file);
 
     // Member variables
     uint32_t sampleRate;
     int bitDepth;
     int numChannels;
+    int numSamplesPerChannel;
+    bool floatingPointFormat;
+    uint64_t sampleDataOffset;
+    std::string iXMLChunk;
     AudioFileFormat audioFileFormat;
     bool logErrorsToConsole{ true };
 
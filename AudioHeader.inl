@@ -6,6 +6,9 @@ AudioHeader<T>::AudioHeader()
     sampleRate = 0;
     bitDepth = 0;
     numChannels = 0;
+    numSamplesPerChannel = 0;
+    floatingPointFormat = false;
+    sampleDataOffset = 0;
     audioFileFormat = AudioFileFormat::NotLoaded;
 }
 
@@ -20,18 +23,41 @@ bool AudioHeader<T>::loadHeader(std::string filePath)
         return false;
     }
 
+    return decodeHeader(file, ": " + filePath);
+}
+
+template <class T>
+bool AudioHeader<T>::loadHeaderFromMemory(const uint8_t* fileData, size_t fileSize)
+{
+    MemoryBuffer buffer(fileData, fileSize);
+    std::istream file(&buffer);
+
+    return decodeHeader(file, "");
+}
+
+template <class T>
+bool AudioHeader<T>::decodeHeader(std::istream& file, const std::string& description)
+{
     // Read the first 12 bytes to determine the file format
     char header[12];
     file.read(header, 12);
     if (file.gcount() != 12)
     {
-        reportError("ERROR: Couldn't read the file header: " + filePath);
+        reportError("ERROR: Couldn't read the file header" + description);
         return false;
     }
 
     std::string chunkID(header, 4);
     std::string format(header + 8, 4);
 
+    sampleRate = 0;
+    bitDepth = 0;
+    numChannels = 0;
+    numSamplesPerChannel = 0;
+    floatingPointFormat = false;
+    sampleDataOffset = 0;
+    iXMLChunk.clear();
+
     if (chunkID == "RIFF" && format == "WAVE")
     {
         audioFileFormat = AudioFileFormat::Wave;
@@ -40,56 +66,72 @@ bool AudioHeader<T>::loadHeader(std::string filePath)
     else if (chunkID == "FORM" && (format == "AIFF" || format == "AIFC"))
     {
         audioFileFormat = AudioFileFormat::Aiff;
-        return decodeAiffFileHeader(file);
+        return decodeAiffFileHeader(file, format == "AIFC");
     }
     else
     {
-        reportError("ERROR: Unknown or unsupported audio file format: " + filePath);
+        reportError("ERROR: Unknown or unsupported audio file format" + description);
         return false;
     }
 }
 
 template <class T>
-bool AudioHeader<T>::decodeWaveFileHeader(std::ifstream& file)
+bool AudioHeader<T>::decodeWaveFileHeader(std::istream& file)
 {
-    // Read chunks until 'fmt ' chunk is found
-    while (file.good() && !file.eof())
+    bool foundFormatChunk = false;
+    bool foundDataChunk = false;
+    uint16_t audioFormat = 0;
+    uint32_t numBytesPerSecond = 0;
+    uint16_t numBytesPerBlock = 0;
+    uint32_t dataChunkSize = 0;
+
+    // Read every chunk header, skipping over the sample data
+    while (file.good())
     {
-        char chunkId[4];
-        uint32_t chunkSize = 0;
+        char chunkHeader[8];
+        file.read(chunkHeader, 8);
 
-        file.read(chunkId, 4);
-        file.read(reinterpret_cast<char*>(&chunkSize), 4);
+        if (file.gcount() != 8)
+            break;
 
-        if (file.gcount() != 4)
-        {
-            reportError("ERROR: Unexpected end of file while reading chunk size");
-            return false;
-        }
+        std::string id(chunkHeader, 4);
+        uint32_t chunkSize = fourBytesToInt(chunkHeader + 4, Endianness::LittleEndian);
 
-        std::string id(chunkId, 4);
-
-        if (id == "fmt ")
+        if (id == "fmt " && !foundFormatChunk)
         {
             // Read the 'fmt ' chunk
-            char* fmtChunkData = new char[chunkSize];
-            file.read(fmtChunkData, chunkSize);
+            char fmtChunkData[16];
+            file.read(fmtChunkData, 16);
 
-            if (file.gcount() != static_cast<std::streamsize>(chunkSize))
+            if (chunkSize < 16 || file.gcount() != 16)
             {
-                delete[] fmtChunkData;
                 reportError("ERROR: Couldn't read 'fmt ' chunk");
                 return false;
             }
 
             // Parse 'fmt ' chunk
-            uint16_t audioFormat = twoBytesToInt(fmtChunkData, Endianness::LittleEndian);
+            audioFormat = twoBytesToInt(fmtChunkData, Endianness::LittleEndian);
             numChannels = twoBytesToInt(fmtChunkData + 2, Endianness::LittleEndian);
             sampleRate = fourBytesToInt(fmtChunkData + 4, Endianness::LittleEndian);
+            numBytesPerSecond = fourBytesToInt(fmtChunkData + 8, Endianness::LittleEndian);
+            numBytesPerBlock = twoBytesToInt(fmtChunkData + 12, Endianness::LittleEndian);
             bitDepth = twoBytesToInt(fmtChunkData + 14, Endianness::LittleEndian);
 
-            delete[] fmtChunkData;
-            break; // We have the necessary header info
+            foundFormatChunk = true;
+            file.seekg(chunkSize - 16, std::ios::cur);
+        }
+        else if (id == "data" && !foundDataChunk)
+        {
+            sampleDataOffset = static_cast<uint64_t>(file.tellg());
+            dataChunkSize = chunkSize;
+            foundDataChunk = true;
+            file.seekg(chunkSize, std::ios::cur);
+        }
+        else if (id == "iXML" && iXMLChunk.empty())
+        {
+            iXMLChunk.resize(chunkSize);
+            file.read(&iXMLChunk[0], chunkSize);
+            iXMLChunk.resize(static_cast<size_t>(file.gcount()));
         }
         else
         {
@@ -98,76 +140,213 @@ bool AudioHeader<T>::decodeWaveFileHeader(std::ifstream& file)
         }
     }
 
-    if (numChannels == 0 || sampleRate == 0 || bitDepth == 0)
+    file.clear();
+
+    if (!foundFormatChunk || !foundDataChunk)
     {
-        reportError("ERROR: Failed to read WAV header information");
+        reportError("ERROR: this doesn't seem to be a valid .WAV file");
         return false;
     }
 
-    return true;
+    if (audioFormat != WavAudioFormat::PCM && audioFormat != WavAudioFormat::IEEEFloat && audioFormat != WavAudioFormat::Extensible)
+    {
+        reportError("ERROR: this .WAV file is encoded in a format that this library does not support at present");
+        return false;
+    }
+
+    if (numChannels < 1 || numChannels > 128)
+    {
+        reportError("ERROR: this WAV file seems to be an invalid number of channels (or corrupted?)");
+        return false;
+    }
+
+    if (bitDepth != 8 && bitDepth != 16 && bitDepth != 24 && bitDepth != 32)
+    {
+        reportError("ERROR: this file has a bit depth that is not 8, 16, 24 or 32 bits");
+        return false;
+    }
+
+    if (numBytesPerSecond != static_cast<uint32_t>((numChannels * sampleRate * bitDepth) / 8) || numBytesPerBlock != (numChannels * bitDepth / 8))
+    {
+        reportError("ERROR: the header data in this WAV file seems to be inconsistent");
+        return false;
+    }
+
+    numSamplesPerChannel = static_cast<int>(dataChunkSize / numBytesPerBlock);
+    floatingPointFormat = bitDepth == 32 && audioFormat == WavAudioFormat::IEEEFloat;
+
+    return checkSampleDataFitsInFile(file);
 }
 
 template <class T>
-bool AudioHeader<T>::decodeAiffFileHeader(std::ifstream& file)
+bool AudioHeader<T>::decodeAiffFileHeader(std::istream& file, bool isCompressed)
 {
-    return false;
-    // // Read chunks until 'COMM' chunk is found
-    // while (file.good() && !file.eof())
-    // {
-    //     char chunkId[4];
-    //     uint32_t chunkSize = 0;
+    bool foundCommChunk = false;
+    bool foundSoundDataChunk = false;
+    uint32_t soundDataChunkSize = 0;
 
-    //     file.read(chunkId, 4);
-    //     file.read(reinterpret_cast<char*>(&chunkSize), 4);
+    // Read every chunk header, skipping over the sample data
+    while (file.good())
+    {
+        char chunkHeader[8];
+        file.read(chunkHeader, 8);
 
-    //     if (file.gcount() != 4)
-    //     {
-    //         reportError("ERROR: Unexpected end of file while reading chunk size");
-    //         return false;
-    //     }
+        if (file.gcount() != 8)
+            break;
 
-    //     std::string id(chunkId, 4);
+        std::string id(chunkHeader, 4);
+        uint32_t chunkSize = fourBytesToInt(chunkHeader + 4, Endianness::BigEndian);
 
-    //     if (id == "COMM")
-    //     {
-    //         // Read the 'COMM' chunk
-    //         chunkSize = _byteswap_ulong(chunkSize); // AIFF uses big endian
-    //         char* commChunkData = new char[chunkSize];
-    //         file.read(commChunkData, chunkSize);
+        if (id == "COMM" && !foundCommChunk)
+        {
+            // Read the 'COMM' chunk
+            char commChunkData[18];
+            file.read(commChunkData, 18);
 
-    //         if (file.gcount() != static_cast<std::streamsize>(chunkSize))
-    //         {
-    //             delete[] commChunkData;
-    //             reportError("ERROR: Couldn't read 'COMM' chunk");
-    //             return false;
-    //         }
+            if (chunkSize < 18 || file.gcount() != 18)
+            {
+                reportError("ERROR: Couldn't read 'COMM' chunk");
+                return false;
+            }
 
-    //         // Parse 'COMM' chunk
-    //         numChannels = twoBytesToInt(commChunkData, Endianness::BigEndian);
-    //         uint32_t numSampleFrames = fourBytesToInt(commChunkData + 2, Endianness::BigEndian);
-    //         bitDepth = twoBytesToInt(commChunkData + 6, Endianness::BigEndian);
+            // Parse 'COMM' chunk
+            numChannels = static_cast<int16_t>(twoBytesToInt(commChunkData, Endianness::BigEndian));
+            numSamplesPerChannel = static_cast<int32_t>(fourBytesToInt(commChunkData + 2, Endianness::BigEndian));
+            bitDepth = static_cast<int16_t>(twoBytesToInt(commChunkData + 6, Endianness::BigEndian));
 
-    //         // For sample rate, AIFF uses 80-bit extended precision, which is complex to parse
-    //         // For simplicity, you might set a default value or implement proper parsing
+            // AIFF stores the sample rate as an 80-bit extended precision number, so
+            // (like AudioFile) we look it up in a table of common sample rates
+            for (auto& it : aiffSampleRateTable)
+            {
+                if (memcmp(commChunkData + 8, it.second.data(), 10) == 0)
+                    sampleRate = it.first;
+            }
 
-    //         delete[] commChunkData;
-    //         break; // We have the necessary header info
-    //     }
-    //     else
-    //     {
-    //         // Skip this chunk
-    //         chunkSize = _byteswap_ulong(chunkSize); // AIFF uses big endian
-    //         file.seekg(chunkSize, std::ios::cur);
-    //     }
-    // }
+            foundCommChunk = true;
+            file.seekg(chunkSize - 18, std::ios::cur);
+        }
+        else if (id == "SSND" && !foundSoundDataChunk)
+        {
+            char soundDataHeader[8];
+            file.read(soundDataHeader, 8);
 
-    // if (numChannels == 0 || bitDepth == 0)
-    // {
-    //     reportError("ERROR: Failed to read AIFF header information");
-    //     return false;
-    // }
+            if (chunkSize < 8 || file.gcount() != 8)
+            {
+                reportError("ERROR: Couldn't read 'SSND' chunk");
+                return false;
+            }
+
+            uint32_t offset = fourBytesToInt(soundDataHeader, Endianness::BigEndian);
+            sampleDataOffset = static_cast<uint64_t>(file.tellg()) + offset;
+            soundDataChunkSize = chunkSize;
+            foundSoundDataChunk = true;
+            file.seekg(chunkSize - 8, std::ios::cur);
+        }
+        else if (id == "iXML" && iXMLChunk.empty())
+        {
+            iXMLChunk.resize(chunkSize);
+            file.read(&iXMLChunk[0], chunkSize);
+            iXMLChunk.resize(static_cast<size_t>(file.gcount()));
+        }
+        else
+        {
+            // Skip this chunk
+            file.seekg(chunkSize, std::ios::cur);
+        }
+    }
+
+    file.clear();
+
+    if (!foundCommChunk || !foundSoundDataChunk)
+    {
+        reportError("ERROR: this doesn't seem to be a valid AIFF file");
+        return false;
+    }
 
-    // return true;
+    if (sampleRate == 0)
+    {
+        reportError("ERROR: this AIFF file has an unsupported sample rate");
+        return false;
+    }
+
+    if (numChannels < 1 || numChannels > 2)
+    {
+        reportError("ERROR: this AIFF file seems to be neither mono nor stereo (perhaps multi-track, or corrupted?)");
+        return false;
+    }
+
+    if (bitDepth != 8 && bitDepth != 16 && bitDepth != 24 && bitDepth != 32)
+    {
+        reportError("ERROR: this file has a bit depth that is not 8, 16, 24 or 32 bits");
+        return false;
+    }
+
+    if (numSamplesPerChannel < 0 || soundDataChunkSize - 8 != static_cast<uint64_t>(numSamplesPerChannel) * numChannels * (bitDepth / 8))
+    {
+        reportError("ERROR: the metadatafor this file doesn't seem right");
+        return false;
+    }
+
+    floatingPointFormat = bitDepth == 32 && isCompressed;
+
+    return checkSampleDataFitsInFile(file);
+}
+
+template <class T>
+bool AudioHeader<T>::checkSampleDataFitsInFile(std::istream& file)
+{
+    if (bitDepth > static_cast<int>(sizeof(T) * 8))
+    {
+        std::string message = "ERROR: you are trying to read a ";
+        message += std::to_string(bitDepth);
+        message += "-bit file using a ";
+        message += std::to_string(sizeof(T) * 8);
+        message += "-bit sample type";
+        reportError(message);
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    uint64_t numSampleDataBytes = static_cast<uint64_t>(numSamplesPerChannel) * numChannels * (bitDepth / 8);
+
+    if (sampleDataOffset + numSampleDataBytes > fileSize)
+    {
+        reportError("ERROR: read file error as the metadata indicates more samples than there are in the file data");
+        return false;
+    }
+
+    return true;
+}
+
+template <class T>
+AudioHeader<T>::MemoryBuffer::MemoryBuffer(const uint8_t* data, size_t size)
+{
+    char* start = const_cast<char*>(reinterpret_cast<const char*>(data));
+    setg(start, start, start + size);
+}
+
+template <class T>
+typename AudioHeader<T>::MemoryBuffer::pos_type AudioHeader<T>::MemoryBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode)
+{
+    off_type position = offset;
+
+    if (direction == std::ios_base::cur)
+        position += gptr() - eback();
+    else if (direction == std::ios_base::end)
+        position += egptr() - eback();
+
+    if (position < 0 || position > egptr() - eback())
+        return pos_type(off_type(-1));
+
+    setg(eback(), eback() + position, egptr());
+    return pos_type(position);
+}
+
+template <class T>
+typename AudioHeader<T>::MemoryBuffer::pos_type AudioHeader<T>::MemoryBuffer::seekpos(pos_type position, std::ios_base::openmode mode)
+{
+    return seekoff(off_type(position), std::ios_base::beg, mode);
 }
 
 template <class T>
@@ -188,12 +367,42 @@ int AudioHeader<T>::getBitDepth() const
     return bitDepth;
 }
 
+template <class T>
+int AudioHeader<T>::getNumSamplesPerChannel() const
+{
+    return numSamplesPerChannel;
+}
+
+template <class T>
+double AudioHeader<T>::getLengthInSeconds() const
+{
+    return sampleRate == 0 ? 0. : static_cast<double>(numSamplesPerChannel) / static_cast<double>(sampleRate);
+}
+
+template <class T>
+bool AudioHeader<T>::isFloatingPointFormat() const
+{
+    return floatingPointFormat;
+}
+
 template <class T>
 AudioFileFormat AudioHeader<T>::getAudioFormat() const
 {
     return audioFileFormat;
 }
 
+template <class T>
+uint64_t AudioHeader<T>::getSampleDataOffset() const
+{
+    return sampleDataOffset;
+}
+
+template <class T>
+std::string AudioHeader<T>::getIXMLChunk() const
+{
+    return iXMLChunk;
+}
+
 template <class T>
 void AudioHeader<T>::shouldLogErrorsToConsole(bool logErrors)
 {
@@ -0,0 +1,161 @@
+//=======================================================================
+/** @file AudioResampler.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioBufferView.h"
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+//=============================================================
+/** Converts audio from one sample rate to another with a polyphase windowed-sinc filter.
+ *
+ * The ratio of the two rates is reduced to a fraction L / M (e.g. 160 / 147 from 44.1 to
+ * 48kHz), and every output sample is the dot product of a run of input samples with one of
+ * L precomputed sets of filter coefficients. The coefficient tables are shared between all
+ * resamplers with the same ratio. Ratios with very large values of L (e.g. 44100 to 44101Hz)
+ * use a table with fewer phases, interpolating between neighbouring phases.
+ *
+ * The filter has 96 taps per output sample when upsampling (more when downsampling), a
+ * Kaiser window and a cutoff just below the lower of the two Nyquist frequencies, which
+ * keeps the passband flat to about 0.88 of that frequency and rejects aliases and images
+ * by at least 80dB. The output is aligned with the input, i.e. it has no delay.
+ *
+ * Audio can be resampled in blocks of any size: pass each block of input to process(), and
+ * call flush() once the input has ended to get the last few output samples. Only floating
+ * point samples can be resampled.
+ */
+template <class T>
+class AudioResampler
+{
+    static_assert (std::is_floating_point<T>::value, "AudioResampler only supports floating point samples");
+    
+public:
+    
+    //=============================================================
+    /** Constructor. Both sample rates must be above zero */
+    AudioResampler (uint32_t sourceSampleRate, uint32_t targetSampleRate, int numChannels);
+    
+    //=============================================================
+    /** @Returns the sample rate of the input */
+    uint32_t getSourceSampleRate() const;
+    
+    /** @Returns the sample rate of the output */
+    uint32_t getTargetSampleRate() const;
+    
+    /** @Returns the number of audio channels */
+    int getNumChannels() const;
+    
+    /** @Returns the number of input samples each output sample is computed from */
+    int getNumTaps() const;
+    
+    //=============================================================
+    /** @Returns the number of samples (per channel) that a whole stream of a given length
+     * resamples to, once it has been flushed
+     */
+    int64_t getNumOutputSamples (int64_t numInputSamples) const;
+    
+    /** @Returns the most samples (per channel) that the next call to process() can produce
+     * from a given number of input samples, or that flush() can produce if this is 0
+     */
+    int getMaxNumOutputSamples (int numInputSamples) const;
+    
+    //=============================================================
+    /** Resamples a block of input. Output is produced as soon as there is enough input for it,
+     * so it lags the input by a few samples until flush() is called.
+     * @param output where to write the output, which should have room for
+     * getMaxNumOutputSamples() samples. Any output that doesn't fit is kept for the next call
+     * @Returns the number of samples per channel written to the output
+     */
+    int process (const AudioBufferView<const T>& input, const AudioBufferView<T>& output);
+    
+    /** Produces the output that is still to come once the input has ended. If the output
+     * doesn't have room for all of it, call this again for the rest.
+     * @Returns the number of samples per channel written to the output
+     */
+    int flush (const AudioBufferView<T>& output);
+    
+    /** Clears any input that is waiting to be resampled, ready to start a new stream */
+    void reset();
+    
+private:
+    
+    //=============================================================
+    /** Filter coefficients for every phase, each set padded to a whole number of vectors */
+    struct FilterTable
+    {
+        int numPhases = 0;
+        int numTaps = 0;
+        int numTapsBeforeSample = 0;
+        bool interpolatesPhases = false;
+        std::vector<T> coefficients;
+    };
+    
+    //=============================================================
+    static constexpr int numTapsPerSide = 48;
+    static constexpr int numAccumulators = 8;
+    static constexpr uint64_t maximumNumPhases = 4096;
+    static constexpr double kaiserBeta = 9.;
+    static constexpr double cutoff = 0.94;
+    static constexpr int numSamplesPerBlock = 1024;
+    
+    //=============================================================
+    static std::shared_ptr<const FilterTable> getFilterTable (uint64_t upFactor, uint64_t downFactor);
+    static std::shared_ptr<const FilterTable> createFilterTable (uint64_t upFactor, uint64_t downFactor);
+    static double besselI0 (double x);
+    static T computeSample (const T* coefficients, const T* input, int numTaps);
+    
+    //=============================================================
+    int produceOutput (int maxNumOutputSamples, const AudioBufferView<T>& output);
+    void appendSilence (int64_t newPendingEnd);
+    int64_t getLastInputIndex (uint64_t outputIndex) const;
+    
+    //=============================================================
+    uint32_t sourceRate;
+    uint32_t targetRate;
+    int numChannels;
+    uint64_t upFactor;
+    uint64_t downFactor;
+    std::shared_ptr<const FilterTable> table;
+    
+    std::vector<std::vector<T>> pending;
+    int64_t pendingStart {0};
+    int64_t pendingEnd {0};
+    int64_t numInputSamples {0};
+    uint64_t nextOutputIndex {0};
+    
+    std::vector<int64_t> blockStarts;
+    std::vector<const T*> blockCoefficients;
+    std::vector<T> blockFractions;
+};
+
+#include "AudioResampler.inl"
@@ -0,0 +1,382 @@
+//=======================================================================
+/** @file AudioResampler.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <utility>
+
+//=============================================================
+template <class T>
+AudioResampler<T>::AudioResampler (uint32_t sourceSampleRate, uint32_t targetSampleRate, int numChannelsToResample)
+ :  sourceRate (sourceSampleRate),
+    targetRate (targetSampleRate),
+    numChannels (numChannelsToResample)
+{
+    assert (sourceSampleRate > 0 && targetSampleRate > 0);
+    
+    uint64_t divisor = std::gcd (static_cast<uint64_t> (std::max (sourceRate, 1u)), static_cast<uint64_t> (std::max (targetRate, 1u)));
+    upFactor = std::max (targetRate, 1u) / divisor;
+    downFactor = std::max (sourceRate, 1u) / divisor;
+    table = getFilterTable (upFactor, downFactor);
+    
+    pending.resize (static_cast<size_t> (std::max (numChannels, 0)));
+    blockStarts.resize (numSamplesPerBlock);
+    blockCoefficients.resize (numSamplesPerBlock);
+    blockFractions.resize (numSamplesPerBlock);
+    
+    reset();
+}
+
+//=============================================================
+template <class T>
+uint32_t AudioResampler<T>::getSourceSampleRate() const
+{
+    return sourceRate;
+}
+
+//=============================================================
+template <class T>
+uint32_t AudioResampler<T>::getTargetSampleRate() const
+{
+    return targetRate;
+}
+
+//=============================================================
+template <class T>
+int AudioResampler<T>::getNumChannels() const
+{
+    return numChannels;
+}
+
+//=============================================================
+template <class T>
+int AudioResampler<T>::getNumTaps() const
+{
+    return table->numTaps;
+}
+
+//=============================================================
+template <class T>
+int64_t AudioResampler<T>::getNumOutputSamples (int64_t numInput) const
+{
+    // rounded up, so every input sample is covered by the output
+    return static_cast<int64_t> ((static_cast<uint64_t> (numInput) * upFactor + downFactor - 1) / downFactor);
+}
+
+//=============================================================
+template <class T>
+int AudioResampler<T>::getMaxNumOutputSamples (int numInput) const
+{
+    uint64_t numAvailable = static_cast<uint64_t> (pendingEnd - pendingStart + numInput);
+    return static_cast<int> ((numAvailable * upFactor) / downFactor + 1);
+}
+
+//=============================================================
+template <class T>
+int AudioResampler<T>::process (const AudioBufferView<const T>& input, const AudioBufferView<T>& output)
+{
+    assert (input.getNumChannels() == numChannels && output.getNumChannels() == numChannels);
+    
+    int numInput = input.getNumSamples();
+    
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        std::vector<T>& channelSamples = pending[channel];
+        size_t numPending = channelSamples.size();
+        channelSamples.resize (numPending + static_cast<size_t> (numInput));
+        
+        const T* source = input.getPointer (channel);
+        std::ptrdiff_t stride = input.getSampleStride();
+        
+        for (int i = 0; i < numInput; i++)
+            channelSamples[numPending + i] = source[i * stride];
+    }
+    
+    pendingEnd += numInput;
+    numInputSamples += numInput;
+    
+    return produceOutput (output.getNumSamples(), output);
+}
+
+//=============================================================
+template <class T>
+int AudioResampler<T>::flush (const AudioBufferView<T>& output)
+{
+    int64_t numOutputSamples = getNumOutputSamples (numInputSamples);
+    
+    if (static_cast<int64_t> (nextOutputIndex) >= numOutputSamples)
+        return 0;
+    
+    // the input after the end of the stream is silence
+    appendSilence (getLastInputIndex (static_cast<uint64_t> (numOutputSamples - 1)) + 1);
+    
+    int64_t numRemaining = numOutputSamples - static_cast<int64_t> (nextOutputIndex);
+    return produceOutput (static_cast<int> (std::min<int64_t> (numRemaining, output.getNumSamples())), output);
+}
+
+//=============================================================
+template <class T>
+void AudioResampler<T>::reset()
+{
+    // the input before the start of the stream is silence
+    pendingStart = -(table->numTapsBeforeSample - 1);
+    pendingEnd = pendingStart;
+    numInputSamples = 0;
+    nextOutputIndex = 0;
+    
+    for (auto& channelSamples : pending)
+        channelSamples.clear();
+    
+    appendSilence (0);
+}
+
+//=============================================================
+template <class T>
+int AudioResampler<T>::produceOutput (int maxNumOutputSamples, const AudioBufferView<T>& output)
+{
+    const FilterTable& filter = *table;
+    int numTaps = filter.numTaps;
+    int numOutput = 0;
+    
+    while (numOutput < maxNumOutputSamples)
+    {
+        // work out which input samples and coefficients a block of output samples needs...
+        int numInBlock = 0;
+        
+        while (numInBlock < numSamplesPerBlock && numOutput + numInBlock < maxNumOutputSamples)
+        {
+            uint64_t outputIndex = nextOutputIndex + static_cast<uint64_t> (numInBlock);
+            
+            if (getLastInputIndex (outputIndex) >= pendingEnd)
+                break;
+            
+            uint64_t position = outputIndex * downFactor;
+            uint64_t remainder = position % upFactor;
+            blockStarts[numInBlock] = static_cast<int64_t> (position / upFactor) - (filter.numTapsBeforeSample - 1) - pendingStart;
+            
+            if (filter.interpolatesPhases)
+            {
+                uint64_t scaledPhase = remainder * static_cast<uint64_t> (filter.numPhases);
+                uint64_t phase = scaledPhase / upFactor;
+                blockCoefficients[numInBlock] = filter.coefficients.data() + phase * static_cast<uint64_t> (numTaps);
+                blockFractions[numInBlock] = static_cast<T> (static_cast<double> (scaledPhase % upFactor) / static_cast<double> (upFactor));
+            }
+            else
+            {
+                blockCoefficients[numInBlock] = filter.coefficients.data() + remainder * static_cast<uint64_t> (numTaps);
+            }
+            
+            numInBlock++;
+        }
+        
+        if (numInBlock == 0)
+            break;
+        
+        // ...then compute the block, a channel at a time
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            const T* channelSamples = pending[channel].data();
+            T* destination = output.getPointer (channel, numOutput);
+            std::ptrdiff_t stride = output.getSampleStride();
+            
+            if (filter.interpolatesPhases)
+            {
+                for (int i = 0; i < numInBlock; i++)
+                {
+                    const T* source = channelSamples + blockStarts[i];
+                    T first = computeSample (blockCoefficients[i], source, numTaps);
+                    T second = computeSample (blockCoefficients[i] + numTaps, source, numTaps);
+                    destination[i * stride] = first + (second - first) * blockFractions[i];
+                }
+            }
+            else
+            {
+                for (int i = 0; i < numInBlock; i++)
+                    destination[i * stride] = computeSample (blockCoefficients[i], channelSamples + blockStarts[i], numTaps);
+            }
+        }
+        
+        numOutput += numInBlock;
+        nextOutputIndex += static_cast<uint64_t> (numInBlock);
+    }
+    
+    // drop the input that no later output sample needs
+    int64_t firstNeeded = static_cast<int64_t> ((nextOutputIndex * downFactor) / upFactor) - (filter.numTapsBeforeSample - 1);
+    int64_t numToDrop = std::min (firstNeeded, pendingEnd) - pendingStart;
+    
+    if (numToDrop > 0)
+    {
+        for (auto& channelSamples : pending)
+            channelSamples.erase (channelSamples.begin(), channelSamples.begin() + numToDrop);
+        
+        pendingStart += numToDrop;
+    }
+    
+    return numOutput;
+}
+
+//=============================================================
+template <class T>
+void AudioResampler<T>::appendSilence (int64_t newPendingEnd)
+{
+    if (newPendingEnd <= pendingEnd)
+        return;
+    
+    for (auto& channelSamples : pending)
+        channelSamples.resize (channelSamples.size() + static_cast<size_t> (newPendingEnd - pendingEnd), T());
+    
+    pendingEnd = newPendingEnd;
+}
+
+//=============================================================
+template <class T>
+int64_t AudioResampler<T>::getLastInputIndex (uint64_t outputIndex) const
+{
+    return static_cast<int64_t> ((outputIndex * downFactor) / upFactor) - table->numTapsBeforeSample + table->numTaps;
+}
+
+//=============================================================
+template <class T>
+T AudioResampler<T>::computeSample (const T* coefficients, const T* input, int numTaps)
+{
+    // separate running sums let the compiler use vector instructions, as it isn't allowed
+    // to change the order of floating point additions in a single sum
+    T sums[numAccumulators] = {};
+    
+    for (int i = 0; i < numTaps; i += numAccumulators)
+        for (int k = 0; k < numAccumulators; k++)
+            sums[k] += coefficients[i + k] * input[i + k];
+    
+    T sum = T();
+    
+    for (int k = 0; k < numAccumulators; k++)
+        sum += sums[k];
+    
+    return sum;
+}
+
+//=============================================================
+template <class T>
+std::shared_ptr<const typename AudioResampler<T>::FilterTable> AudioResampler<T>::getFilterTable (uint64_t upFactor, uint64_t downFactor)
+{
+    static std::mutex tablesLock;
+    static std::map<std::pair<uint64_t, uint64_t>, std::weak_ptr<const FilterTable>> tables;
+    
+    std::lock_guard<std::mutex> guard (tablesLock);
+    auto& cachedTable = tables[{upFactor, downFactor}];
+    auto filterTable = cachedTable.lock();
+    
+    if (filterTable == nullptr)
+    {
+        filterTable = createFilterTable (upFactor, downFactor);
+        cachedTable = filterTable;
+    }
+    
+    return filterTable;
+}
+
+//=============================================================
+template <class T>
+std::shared_ptr<const typename AudioResampler<T>::FilterTable> AudioResampler<T>::createFilterTable (uint64_t upFactor, uint64_t downFactor)
+{
+    auto filterTable = std::make_shared<FilterTable>();
+    
+    // when downsampling, the filter's cutoff (relative to the input) is lower, so it needs
+    // proportionally more taps to keep the same sharpness
+    double bandwidth = std::min (1., static_cast<double> (upFactor) / static_cast<double> (downFactor));
+    int numTapsBeforeSample = static_cast<int> (std::ceil (numTapsPerSide / bandwidth));
+    int numTaps = 2 * numTapsBeforeSample;
+    
+    filterTable->numTapsBeforeSample = numTapsBeforeSample;
+    filterTable->numTaps = ((numTaps + numAccumulators - 1) / numAccumulators) * numAccumulators;
+    filterTable->interpolatesPhases = upFactor > maximumNumPhases;
+    filterTable->numPhases = static_cast<int> (filterTable->interpolatesPhases ? maximumNumPhases : upFactor);
+    
+    // with interpolation, there is one more set of coefficients, for a phase of exactly 1
+    int numSets = filterTable->numPhases + (filterTable->interpolatesPhases ? 1 : 0);
+    filterTable->coefficients.assign (static_cast<size_t> (numSets) * filterTable->numTaps, T());
+    
+    const double pi = 3.14159265358979323846;
+    double frequency = cutoff * bandwidth;
+    double windowScale = 1. / besselI0 (kaiserBeta);
+    std::vector<double> set (static_cast<size_t> (numTaps));
+    
+    for (int phase = 0; phase < numSets; phase++)
+    {
+        // the output sample lies this far after the input sample just before it
+        double offset = static_cast<double> (phase) / filterTable->numPhases;
+        double sum = 0.;
+        
+        for (int tap = 0; tap < numTaps; tap++)
+        {
+            double distance = offset - (tap - (numTapsBeforeSample - 1));
+            double x = distance / numTapsBeforeSample;
+            double window = std::abs (x) < 1. ? besselI0 (kaiserBeta * std::sqrt (1. - x * x)) * windowScale : 0.;
+            double sinc = distance == 0. ? 1. : std::sin (pi * frequency * distance) / (pi * frequency * distance);
+            
+            set[tap] = sinc * window;
+            sum += set[tap];
+        }
+        
+        // each set has a gain of exactly 1 for DC
+        T* coefficients = filterTable->coefficients.data() + static_cast<size_t> (phase) * filterTable->numTaps;
+        
+        for (int tap = 0; tap < numTaps; tap++)
+            coefficients[tap] = static_cast<T> (set[tap] / sum);
+    }
+    
+    return filterTable;
+}
+
+//=============================================================
+template <class T>
+double AudioResampler<T>::besselI0 (double x)
+{
+    // the power series converges quickly for the values a Kaiser window uses
+    double sum = 1.;
+    double term = 1.;
+    
+    for (int k = 1; k < 50; k++)
+    {
+        term *= (x / (2. * k)) * (x / (2. * k));
+        sum += term;
+        
+        if (term < sum * 1e-17)
+            break;
+    }
+    
+    return sum;
+}
@@ -0,0 +1,273 @@
+//=======================================================================
+/** @file AudioSampleBuffer.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+//=============================================================
+/** The samples of one audio channel.
+ *
+ * This behaves like a std::vector<T>, except that copies share the same samples until one
+ * of them is modified, so copying a channel is cheap however long the audio is. A channel
+ * gets its own copy of the samples the first time you use a non-const function (such as the
+ * non-const operator[], data() or begin()) while they are shared, so code that only reads
+ * audio should do so through a const reference.
+ *
+ * Once a non-const function has handed out a reference, pointer or iterator that can write
+ * to the samples, the channel stops sharing them: copying it copies the samples straight
+ * away. So a copy always behaves as an independent value, even if you carry on writing
+ * through a pointer you took earlier. When you have finished with those pointers, call
+ * releaseWritableReferences() to let the channel be shared again. Only the first non-const
+ * call after a copy does any work, so writing through operator[] in a loop costs one
+ * predictable branch per sample (taking data() once avoids even that).
+ *
+ * As with a std::vector, a channel may be read from several threads at once, but shouldn't
+ * be copied on one thread while another calls one of its non-const functions.
+ */
+template <class T>
+class AudioSampleChannel
+{
+public:
+    
+    //=============================================================
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+    
+    //=============================================================
+    /** Creates an empty channel */
+    AudioSampleChannel();
+    
+    /** Creates a channel holding a number of samples with a given value */
+    explicit AudioSampleChannel (size_t numSamples, T value = T());
+    
+    /** Creates a channel from a list of samples */
+    AudioSampleChannel (std::initializer_list<T> values);
+    
+    /** Creates a channel by copying the samples from a vector */
+    AudioSampleChannel (const std::vector<T>& samples);
+    
+    /** Creates a channel by taking over the samples of a vector */
+    AudioSampleChannel (std::vector<T>&& samples);
+    
+    /** Creates a channel that shares the samples of another channel, unless something can
+     * still write to the other channel's samples, in which case they are copied
+     */
+    AudioSampleChannel (const AudioSampleChannel& other);
+    AudioSampleChannel (AudioSampleChannel&& other) noexcept;
+    
+    AudioSampleChannel& operator= (const AudioSampleChannel& other);
+    AudioSampleChannel& operator= (AudioSampleChannel&& other) noexcept;
+    
+    ~AudioSampleChannel();
+    
+    //=============================================================
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+    
+    void reserve (size_t numSamples);
+    void resize (size_t numSamples);
+    void resize (size_t numSamples, const T& value);
+    void assign (size_t numSamples, const T& value);
+    void clear();
+    void shrink_to_fit();
+    void push_back (const T& sample);
+    
+    //=============================================================
+    T& operator[] (size_t index);
+    const T& operator[] (size_t index) const;
+    
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+    
+    T* data();
+    const T* data() const;
+    
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    
+    //=============================================================
+    /** Allows the samples to be read as a std::vector */
+    operator const std::vector<T>& () const;
+    
+    /** @Returns true if this channel and another one currently share the same samples */
+    bool isSharedWith (const AudioSampleChannel& other) const;
+    
+    /** Tells the channel that nothing will use the references, pointers or iterators its
+     * non-const functions have handed out any more, so that copies can share its samples
+     * again. Writing through one of them after this may change the samples of a copy.
+     */
+    void releaseWritableReferences();
+    
+    bool operator== (const AudioSampleChannel& other) const;
+    bool operator!= (const AudioSampleChannel& other) const;
+    
+private:
+    
+    //=============================================================
+    template <class> friend class AudioSampleBuffer;
+    
+    /** Samples shared by one or more channels, which count their owners themselves so that a
+     * channel can tell (with acquire ordering) when it is the only one left
+     */
+    struct Storage
+    {
+        Storage (std::vector<T>&& samplesToTake);
+        
+        std::vector<T> samples;
+        std::atomic<size_t> numOwners {1};
+    };
+    
+    //=============================================================
+    Storage* shareStorage() const;
+    void release();
+    bool isShared() const;
+    
+    const std::vector<T>& getSamples() const;
+    std::vector<T>& getUniqueSamples();
+    std::vector<T>& getWritableSamples();
+    std::vector<T>& makeWritable();
+    
+    //=============================================================
+    Storage* storage {nullptr};
+    
+    // true once something outside the channel may be able to write to the samples, after which
+    // they aren't shared until releaseWritableReferences() is called. This is only ever true for
+    // samples with one owner
+    bool hasWritableReferences {false};
+};
+
+//=============================================================
+/** A multi-channel buffer of audio samples, accessed by channel and then by sample index, i.e:
+ *
+ *      buffer[channel][sampleIndex]
+ *
+ * This behaves like a std::vector<std::vector<T>>, but its channels are AudioSampleChannel
+ * objects, so copying a buffer doesn't copy any samples until they are modified. An AudioFile
+ * keeps its samples in plain vectors, so to share them, move them into a buffer:
+ *
+ *      AudioSampleBuffer<float> buffer (std::move (audioFile.samples));
+ *
+ * and set them back with audioFile.setAudioBuffer (buffer), which copies them.
+ */
+template <class T>
+class AudioSampleBuffer
+{
+public:
+    
+    //=============================================================
+    typedef AudioSampleChannel<T> value_type;
+    typedef size_t size_type;
+    typedef AudioSampleChannel<T>& reference;
+    typedef const AudioSampleChannel<T>& const_reference;
+    typedef typename std::vector<AudioSampleChannel<T>>::iterator iterator;
+    typedef typename std::vector<AudioSampleChannel<T>>::const_iterator const_iterator;
+    
+    //=============================================================
+    /** Creates a buffer with no channels */
+    AudioSampleBuffer();
+    
+    /** Creates a buffer with a number of empty channels */
+    explicit AudioSampleBuffer (size_t numChannels);
+    
+    /** Creates a buffer from a list of channels */
+    AudioSampleBuffer (std::initializer_list<AudioSampleChannel<T>> channelList);
+    
+    /** Creates a buffer by copying the samples from a vector of vectors */
+    AudioSampleBuffer (const std::vector<std::vector<T>>& buffer);
+    
+    /** Creates a buffer by taking over the samples of a vector of vectors */
+    AudioSampleBuffer (std::vector<std::vector<T>>&& buffer);
+    
+    //=============================================================
+    size_t size() const;
+    bool empty() const;
+    
+    void reserve (size_t numChannels);
+    void resize (size_t numChannels);
+    void clear();
+    void push_back (const AudioSampleChannel<T>& channel);
+    void push_back (AudioSampleChannel<T>&& channel);
+    
+    //=============================================================
+    AudioSampleChannel<T>& operator[] (size_t channel);
+    const AudioSampleChannel<T>& operator[] (size_t channel) const;
+    
+    AudioSampleChannel<T>& front();
+    const AudioSampleChannel<T>& front() const;
+    AudioSampleChannel<T>& back();
+    const AudioSampleChannel<T>& back() const;
+    
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    
+    //=============================================================
+    /** Makes channels whose samples are identical (bit for bit) share a single copy of
+     * those samples, e.g. the two channels of a dual mono file. Each channel still behaves
+     * as if it had its own samples, so modifying one of them copies it again. Channels that
+     * something can still write to (see AudioSampleChannel) are left as they are.
+     * @Returns the number of channels that now share their samples with an earlier channel
+     */
+    int shareIdenticalChannels();
+    
+    /** Calls AudioSampleChannel::releaseWritableReferences() on every channel */
+    void releaseWritableReferences();
+    
+    //=============================================================
+    /** Copies the samples into a vector of vectors */
+    operator std::vector<std::vector<T>>() const;
+    
+    bool operator== (const AudioSampleBuffer& other) const;
+    bool operator!= (const AudioSampleBuffer& other) const;
+    
+private:
+    
+    //=============================================================
+    std::vector<AudioSampleChannel<T>> channels;
+};
+
+#include "AudioSampleBuffer.inl"
@@ -0,0 +1,649 @@
+//=======================================================================
+/** @file AudioSampleBuffer.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::Storage::Storage (std::vector<T>&& samplesToTake)
+ : samples (std::move (samplesToTake))
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel()
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel (size_t numSamples, T value)
+ : storage (new Storage (std::vector<T> (numSamples, value)))
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel (std::initializer_list<T> values)
+ : storage (new Storage (std::vector<T> (values)))
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel (const std::vector<T>& samples)
+ : storage (new Storage (std::vector<T> (samples)))
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel (std::vector<T>&& samples)
+ : storage (new Storage (std::move (samples)))
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel (const AudioSampleChannel& other)
+ : storage (other.shareStorage())
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::AudioSampleChannel (AudioSampleChannel&& other) noexcept
+ : storage (other.storage),
+   hasWritableReferences (other.hasWritableReferences)
+{
+    other.storage = nullptr;
+    other.hasWritableReferences = false;
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>& AudioSampleChannel<T>::operator= (const AudioSampleChannel& other)
+{
+    if (this != &other)
+    {
+        Storage* newStorage = other.shareStorage();
+        release();
+        storage = newStorage;
+    }
+    
+    return *this;
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>& AudioSampleChannel<T>::operator= (AudioSampleChannel&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        storage = other.storage;
+        hasWritableReferences = other.hasWritableReferences;
+        other.storage = nullptr;
+        other.hasWritableReferences = false;
+    }
+    
+    return *this;
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::~AudioSampleChannel()
+{
+    release();
+}
+
+//=============================================================
+template <class T>
+size_t AudioSampleChannel<T>::size() const
+{
+    return storage != nullptr ? storage->samples.size() : 0;
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleChannel<T>::empty() const
+{
+    return size() == 0;
+}
+
+//=============================================================
+template <class T>
+size_t AudioSampleChannel<T>::capacity() const
+{
+    return storage != nullptr ? storage->samples.capacity() : 0;
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::reserve (size_t numSamples)
+{
+    getUniqueSamples().reserve (numSamples);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::resize (size_t numSamples)
+{
+    if (numSamples != size())
+        getUniqueSamples().resize (numSamples);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::resize (size_t numSamples, const T& value)
+{
+    if (numSamples != size())
+        getUniqueSamples().resize (numSamples, value);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::assign (size_t numSamples, const T& value)
+{
+    // no point copying samples that are about to be overwritten
+    if (isShared())
+        release();
+    
+    getUniqueSamples().assign (numSamples, value);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::clear()
+{
+    if (isShared())
+        release();
+    else if (storage != nullptr)
+        storage->samples.clear();
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::shrink_to_fit()
+{
+    if (capacity() != size())
+        getUniqueSamples().shrink_to_fit();
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::push_back (const T& sample)
+{
+    getUniqueSamples().push_back (sample);
+}
+
+//=============================================================
+template <class T>
+T& AudioSampleChannel<T>::operator[] (size_t index)
+{
+    return getWritableSamples()[index];
+}
+
+//=============================================================
+template <class T>
+const T& AudioSampleChannel<T>::operator[] (size_t index) const
+{
+    assert (index < size());
+    return getSamples()[index];
+}
+
+//=============================================================
+template <class T>
+T& AudioSampleChannel<T>::front()
+{
+    return getWritableSamples().front();
+}
+
+//=============================================================
+template <class T>
+const T& AudioSampleChannel<T>::front() const
+{
+    assert (! empty());
+    return getSamples().front();
+}
+
+//=============================================================
+template <class T>
+T& AudioSampleChannel<T>::back()
+{
+    return getWritableSamples().back();
+}
+
+//=============================================================
+template <class T>
+const T& AudioSampleChannel<T>::back() const
+{
+    assert (! empty());
+    return getSamples().back();
+}
+
+//=============================================================
+template <class T>
+T* AudioSampleChannel<T>::data()
+{
+    return getWritableSamples().data();
+}
+
+//=============================================================
+template <class T>
+const T* AudioSampleChannel<T>::data() const
+{
+    return storage != nullptr ? storage->samples.data() : nullptr;
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::iterator AudioSampleChannel<T>::begin()
+{
+    return getWritableSamples().begin();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::iterator AudioSampleChannel<T>::end()
+{
+    return getWritableSamples().end();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::const_iterator AudioSampleChannel<T>::begin() const
+{
+    return getSamples().begin();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::const_iterator AudioSampleChannel<T>::end() const
+{
+    return getSamples().end();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::const_iterator AudioSampleChannel<T>::cbegin() const
+{
+    return getSamples().begin();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::const_iterator AudioSampleChannel<T>::cend() const
+{
+    return getSamples().end();
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>::operator const std::vector<T>& () const
+{
+    return getSamples();
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleChannel<T>::isSharedWith (const AudioSampleChannel& other) const
+{
+    return storage != nullptr && storage == other.storage;
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::releaseWritableReferences()
+{
+    hasWritableReferences = false;
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleChannel<T>::operator== (const AudioSampleChannel& other) const
+{
+    return isSharedWith (other) || getSamples() == other.getSamples();
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleChannel<T>::operator!= (const AudioSampleChannel& other) const
+{
+    return ! (*this == other);
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleChannel<T>::Storage* AudioSampleChannel<T>::shareStorage() const
+{
+    if (storage == nullptr)
+        return nullptr;
+    
+    // a pointer or reference to these samples may still be used to write to them,
+    // so a copy has to have samples of its own
+    if (hasWritableReferences)
+        return new Storage (std::vector<T> (storage->samples));
+    
+    storage->numOwners.fetch_add (1, std::memory_order_relaxed);
+    return storage;
+}
+
+//=============================================================
+template <class T>
+void AudioSampleChannel<T>::release()
+{
+    // the last owner must see every other owner's use of the samples before deleting them
+    if (storage != nullptr && storage->numOwners.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        delete storage;
+    
+    storage = nullptr;
+    hasWritableReferences = false;
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleChannel<T>::isShared() const
+{
+    // acquire ordering means that once other owners have let go of the samples, anything they
+    // did with them happens before this channel starts writing to them
+    return storage != nullptr && ! hasWritableReferences && storage->numOwners.load (std::memory_order_acquire) > 1;
+}
+
+//=============================================================
+template <class T>
+const std::vector<T>& AudioSampleChannel<T>::getSamples() const
+{
+    static const std::vector<T> noSamples;
+    return storage != nullptr ? storage->samples : noSamples;
+}
+
+//=============================================================
+template <class T>
+std::vector<T>& AudioSampleChannel<T>::getUniqueSamples()
+{
+    if (storage == nullptr)
+    {
+        storage = new Storage (std::vector<T>());
+    }
+    else if (isShared())
+    {
+        Storage* copy = new Storage (std::vector<T> (storage->samples));
+        release();
+        storage = copy;
+    }
+    
+    return storage->samples;
+}
+
+//=============================================================
+template <class T>
+std::vector<T>& AudioSampleChannel<T>::getWritableSamples()
+{
+    // once the samples have been handed out they can't be shared, so there's nothing to check
+    if (hasWritableReferences)
+        return storage->samples;
+    
+    return makeWritable();
+}
+
+//=============================================================
+template <class T>
+std::vector<T>& AudioSampleChannel<T>::makeWritable()
+{
+    std::vector<T>& samples = getUniqueSamples();
+    hasWritableReferences = true;
+    return samples;
+}
+
+//=============================================================
+template <class T>
+AudioSampleBuffer<T>::AudioSampleBuffer()
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleBuffer<T>::AudioSampleBuffer (size_t numChannels)
+ : channels (numChannels)
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleBuffer<T>::AudioSampleBuffer (std::initializer_list<AudioSampleChannel<T>> channelList)
+ : channels (channelList)
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleBuffer<T>::AudioSampleBuffer (const std::vector<std::vector<T>>& buffer)
+ : channels (buffer.begin(), buffer.end())
+{
+}
+
+//=============================================================
+template <class T>
+AudioSampleBuffer<T>::AudioSampleBuffer (std::vector<std::vector<T>>&& buffer)
+{
+    channels.reserve (buffer.size());
+    
+    for (auto& channel : buffer)
+        channels.emplace_back (std::move (channel));
+}
+
+//=============================================================
+template <class T>
+size_t AudioSampleBuffer<T>::size() const
+{
+    return channels.size();
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleBuffer<T>::empty() const
+{
+    return channels.empty();
+}
+
+//=============================================================
+template <class T>
+void AudioSampleBuffer<T>::reserve (size_t numChannels)
+{
+    channels.reserve (numChannels);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleBuffer<T>::resize (size_t numChannels)
+{
+    channels.resize (numChannels);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleBuffer<T>::clear()
+{
+    channels.clear();
+}
+
+//=============================================================
+template <class T>
+void AudioSampleBuffer<T>::push_back (const AudioSampleChannel<T>& channel)
+{
+    channels.push_back (channel);
+}
+
+//=============================================================
+template <class T>
+void AudioSampleBuffer<T>::push_back (AudioSampleChannel<T>&& channel)
+{
+    channels.push_back (std::move (channel));
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>& AudioSampleBuffer<T>::operator[] (size_t channel)
+{
+    return channels[channel];
+}
+
+//=============================================================
+template <class T>
+const AudioSampleChannel<T>& AudioSampleBuffer<T>::operator[] (size_t channel) const
+{
+    return channels[channel];
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>& AudioSampleBuffer<T>::front()
+{
+    return channels.front();
+}
+
+//=============================================================
+template <class T>
+const AudioSampleChannel<T>& AudioSampleBuffer<T>::front() const
+{
+    return channels.front();
+}
+
+//=============================================================
+template <class T>
+AudioSampleChannel<T>& AudioSampleBuffer<T>::back()
+{
+    return channels.back();
+}
+
+//=============================================================
+template <class T>
+const AudioSampleChannel<T>& AudioSampleBuffer<T>::back() const
+{
+    return channels.back();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleBuffer<T>::iterator AudioSampleBuffer<T>::begin()
+{
+    return channels.begin();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleBuffer<T>::iterator AudioSampleBuffer<T>::end()
+{
+    return channels.end();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleBuffer<T>::const_iterator AudioSampleBuffer<T>::begin() const
+{
+    return channels.begin();
+}
+
+//=============================================================
+template <class T>
+typename AudioSampleBuffer<T>::const_iterator AudioSampleBuffer<T>::end() const
+{
+    return channels.end();
+}
+
+//=============================================================
+template <class T>
+int AudioSampleBuffer<T>::shareIdenticalChannels()
+{
+    int numSharedChannels = 0;
+    
+    for (size_t i = 1; i < channels.size(); i++)
+    {
+        const AudioSampleChannel<T>& channel = channels[i];
+        
+        // replacing the samples of a channel that something can write to would leave that
+        // pointer or reference dangling
+        if (channel.hasWritableReferences)
+            continue;
+        
+        for (size_t j = 0; j < i; j++)
+        {
+            const AudioSampleChannel<T>& earlierChannel = channels[j];
+            
+            if (earlierChannel.hasWritableReferences)
+                continue;
+            
+            // compare bytes rather than values, so that e.g. 0.0 and -0.0 are not treated as equal
+            bool identical = channel.isSharedWith (earlierChannel)
+                             || (channel.size() == earlierChannel.size()
+                                 && (channel.empty() || std::memcmp (channel.data(), earlierChannel.data(), channel.size() * sizeof (T)) == 0));
+            
+            if (identical)
+            {
+                channels[i] = channels[j];
+                numSharedChannels++;
+                break;
+            }
+        }
+    }
+    
+    return numSharedChannels;
+}
+
+//=============================================================
+template <class T>
+void AudioSampleBuffer<T>::releaseWritableReferences()
+{
+    for (auto& channel : channels)
+        channel.releaseWritableReferences();
+}
+
+//=============================================================
+template <class T>
+AudioSampleBuffer<T>::operator std::vector<std::vector<T>>() const
+{
+    return std::vector<std::vector<T>> (channels.begin(), channels.end());
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleBuffer<T>::operator== (const AudioSampleBuffer& other) const
+{
+    return channels == other.channels;
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleBuffer<T>::operator!= (const AudioSampleBuffer& other) const
+{
+    return ! (*this == other);
+}
@@ -47,6 +47,7 @@
 #include <iterator>
 #include <algorithm>
 #include <limits>
+#include <cstddef>
 
 // disable some warnings on Windows
 #if defined (_MSC_VER)
@@ -103,9 +104,92 @@ struct AudioSampleConverter
     /** Convert a an audio sample to a 32-bit signed integer */
     static int32_t sampleToThirtyTwoBitInt (T sample);
     
+    //=============================================================
+    /** Converts runs of values at once. Each of these gives exactly the same results as calling
+     * the matching single sample function above for every sample, but as the conversion is chosen
+     * when the code is compiled, the compiler can vectorise contiguous runs.
+     * @param sourceStride the number of values from one source value to the next
+     * @param destinationStride the number of values from one destination value to the next
+     */
+    static void signedBytesToSamples (const int8_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    static void samplesToSignedBytes (const T* source, int8_t* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    
+    static void unsignedBytesToSamples (const uint8_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    static void samplesToUnsignedBytes (const T* source, uint8_t* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    
+    static void sixteenBitIntsToSamples (const int16_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    static void samplesToSixteenBitInts (const T* source, int16_t* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    
+    static void twentyFourBitIntsToSamples (const int32_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    static void samplesToTwentyFourBitInts (const T* source, int32_t* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    
+    static void thirtyTwoBitIntsToSamples (const int32_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    static void samplesToThirtyTwoBitInts (const T* source, int32_t* destination, int numSamples, std::ptrdiff_t sourceStride = 1, std::ptrdiff_t destinationStride = 1);
+    
+    //=============================================================
+    /** Converts a run of samples, stored as they are in the sample data of a WAV or AIFF file,
+     * to audio samples. The byte order, and the way 8-bit and floating point samples are stored,
+     * depend on the file format.
+     * @param source the first byte of the first sample
+     * @param numBytesBetweenSamples the distance from one sample to the next, e.g. the size of
+     * a frame when reading one channel of interleaved audio
+     * @param isFloatingPoint true if 32-bit samples are floating point values
+     */
+    static void decodeSamples (const uint8_t* source, size_t numBytesBetweenSamples, int numSamples, int bitDepth, AudioFileFormat format, bool isFloatingPoint, T* destination);
+    
+    /** Converts a run of audio samples to the way they are stored in the sample data of a WAV
+     * or AIFF file (the reverse of decodeSamples())
+     * @param numBytesBetweenSamples the distance from one sample to the next in the destination
+     * @param isFloatingPoint true to store 32-bit samples as floating point values
+     */
+    static void encodeSamples (const T* source, int numSamples, int bitDepth, AudioFileFormat format, bool isFloatingPoint, uint8_t* destination, size_t numBytesBetweenSamples);
+    
+    //=============================================================
+    /** Decodes frames of interleaved samples into separate channels. Rather than decoding one
+     * channel at a time, the frames are worked through in small tiles, so however many channels
+     * there are, the data being read and written stays in the cache.
+     * @param channels the numChannels channels to decode, where destinations[i] receives channel
+     * channels[i]. If this is nullptr, destinations[i] receives channel i
+     */
+    static void decodeFrames (const uint8_t* frames, int numChannelsInFrames, int numFrames, int bitDepth, AudioFileFormat format, bool isFloatingPoint,
+                              const int* channels, int numChannels, T* const* destinations);
+    
+    /** Encodes separate channels into frames of interleaved samples, a tile at a time (see decodeFrames()) */
+    static void encodeFrames (const T* const* sources, int numChannels, int numFrames, int bitDepth, AudioFileFormat format, bool isFloatingPoint, uint8_t* frames);
+    
+    /** The number of bytes of interleaved frames that decodeFrames() and encodeFrames() work through at a time */
+    static constexpr int numBytesPerTile = 16384;
+    
+    //=============================================================
+    /** @Returns true if samples of type T are stored in a file exactly as they are in memory,
+     * e.g. int16_t samples in a 16-bit WAV file or floats in a 32-bit floating point WAV file,
+     * on a little-endian machine. These samples are simply copied by decodeSamples() and
+     * encodeSamples().
+     */
+    static bool isStoredAsIs (int bitDepth, AudioFileFormat format, bool isFloatingPoint);
+    
+    /** @Returns true if this machine stores numbers with their least significant byte first */
+    static bool isLittleEndianMachine();
+    
     //=============================================================
     /** Helper clamp function to enforce ranges */
     static T clamp (T v1, T minValue, T maxValue);
+    
+private:
+    
+    //=============================================================
+    /** Converts an integer code from one bit depth to another, rounding and saturating when it loses bits */
+    static int64_t rescaleCode (int64_t code, int numBits, int newNumBits);
+    
+    static T codeToFixedPoint (int64_t code, int numCodeBits);
+    static int64_t fixedPointToCode (T sample, int numCodeBits);
+    static T floatToSample (float sample);
+    static float sampleToFloat (T sample);
+    
+    //=============================================================
+    template <typename SourceType, typename DestinationType, typename ConversionFunction>
+    static void convertRun (const SourceType* source, DestinationType* destination, int numSamples,
+                            std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride, ConversionFunction convert);
 };
 
 
@@ -46,6 +46,8 @@
 #include <iterator>
 #include <algorithm>
 #include <limits>
+#include <cstddef>
+#include <cmath>
 
 // disable some warnings on Windows
 #if defined (_MSC_VER)
@@ -79,13 +81,17 @@ typename std::make_unsigned<SignedType>::type convertSignedToUnsigned (SignedTyp
 template <class T>
 T AudioSampleConverter<T>::thirtyTwoBitIntToSample (int32_t sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return codeToFixedPoint (sample, 32);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         return static_cast<T> (sample) / static_cast<T> (std::numeric_limits<int32_t>::max());
     }
-    else if (std::numeric_limits<T>::is_integer)
+    else if constexpr (std::numeric_limits<T>::is_integer)
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<T> (sample);
         else
             return static_cast<T> (clamp (static_cast<T> (sample + 2147483648), 0, 4294967295));
@@ -96,12 +102,16 @@ T AudioSampleConverter<T>::thirtyTwoBitIntToSample (int32_t sample)
 template <class T>
 int32_t AudioSampleConverter<T>::sampleToThirtyTwoBitInt (T sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return static_cast<int32_t> (fixedPointToCode (sample, 32));
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         // multiplying a float by a the max int32_t is problematic because
         // of roundng errors which can cause wrong values to come out, so
         // we use a different implementation here compared to other types
-        if (std::is_same<T, float>::value)
+        if constexpr (std::is_same<T, float>::value)
         {
             if (sample >= 1.f)
                 return std::numeric_limits<int32_t>::max();
@@ -117,7 +127,7 @@ int32_t AudioSampleConverter<T>::sampleToThirtyTwoBitInt (T sample)
     }
     else
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<int32_t> (clamp (sample, -2147483648LL, 2147483647LL));
         else
             return static_cast<int32_t> (clamp (sample, 0, 4294967295) - 2147483648);
@@ -128,13 +138,17 @@ int32_t AudioSampleConverter<T>::sampleToThirtyTwoBitInt (T sample)
 template <class T>
 T AudioSampleConverter<T>::twentyFourBitIntToSample (int32_t sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return codeToFixedPoint (sample, 24);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         return static_cast<T> (sample) / static_cast<T> (8388607.);
     }
-    else if (std::numeric_limits<T>::is_integer)
+    else if constexpr (std::numeric_limits<T>::is_integer)
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<T> (clamp (sample, SignedInt24_Min, SignedInt24_Max));
         else
             return static_cast<T> (clamp (sample + 8388608, UnsignedInt24_Min, UnsignedInt24_Max));
@@ -145,14 +159,18 @@ T AudioSampleConverter<T>::twentyFourBitIntToSample (int32_t sample)
 template <class T>
 int32_t AudioSampleConverter<T>::sampleToTwentyFourBitInt (T sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return static_cast<int32_t> (fixedPointToCode (sample, 24));
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         sample = clamp (sample, -1., 1.);
         return static_cast<int32_t> (sample * 8388607.);
     }
     else
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<int32_t> (clamp (sample, SignedInt24_Min, SignedInt24_Max));
         else
             return static_cast<int32_t> (clamp (sample, UnsignedInt24_Min, UnsignedInt24_Max) + SignedInt24_Min);
@@ -163,13 +181,17 @@ int32_t AudioSampleConverter<T>::sampleToTwentyFourBitInt (T sample)
 template <class T>
 T AudioSampleConverter<T>::sixteenBitIntToSample (int16_t sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return codeToFixedPoint (sample, 16);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         return static_cast<T> (sample) / static_cast<T> (32767.);
     }
-    else if (std::numeric_limits<T>::is_integer)
+    else if constexpr (std::numeric_limits<T>::is_integer)
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<T> (sample);
         else
             return static_cast<T> (convertSignedToUnsigned<int16_t> (sample));
@@ -180,14 +202,18 @@ T AudioSampleConverter<T>::sixteenBitIntToSample (int16_t sample)
 template <class T>
 int16_t AudioSampleConverter<T>::sampleToSixteenBitInt (T sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return static_cast<int16_t> (fixedPointToCode (sample, 16));
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         sample = clamp (sample, -1., 1.);
         return static_cast<int16_t> (sample * 32767.);
     }
     else
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<int16_t> (clamp (sample, SignedInt16_Min, SignedInt16_Max));
         else
             return static_cast<int16_t> (clamp (sample, UnsignedInt16_Min, UnsignedInt16_Max) + SignedInt16_Min);
@@ -198,7 +224,11 @@ int16_t AudioSampleConverter<T>::sampleToSixteenBitInt (T sample)
 template <class T>
 uint8_t AudioSampleConverter<T>::sampleToUnsignedByte (T sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return static_cast<uint8_t> (fixedPointToCode (sample, 8) + 128);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         sample = clamp (sample, -1., 1.);
         sample = (sample + 1.) / 2.;
@@ -206,7 +236,7 @@ uint8_t AudioSampleConverter<T>::sampleToUnsignedByte (T sample)
     }
     else
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<uint8_t> (clamp (sample, -128, 127) + 128);
         else
             return static_cast<uint8_t> (clamp (sample, 0, 255));
@@ -217,14 +247,18 @@ uint8_t AudioSampleConverter<T>::sampleToUnsignedByte (T sample)
 template <class T>
 int8_t AudioSampleConverter<T>::sampleToSignedByte (T sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return static_cast<int8_t> (fixedPointToCode (sample, 8));
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         sample = clamp (sample, -1., 1.);
         return static_cast<int8_t> (sample * (T)0x7F);
     }
     else
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<int8_t> (clamp (sample, -128, 127));
         else
             return static_cast<int8_t> (clamp (sample, 0, 255) - 128);
@@ -235,13 +269,17 @@ int8_t AudioSampleConverter<T>::sampleToSignedByte (T sample)
 template <class T>
 T AudioSampleConverter<T>::unsignedByteToSample (uint8_t sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return codeToFixedPoint (sample - 128, 8);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         return static_cast<T> (sample - 128) / static_cast<T> (127.);
     }
-    else if (std::numeric_limits<T>::is_integer)
+    else if constexpr (std::numeric_limits<T>::is_integer)
     {
-        if (std::is_unsigned<T>::value)
+        if constexpr (std::is_unsigned<T>::value)
             return static_cast<T> (sample);
         else
             return static_cast<T> (sample - 128);
@@ -252,19 +290,460 @@ T AudioSampleConverter<T>::unsignedByteToSample (uint8_t sample)
 template <class T>
 T AudioSampleConverter<T>::signedByteToSample (int8_t sample)
 {
-    if (std::is_floating_point<T>::value)
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        return codeToFixedPoint (sample, 8);
+    }
+    else if constexpr (std::is_floating_point<T>::value)
     {
         return static_cast<T> (sample) / static_cast<T> (127.);
     }
-    else if (std::numeric_limits<T>::is_integer)
+    else if constexpr (std::numeric_limits<T>::is_integer)
     {
-        if (std::is_signed<T>::value)
+        if constexpr (std::is_signed<T>::value)
             return static_cast<T> (sample);
         else
             return static_cast<T> (convertSignedToUnsigned<int8_t> (sample));
     }
 }
 
+//=============================================================
+template <class T>
+template <typename SourceType, typename DestinationType, typename ConversionFunction>
+void AudioSampleConverter<T>::convertRun (const SourceType* source, DestinationType* destination, int numSamples,
+                                          std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride, ConversionFunction convert)
+{
+    // contiguous runs get their own loop, which is the one the compiler can vectorise
+    if (sourceStride == 1 && destinationStride == 1)
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i] = convert (source[i]);
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i * destinationStride] = convert (source[i * sourceStride]);
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::signedBytesToSamples (const int8_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return signedByteToSample (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::samplesToSignedBytes (const T* source, int8_t* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return sampleToSignedByte (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::unsignedBytesToSamples (const uint8_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return unsignedByteToSample (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::samplesToUnsignedBytes (const T* source, uint8_t* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return sampleToUnsignedByte (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::sixteenBitIntsToSamples (const int16_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return sixteenBitIntToSample (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::samplesToSixteenBitInts (const T* source, int16_t* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return sampleToSixteenBitInt (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::twentyFourBitIntsToSamples (const int32_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return twentyFourBitIntToSample (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::samplesToTwentyFourBitInts (const T* source, int32_t* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return sampleToTwentyFourBitInt (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::thirtyTwoBitIntsToSamples (const int32_t* source, T* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return thirtyTwoBitIntToSample (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::samplesToThirtyTwoBitInts (const T* source, int32_t* destination, int numSamples, std::ptrdiff_t sourceStride, std::ptrdiff_t destinationStride)
+{
+    convertRun (source, destination, numSamples, sourceStride, destinationStride, [] (auto sample) { return sampleToThirtyTwoBitInt (sample); });
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::decodeSamples (const uint8_t* source, size_t numBytesBetweenSamples, int numSamples, int bitDepth, AudioFileFormat format, bool isFloatingPoint, T* destination)
+{
+    if (isStoredAsIs (bitDepth, format, isFloatingPoint))
+    {
+        if (numBytesBetweenSamples == sizeof (T))
+        {
+            memcpy (destination, source, numSamples * sizeof (T));
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; i++)
+                memcpy (destination + i, source + i * numBytesBetweenSamples, sizeof (T));
+        }
+        
+        return;
+    }
+    
+    auto decode = [&] (auto bytesToSample)
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i] = bytesToSample (source + i * numBytesBetweenSamples);
+    };
+    
+    if (format == AudioFileFormat::Aiff)
+    {
+        if (bitDepth == 8)
+        {
+            decode ([] (const uint8_t* b) { return signedByteToSample (static_cast<int8_t> (b[0])); });
+        }
+        else if (bitDepth == 16)
+        {
+            decode ([] (const uint8_t* b) { return sixteenBitIntToSample (static_cast<int16_t> ((b[0] << 8) | b[1])); });
+        }
+        else if (bitDepth == 24)
+        {
+            decode ([] (const uint8_t* b)
+            {
+                int32_t sampleAsInt = (b[0] << 16) | (b[1] << 8) | b[2];
+                
+                if (sampleAsInt & 0x800000) //  if the 24th bit is set, this is a negative number in 24-bit world
+                    sampleAsInt = sampleAsInt | ~0xFFFFFF; // so make sure sign is extended to the 32 bit float
+                
+                return twentyFourBitIntToSample (sampleAsInt);
+            });
+        }
+        else if (bitDepth == 32 && isFloatingPoint)
+        {
+            decode ([] (const uint8_t* b)
+            {
+                int32_t sampleAsInt = (b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+                float sampleAsFloat;
+                memcpy (&sampleAsFloat, &sampleAsInt, sizeof (float));
+                return floatToSample (sampleAsFloat);
+            });
+        }
+        else if (bitDepth == 32)
+        {
+            decode ([] (const uint8_t* b) { return thirtyTwoBitIntToSample ((b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3]); });
+        }
+        else
+        {
+            assert (false);
+        }
+    }
+    else
+    {
+        if (bitDepth == 8)
+        {
+            decode ([] (const uint8_t* b) { return unsignedByteToSample (b[0]); });
+        }
+        else if (bitDepth == 16)
+        {
+            decode ([] (const uint8_t* b) { return sixteenBitIntToSample (static_cast<int16_t> ((b[1] << 8) | b[0])); });
+        }
+        else if (bitDepth == 24)
+        {
+            decode ([] (const uint8_t* b)
+            {
+                int32_t sampleAsInt = (b[2] << 16) | (b[1] << 8) | b[0];
+                
+                if (sampleAsInt & 0x800000) //  if the 24th bit is set, this is a negative number in 24-bit world
+                    sampleAsInt = sampleAsInt | ~0xFFFFFF; // so make sure sign is extended to the 32 bit float
+                
+                return twentyFourBitIntToSample (sampleAsInt);
+            });
+        }
+        else if (bitDepth == 32 && isFloatingPoint && (std::is_floating_point<T>::value || FixedPointFormat<T>::isFixedPoint))
+        {
+            decode ([] (const uint8_t* b)
+            {
+                int32_t sampleAsInt = (b[3] << 24) | (b[2] << 16) | (b[1] << 8) | b[0];
+                float sampleAsFloat;
+                memcpy (&sampleAsFloat, &sampleAsInt, sizeof (float));
+                return floatToSample (sampleAsFloat);
+            });
+        }
+        else if (bitDepth == 32)
+        {
+            // integer sample types read floating point data as integers, as they always have
+            decode ([] (const uint8_t* b) { return thirtyTwoBitIntToSample ((b[3] << 24) | (b[2] << 16) | (b[1] << 8) | b[0]); });
+        }
+        else
+        {
+            assert (false);
+        }
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::encodeSamples (const T* source, int numSamples, int bitDepth, AudioFileFormat format, bool isFloatingPoint, uint8_t* destination, size_t numBytesBetweenSamples)
+{
+    if (isStoredAsIs (bitDepth, format, isFloatingPoint))
+    {
+        if (numBytesBetweenSamples == sizeof (T))
+        {
+            memcpy (destination, source, numSamples * sizeof (T));
+            return;
+        }
+        
+        // interleaved samples are stored with a typed loop, which compilers turn into plain
+        // strided stores. If the frames aren't aligned for T, the converting loops below are
+        // used instead, as a copy per sample can be slower than converting
+        if (numBytesBetweenSamples % sizeof (T) == 0 && reinterpret_cast<uintptr_t> (destination) % alignof (T) == 0)
+        {
+            T* typedDestination = reinterpret_cast<T*> (destination);
+            size_t stride = numBytesBetweenSamples / sizeof (T);
+            
+            for (int i = 0; i < numSamples; i++)
+                typedDestination[i * stride] = source[i];
+            
+            return;
+        }
+    }
+    
+    auto encode = [&] (auto sampleToBytes)
+    {
+        for (int i = 0; i < numSamples; i++)
+            sampleToBytes (source[i], destination + i * numBytesBetweenSamples);
+    };
+    
+    auto floatBits = [] (T sample)
+    {
+        float sampleAsFloat = sampleToFloat (sample);
+        int32_t sampleAsInt;
+        memcpy (&sampleAsInt, &sampleAsFloat, sizeof (float));
+        return sampleAsInt;
+    };
+    
+    if (format == AudioFileFormat::Aiff)
+    {
+        auto writeBigEndian = [] (int32_t value, uint8_t* b, int numBytes)
+        {
+            for (int k = 0; k < numBytes; k++)
+                b[k] = static_cast<uint8_t> ((value >> (8 * (numBytes - 1 - k))) & 0xFF);
+        };
+        
+        if (bitDepth == 8)
+            encode ([] (T sample, uint8_t* b) { b[0] = static_cast<uint8_t> (sampleToSignedByte (sample)); });
+        else if (bitDepth == 16)
+            encode ([&] (T sample, uint8_t* b) { writeBigEndian (sampleToSixteenBitInt (sample), b, 2); });
+        else if (bitDepth == 24)
+            encode ([&] (T sample, uint8_t* b) { writeBigEndian (sampleToTwentyFourBitInt (sample), b, 3); });
+        else if (bitDepth == 32 && isFloatingPoint)
+            encode ([&] (T sample, uint8_t* b) { writeBigEndian (floatBits (sample), b, 4); });
+        else if (bitDepth == 32)
+            encode ([&] (T sample, uint8_t* b) { writeBigEndian (sampleToThirtyTwoBitInt (sample), b, 4); });
+        else
+            assert (false && "Trying to write a file with unsupported bit depth");
+    }
+    else
+    {
+        auto writeLittleEndian = [] (int32_t value, uint8_t* b, int numBytes)
+        {
+            for (int k = 0; k < numBytes; k++)
+                b[k] = static_cast<uint8_t> ((value >> (8 * k)) & 0xFF);
+        };
+        
+        if (bitDepth == 8)
+            encode ([] (T sample, uint8_t* b) { b[0] = sampleToUnsignedByte (sample); });
+        else if (bitDepth == 16)
+            encode ([&] (T sample, uint8_t* b) { writeLittleEndian (sampleToSixteenBitInt (sample), b, 2); });
+        else if (bitDepth == 24)
+            encode ([&] (T sample, uint8_t* b) { writeLittleEndian (sampleToTwentyFourBitInt (sample), b, 3); });
+        else if (bitDepth == 32 && isFloatingPoint)
+            encode ([&] (T sample, uint8_t* b) { writeLittleEndian (floatBits (sample), b, 4); });
+        else if (bitDepth == 32)
+            encode ([&] (T sample, uint8_t* b) { writeLittleEndian (sampleToThirtyTwoBitInt (sample), b, 4); });
+        else
+            assert (false && "Trying to write a file with unsupported bit depth");
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::decodeFrames (const uint8_t* frames, int numChannelsInFrames, int numFrames, int bitDepth, AudioFileFormat format, bool isFloatingPoint,
+                                            const int* channels, int numChannels, T* const* destinations)
+{
+    // a single channel is contiguous, so there is nothing to gain from tiles
+    if (numChannelsInFrames == 1 && numChannels == 1)
+    {
+        decodeSamples (frames, static_cast<size_t> (bitDepth / 8), numFrames, bitDepth, format, isFloatingPoint, destinations[0]);
+        return;
+    }
+    
+    size_t numBytesPerSample = static_cast<size_t> (bitDepth / 8);
+    size_t numBytesPerFrame = numBytesPerSample * numChannelsInFrames;
+    int numFramesPerTile = std::max (static_cast<int> (numBytesPerTile / numBytesPerFrame), 16);
+    
+    for (int start = 0; start < numFrames; start += numFramesPerTile)
+    {
+        int numFramesInTile = std::min (numFramesPerTile, numFrames - start);
+        const uint8_t* tile = frames + start * numBytesPerFrame;
+        
+        for (int i = 0; i < numChannels; i++)
+        {
+            int channel = channels != nullptr ? channels[i] : i;
+            decodeSamples (tile + channel * numBytesPerSample, numBytesPerFrame, numFramesInTile, bitDepth, format, isFloatingPoint, destinations[i] + start);
+        }
+    }
+}
+
+//=============================================================
+template <class T>
+void AudioSampleConverter<T>::encodeFrames (const T* const* sources, int numChannels, int numFrames, int bitDepth, AudioFileFormat format, bool isFloatingPoint, uint8_t* frames)
+{
+    if (numChannels == 1)
+    {
+        encodeSamples (sources[0], numFrames, bitDepth, format, isFloatingPoint, frames, static_cast<size_t> (bitDepth / 8));
+        return;
+    }
+    
+    size_t numBytesPerSample = static_cast<size_t> (bitDepth / 8);
+    size_t numBytesPerFrame = numBytesPerSample * numChannels;
+    int numFramesPerTile = std::max (static_cast<int> (numBytesPerTile / numBytesPerFrame), 16);
+    
+    for (int start = 0; start < numFrames; start += numFramesPerTile)
+    {
+        int numFramesInTile = std::min (numFramesPerTile, numFrames - start);
+        uint8_t* tile = frames + start * numBytesPerFrame;
+        
+        for (int channel = 0; channel < numChannels; channel++)
+            encodeSamples (sources[channel] + start, numFramesInTile, bitDepth, format, isFloatingPoint, tile + channel * numBytesPerSample, numBytesPerFrame);
+    }
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleConverter<T>::isStoredAsIs (int bitDepth, AudioFileFormat format, bool isFloatingPoint)
+{
+    if (bitDepth != static_cast<int> (sizeof (T) * 8))
+        return false;
+    
+    // single bytes have no byte order, but AIFF stores them signed and WAV unsigned
+    if (bitDepth == 8)
+    {
+        if constexpr (std::is_same<T, int8_t>::value)
+            return format == AudioFileFormat::Aiff;
+        else if constexpr (std::is_same<T, uint8_t>::value)
+            return format == AudioFileFormat::Wave;
+        
+        return false;
+    }
+    
+    if (format != AudioFileFormat::Wave || ! isLittleEndianMachine())
+        return false;
+    
+    if constexpr (std::is_same<T, float>::value)
+        return isFloatingPoint;
+    else if constexpr (std::is_same<T, int16_t>::value || std::is_same<T, int32_t>::value || FixedPointFormat<T>::isFixedPoint)
+        return ! isFloatingPoint;
+    
+    return false;
+}
+
+//=============================================================
+template <class T>
+bool AudioSampleConverter<T>::isLittleEndianMachine()
+{
+    const uint16_t value = 1;
+    uint8_t firstByte;
+    memcpy (&firstByte, &value, 1);
+    return firstByte == 1;
+}
+
+//=============================================================
+template <class T>
+int64_t AudioSampleConverter<T>::rescaleCode (int64_t code, int numBits, int newNumBits)
+{
+    if (newNumBits >= numBits)
+        return code * (static_cast<int64_t> (1) << (newNumBits - numBits));
+    
+    // round to the nearest code, which can only overflow at the top of the range
+    int shift = numBits - newNumBits;
+    int64_t newCode = (code + (static_cast<int64_t> (1) << (shift - 1))) >> shift;
+    return std::min (newCode, (static_cast<int64_t> (1) << (newNumBits - 1)) - 1);
+}
+
+//=============================================================
+template <class T>
+T AudioSampleConverter<T>::codeToFixedPoint (int64_t code, int numCodeBits)
+{
+    T sample;
+    sample.value = static_cast<decltype (sample.value)> (rescaleCode (code, numCodeBits, FixedPointFormat<T>::numBits));
+    return sample;
+}
+
+//=============================================================
+template <class T>
+int64_t AudioSampleConverter<T>::fixedPointToCode (T sample, int numCodeBits)
+{
+    return rescaleCode (sample.value, FixedPointFormat<T>::numBits, numCodeBits);
+}
+
+//=============================================================
+template <class T>
+T AudioSampleConverter<T>::floatToSample (float sample)
+{
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+    {
+        const double scale = static_cast<double> (static_cast<int64_t> (1) << (FixedPointFormat<T>::numBits - 1));
+        
+        // saturate at the ends of the range, and treat anything that isn't a number as silence
+        double scaledSample = std::isnan (sample) ? 0. : std::round (static_cast<double> (sample) * scale);
+        scaledSample = std::min (std::max (scaledSample, -scale), scale - 1.);
+        
+        T fixedPointSample;
+        fixedPointSample.value = static_cast<decltype (fixedPointSample.value)> (scaledSample);
+        return fixedPointSample;
+    }
+    else
+    {
+        return static_cast<T> (sample);
+    }
+}
+
+//=============================================================
+template <class T>
+float AudioSampleConverter<T>::sampleToFloat (T sample)
+{
+    if constexpr (FixedPointFormat<T>::isFixedPoint)
+        return static_cast<float> (static_cast<double> (sample.value) / static_cast<double> (static_cast<int64_t> (1) << (FixedPointFormat<T>::numBits - 1)));
+    else
+        return static_cast<float> (sample);
+}
+
 //=============================================================
 template <class T>
 T AudioSampleConverter<T>::clamp (T value, T minValue, T maxValue)
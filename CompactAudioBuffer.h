@@ -0,0 +1,145 @@
+//=======================================================================
+/** @file CompactAudioBuffer.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+#include "RawSampleValues.h"
+
+#include <string>
+#include <vector>
+
+//=============================================================
+/** Read-only storage for decoded audio that keeps samples at the width they had in the file.
+ *
+ * An AudioFile<float> holding a 16-bit file takes twice the memory of the file's sample
+ * data (and an AudioFile<double> four times). This class stores 8, 16, 24 and 32-bit samples
+ * in 1, 2, 3 and 4 bytes respectively and only converts them to T when you read them,
+ * either one at a time or (much faster) a block at a time.
+ *
+ * Low bytes that are zero in every sample of a file are not stored at all, so (for example)
+ * a 24-bit file that was made by padding 16-bit audio only takes 2 bytes per sample.
+ *
+ * Samples read from the buffer are exactly the samples you would get by loading the same
+ * file into an AudioFile<T>. Reading samples is thread-safe.
+ */
+template <class T>
+class CompactAudioBuffer
+{
+public:
+    
+    //=============================================================
+    /** Constructor */
+    CompactAudioBuffer();
+    
+    //=============================================================
+    /** Loads an audio file from a given file path.
+     * @Returns true if the file was successfully loaded
+     */
+    bool load (const std::string& filePath);
+    
+    /** Loads an audio file from data in memory */
+    bool loadFromMemory (std::vector<uint8_t>& fileData);
+    
+    /** Stores audio given as raw sample values (e.g. from loadRawSampleValues()). For
+     * integer PCM these are simply the integer sample values for the audio's bit depth.
+     * @Returns true if the audio was stored
+     */
+    bool pack (const AudioFile<int32_t>& rawAudio);
+    
+    /** Removes all audio */
+    void clear();
+    
+    //=============================================================
+    /** @Returns the sample rate */
+    uint32_t getSampleRate() const;
+    
+    /** @Returns the number of audio channels */
+    int getNumChannels() const;
+    
+    /** @Returns the bit depth of the audio */
+    int getBitDepth() const;
+    
+    /** @Returns the number of bits each sample is stored in, which can be less than the
+     * bit depth when the low bytes of every sample are zero
+     */
+    int getStorageBitDepth() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamplesPerChannel() const;
+    
+    /** @Returns the length in seconds of the audio */
+    double getLengthInSeconds() const;
+    
+    //=============================================================
+    /** @Returns a single sample, converted to T */
+    T getSample (int channel, int sampleIndex) const;
+    
+    /** Converts a range of samples from one channel into the destination buffer, which
+     * must have room for numSamples samples. The range must lie within the audio.
+     */
+    void readSamples (int channel, int startSample, int numSamples, T* destination) const;
+    
+    /** Converts all of the audio into an AudioFile
+     * @Returns false if there is no audio
+     */
+    bool copyTo (AudioFile<T>& audioFile) const;
+    
+    //=============================================================
+    /** @Returns the number of bytes used to store the samples */
+    size_t getSizeInBytes() const;
+    
+    //=============================================================
+    /** Sets whether the buffer should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+    
+private:
+    
+    //=============================================================
+    int32_t readRawValue (const uint8_t* storedSample) const;
+    T convertRawValue (int32_t rawValue) const;
+    
+    template <int numBytes>
+    void convertSamples (const uint8_t* source, int numSamples, T* destination) const;
+    
+    //=============================================================
+    void reportError (std::string errorMessage);
+    
+    //=============================================================
+    std::vector<std::vector<uint8_t>> channels;
+    int numSamplesPerChannel {0};
+    uint32_t sampleRate {0};
+    int bitDepth {0};
+    int numBytesPerSample {0};
+    int numDroppedBits {0};
+    bool floatingPointFormat {false};
+    bool logErrorsToConsole {true};
+};
+
+#include "CompactAudioBuffer.inl"
@@ -0,0 +1,324 @@
+//=======================================================================
+/** @file CompactAudioBuffer.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+CompactAudioBuffer<T>::CompactAudioBuffer()
+{
+}
+
+//=============================================================
+template <class T>
+bool CompactAudioBuffer<T>::load (const std::string& filePath)
+{
+    AudioFile<int32_t> rawAudio;
+    return loadRawSampleValues (filePath, rawAudio, logErrorsToConsole) && pack (rawAudio);
+}
+
+//=============================================================
+template <class T>
+bool CompactAudioBuffer<T>::loadFromMemory (std::vector<uint8_t>& fileData)
+{
+    AudioFile<int32_t> rawAudio;
+    return loadRawSampleValues (fileData, rawAudio, logErrorsToConsole) && pack (rawAudio);
+}
+
+//=============================================================
+template <class T>
+bool CompactAudioBuffer<T>::pack (const AudioFile<int32_t>& rawAudio)
+{
+    clear();
+    
+    int newBitDepth = rawAudio.getBitDepth();
+    bool isFloatingPoint = rawAudio.isFloatingPointFormat();
+    
+    if (newBitDepth != 8 && newBitDepth != 16 && newBitDepth != 24 && newBitDepth != 32)
+    {
+        reportError ("ERROR: this audio has a bit depth that is not 8, 16, 24 or 32 bits");
+        return false;
+    }
+    
+    if (isFloatingPoint && ! std::is_floating_point<T>::value)
+    {
+        reportError ("ERROR: floating point audio can only be read as a floating point type");
+        return false;
+    }
+    
+    if (std::numeric_limits<T>::is_integer && static_cast<int> (sizeof (T)) * 8 < newBitDepth)
+    {
+        reportError ("ERROR: the sample type is too small for the bit depth of this audio");
+        return false;
+    }
+    
+    if (rawAudio.getNumChannels() == 0)
+    {
+        reportError ("ERROR: there is no audio to store");
+        return false;
+    }
+    
+    // find the low bytes that are zero in every sample, as there is no need to store them
+    int newNumDroppedBits = 0;
+    
+    if (! isFloatingPoint)
+    {
+        uint32_t setBits = 0;
+        
+        for (auto& channelSamples : rawAudio.samples)
+        {
+            for (auto sample : channelSamples)
+                setBits |= static_cast<uint32_t> (sample);
+        }
+        
+        while (newNumDroppedBits < newBitDepth - 8 && (setBits & (0xFFu << newNumDroppedBits)) == 0)
+            newNumDroppedBits += 8;
+    }
+    
+    numSamplesPerChannel = rawAudio.getNumSamplesPerChannel();
+    sampleRate = rawAudio.getSampleRate();
+    bitDepth = newBitDepth;
+    numDroppedBits = newNumDroppedBits;
+    numBytesPerSample = (newBitDepth - newNumDroppedBits) / 8;
+    floatingPointFormat = isFloatingPoint;
+    
+    channels.resize (rawAudio.getNumChannels());
+    
+    for (size_t channel = 0; channel < channels.size(); channel++)
+    {
+        channels[channel].resize (static_cast<size_t> (numSamplesPerChannel) * numBytesPerSample);
+        uint8_t* storedSample = channels[channel].data();
+        
+        for (int i = 0; i < numSamplesPerChannel; i++)
+        {
+            // stored as little endian, whatever the platform
+            uint32_t value = static_cast<uint32_t> (rawAudio.samples[channel][i]) >> numDroppedBits;
+            
+            for (int byte = 0; byte < numBytesPerSample; byte++)
+                *storedSample++ = static_cast<uint8_t> (value >> (8 * byte));
+        }
+    }
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+void CompactAudioBuffer<T>::clear()
+{
+    channels.clear();
+    numSamplesPerChannel = 0;
+    sampleRate = 0;
+    bitDepth = 0;
+    numBytesPerSample = 0;
+    numDroppedBits = 0;
+    floatingPointFormat = false;
+}
+
+//=============================================================
+template <class T>
+uint32_t CompactAudioBuffer<T>::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//=============================================================
+template <class T>
+int CompactAudioBuffer<T>::getNumChannels() const
+{
+    return static_cast<int> (channels.size());
+}
+
+//=============================================================
+template <class T>
+int CompactAudioBuffer<T>::getBitDepth() const
+{
+    return bitDepth;
+}
+
+//=============================================================
+template <class T>
+int CompactAudioBuffer<T>::getStorageBitDepth() const
+{
+    return numBytesPerSample * 8;
+}
+
+//=============================================================
+template <class T>
+int CompactAudioBuffer<T>::getNumSamplesPerChannel() const
+{
+    return numSamplesPerChannel;
+}
+
+//=============================================================
+template <class T>
+double CompactAudioBuffer<T>::getLengthInSeconds() const
+{
+    if (sampleRate == 0)
+        return 0.;
+    
+    return static_cast<double> (numSamplesPerChannel) / static_cast<double> (sampleRate);
+}
+
+//=============================================================
+template <class T>
+T CompactAudioBuffer<T>::getSample (int channel, int sampleIndex) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    assert (sampleIndex >= 0 && sampleIndex < numSamplesPerChannel);
+    
+    const uint8_t* storedSample = channels[channel].data() + static_cast<size_t> (sampleIndex) * numBytesPerSample;
+    return convertRawValue (readRawValue (storedSample));
+}
+
+//=============================================================
+template <class T>
+void CompactAudioBuffer<T>::readSamples (int channel, int startSample, int numSamples, T* destination) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    assert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= numSamplesPerChannel);
+    
+    const uint8_t* source = channels[channel].data() + static_cast<size_t> (startSample) * numBytesPerSample;
+    
+    // a loop per storage width, so the compiler can turn each into straight loads
+    switch (numBytesPerSample)
+    {
+        case 1: convertSamples<1> (source, numSamples, destination); break;
+        case 2: convertSamples<2> (source, numSamples, destination); break;
+        case 3: convertSamples<3> (source, numSamples, destination); break;
+        default: convertSamples<4> (source, numSamples, destination); break;
+    }
+}
+
+//=============================================================
+template <class T>
+bool CompactAudioBuffer<T>::copyTo (AudioFile<T>& audioFile) const
+{
+    if (channels.empty())
+        return false;
+    
+    std::vector<std::vector<T>> newSamples (getNumChannels(), std::vector<T> (numSamplesPerChannel));
+    
+    for (int channel = 0; channel < getNumChannels(); channel++)
+        readSamples (channel, 0, numSamplesPerChannel, newSamples[channel].data());
+    
+    // moving the samples in means copies of the AudioFile can still share them
+    audioFile.setAudioBuffer (std::move (newSamples));
+    audioFile.setBitDepth (bitDepth);
+    audioFile.setSampleRate (sampleRate);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+size_t CompactAudioBuffer<T>::getSizeInBytes() const
+{
+    return channels.size() * static_cast<size_t> (numSamplesPerChannel) * numBytesPerSample;
+}
+
+//=============================================================
+template <class T>
+void CompactAudioBuffer<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+int32_t CompactAudioBuffer<T>::readRawValue (const uint8_t* storedSample) const
+{
+    uint32_t value = 0;
+    
+    for (int byte = 0; byte < numBytesPerSample; byte++)
+        value |= static_cast<uint32_t> (storedSample[byte]) << (8 * byte);
+    
+    // sign extend from the stored width, then put back any dropped low bytes
+    int unusedBits = 32 - numBytesPerSample * 8;
+    int32_t signedValue = static_cast<int32_t> (value << unusedBits) >> unusedBits;
+    
+    return static_cast<int32_t> (static_cast<uint32_t> (signedValue) << numDroppedBits);
+}
+
+//=============================================================
+template <class T>
+T CompactAudioBuffer<T>::convertRawValue (int32_t rawValue) const
+{
+    if (floatingPointFormat)
+    {
+        float sample;
+        memcpy (&sample, &rawValue, sizeof (float));
+        return static_cast<T> (sample);
+    }
+    else if (bitDepth == 8)
+    {
+        return AudioSampleConverter<T>::signedByteToSample (static_cast<int8_t> (rawValue));
+    }
+    else if (bitDepth == 16)
+    {
+        return AudioSampleConverter<T>::sixteenBitIntToSample (static_cast<int16_t> (rawValue));
+    }
+    else if (bitDepth == 24)
+    {
+        return AudioSampleConverter<T>::twentyFourBitIntToSample (rawValue);
+    }
+    else
+    {
+        return AudioSampleConverter<T>::thirtyTwoBitIntToSample (rawValue);
+    }
+}
+
+//=============================================================
+template <class T>
+template <int numBytes>
+void CompactAudioBuffer<T>::convertSamples (const uint8_t* source, int numSamples, T* destination) const
+{
+    constexpr int unusedBits = 32 - numBytes * 8;
+    
+    for (int i = 0; i < numSamples; i++)
+    {
+        uint32_t value = 0;
+        
+        for (int byte = 0; byte < numBytes; byte++)
+            value |= static_cast<uint32_t> (source[byte]) << (8 * byte);
+        
+        int32_t signedValue = static_cast<int32_t> (value << unusedBits) >> unusedBits;
+        destination[i] = convertRawValue (static_cast<int32_t> (static_cast<uint32_t> (signedValue) << numDroppedBits));
+        source += numBytes;
+    }
+}
+
+//=============================================================
+template <class T>
+void CompactAudioBuffer<T>::reportError (std::string errorMessage)
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
@@ -0,0 +1,210 @@
+//=======================================================================
+/** @file CompressedAudioBuffer.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+#include "RawSampleValues.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+//=============================================================
+/** Losslessly compressed, read-only storage for decoded audio.
+ *
+ * Rather than holding every sample as a T, the original integer PCM values of a file
+ * are split into fixed-size blocks per channel, and each block is stored as the residual
+ * of a simple polynomial predictor (chosen per block) packed with Rice codes. For typical
+ * 16 and 24-bit material this takes around half the space of the PCM data, and a quarter
+ * or less of the space of the same audio held as floats in an AudioFile.
+ *
+ * Every block can be decoded on its own, so samples are read with random access. Recently
+ * decoded blocks are kept (converted to T) in a small cache, so reading neighbouring samples
+ * is cheap. Reading samples is thread-safe.
+ *
+ * Decoded samples are exactly the samples you would get by loading the same file into an
+ * AudioFile<T>. Files storing 32-bit floating point samples are also supported (though
+ * they compress much less well), but only when T is a floating point type.
+ */
+template <class T>
+class CompressedAudioBuffer
+{
+public:
+    
+    //=============================================================
+    /** Constructor
+     * @param numSamplesPerBlock the number of samples per channel in each compressed block.
+     * Smaller blocks give faster random access but compress slightly less well
+     * @param numCachedBlocks the number of decoded blocks to keep in memory
+     */
+    CompressedAudioBuffer (int numSamplesPerBlock = 4096, int numCachedBlocks = 32);
+    
+    CompressedAudioBuffer (const CompressedAudioBuffer&) = delete;
+    CompressedAudioBuffer& operator= (const CompressedAudioBuffer&) = delete;
+    
+    //=============================================================
+    /** Loads and compresses an audio file from a given file path.
+     * @Returns true if the file was successfully loaded
+     */
+    bool load (const std::string& filePath);
+    
+    /** Loads and compresses an audio file from data in memory */
+    bool loadFromMemory (std::vector<uint8_t>& fileData);
+    
+    /** Compresses audio given as raw sample values (e.g. from loadRawSampleValues()). For
+     * integer PCM these are simply the integer sample values for the audio's bit depth.
+     * @Returns true if the audio was compressed
+     */
+    bool compress (const AudioFile<int32_t>& rawAudio);
+    
+    /** Removes all audio */
+    void clear();
+    
+    //=============================================================
+    /** @Returns the sample rate */
+    uint32_t getSampleRate() const;
+    
+    /** @Returns the number of audio channels */
+    int getNumChannels() const;
+    
+    /** @Returns the bit depth of the audio */
+    int getBitDepth() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamplesPerChannel() const;
+    
+    /** @Returns the length in seconds of the audio */
+    double getLengthInSeconds() const;
+    
+    /** @Returns the number of samples per channel in each compressed block */
+    int getNumSamplesPerBlock() const;
+    
+    //=============================================================
+    /** @Returns a single sample. If you need more than a handful of samples,
+     * readSamples() is much faster
+     */
+    T getSample (int channel, int sampleIndex) const;
+    
+    /** Decodes a range of samples from one channel into the destination buffer, which
+     * must have room for numSamples samples. The range must lie within the audio.
+     */
+    void readSamples (int channel, int startSample, int numSamples, T* destination) const;
+    
+    /** Decodes all of the audio into an AudioFile
+     * @Returns false if there is no audio to decode
+     */
+    bool decompress (AudioFile<T>& audioFile) const;
+    
+    //=============================================================
+    /** @Returns the number of bytes used by the compressed audio, not including the block cache */
+    size_t getCompressedSizeInBytes() const;
+    
+    /** @Returns the number of bytes the audio takes up as (packed) PCM data */
+    size_t getPCMSizeInBytes() const;
+    
+    //=============================================================
+    /** Sets whether the buffer should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+    
+private:
+    
+    //=============================================================
+    struct CachedBlock
+    {
+        int channel = -1;
+        int block = -1;
+        uint64_t lastUsed = 0;
+        std::vector<T> samples;
+    };
+
+    /** Packs values into bytes, most significant bit first */
+    struct BitWriter
+    {
+        BitWriter (std::vector<uint8_t>& output);
+        void write (uint64_t value, int numBits);
+        void writeRice (uint64_t value, int riceParameter);
+        void flush();
+
+        std::vector<uint8_t>& bytes;
+        uint64_t buffer = 0;
+        int numBits = 0;
+    };
+
+    /** Reads values written by a BitWriter */
+    struct BitReader
+    {
+        BitReader (const uint8_t* start, const uint8_t* end);
+        uint64_t read (int numBits);
+        uint64_t readRice (int riceParameter);
+        void refill();
+
+        const uint8_t* position;
+        const uint8_t* end;
+        uint64_t buffer = 0;
+        int numBits = 0;
+    };
+
+    //=============================================================
+    static constexpr int numPredictorOrders = 4;
+    static constexpr int numSamplesPerPartition = 256;
+    static constexpr int maximumUnaryLength = 24;
+    static constexpr int numEscapedBits = 40;
+    
+    //=============================================================
+    bool compressSamples (const std::vector<std::vector<int32_t>>& codes, uint32_t newSampleRate, int newBitDepth, bool isFloatingPoint);
+    void encodeBlock (const int32_t* codes, int numSamples, std::vector<int64_t>& residuals);
+    void decodeBlock (int channel, int block, int32_t* codes) const;
+    void convertCodes (const int32_t* codes, int numSamples, T* destination) const;
+    const CachedBlock* findCachedBlock (int channel, int block) const;
+    const CachedBlock& decodeIntoCache (int channel, int block) const;
+    int getNumSamplesInBlock (int block) const;
+    
+    //=============================================================
+    void reportError (std::string errorMessage);
+    
+    //=============================================================
+    std::vector<uint8_t> data;
+    std::vector<uint64_t> blockOffsets;
+    int blockSize;
+    int numBlocks {0};
+    int numChannels {0};
+    int numSamplesPerChannel {0};
+    uint32_t sampleRate {0};
+    int bitDepth {0};
+    bool floatingPointFormat {false};
+    bool logErrorsToConsole {true};
+    
+    mutable std::mutex cacheLock;
+    mutable std::vector<CachedBlock> cache;
+    mutable std::vector<int32_t> scratch;
+    mutable uint64_t cacheCounter {0};
+};
+
+#include "CompressedAudioBuffer.inl"
@@ -0,0 +1,630 @@
+//=======================================================================
+/** @file CompressedAudioBuffer.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#if defined (_MSC_VER)
+    #include <intrin.h>
+#endif
+
+//=============================================================
+template <class T>
+CompressedAudioBuffer<T>::BitWriter::BitWriter (std::vector<uint8_t>& output)
+ : bytes (output)
+{
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::BitWriter::write (uint64_t value, int numBitsToWrite)
+{
+    if (numBitsToWrite > 32)
+    {
+        write (value >> 32, numBitsToWrite - 32);
+        numBitsToWrite = 32;
+    }
+    
+    uint64_t mask = (static_cast<uint64_t> (1) << numBitsToWrite) - 1;
+    buffer = (buffer << numBitsToWrite) | (value & mask);
+    numBits += numBitsToWrite;
+    
+    while (numBits >= 8)
+    {
+        numBits -= 8;
+        bytes.push_back (static_cast<uint8_t> (buffer >> numBits));
+    }
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::BitWriter::writeRice (uint64_t value, int riceParameter)
+{
+    uint64_t quotient = value >> riceParameter;
+    
+    if (quotient < maximumUnaryLength)
+    {
+        // the quotient as a run of ones terminated by a zero, then the remainder
+        write (((static_cast<uint64_t> (1) << quotient) - 1) << 1, static_cast<int> (quotient) + 1);
+        write (value, riceParameter);
+    }
+    else
+    {
+        // values the predictor got badly wrong are escaped and written in full
+        write ((static_cast<uint64_t> (1) << maximumUnaryLength) - 1, maximumUnaryLength);
+        write (value, numEscapedBits);
+    }
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::BitWriter::flush()
+{
+    if (numBits > 0)
+        write (0, 8 - numBits);
+}
+
+//=============================================================
+template <class T>
+CompressedAudioBuffer<T>::BitReader::BitReader (const uint8_t* start, const uint8_t* endOfData)
+ : position (start), end (endOfData)
+{
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::BitReader::refill()
+{
+    while (numBits <= 56 && position < end)
+    {
+        buffer |= static_cast<uint64_t> (*position++) << (56 - numBits);
+        numBits += 8;
+    }
+}
+
+//=============================================================
+template <class T>
+uint64_t CompressedAudioBuffer<T>::BitReader::read (int numBitsToRead)
+{
+    if (numBitsToRead > 32)
+    {
+        uint64_t highBits = read (numBitsToRead - 32);
+        return (highBits << 32) | read (32);
+    }
+    
+    if (numBitsToRead == 0)
+        return 0;
+    
+    refill();
+    
+    uint64_t value = buffer >> (64 - numBitsToRead);
+    buffer <<= numBitsToRead;
+    numBits -= numBitsToRead;
+    return value;
+}
+
+//=============================================================
+template <class T>
+uint64_t CompressedAudioBuffer<T>::BitReader::readRice (int riceParameter)
+{
+    refill();
+    
+    // the unused bits of the buffer are zero, so this never counts past the end of the data
+    uint64_t inverted = ~buffer;
+    int quotient = 64;
+    
+    if (inverted != 0)
+    {
+       #if defined (__GNUC__)
+        quotient = __builtin_clzll (inverted);
+       #elif defined (_MSC_VER) && defined (_M_X64)
+        unsigned long index;
+        _BitScanReverse64 (&index, inverted);
+        quotient = 63 - static_cast<int> (index);
+       #else
+        quotient = 0;
+        
+        while ((inverted & (static_cast<uint64_t> (1) << (63 - quotient))) == 0)
+            quotient++;
+       #endif
+    }
+    
+    if (quotient >= maximumUnaryLength)
+    {
+        buffer <<= maximumUnaryLength;
+        numBits -= maximumUnaryLength;
+        return read (numEscapedBits);
+    }
+    
+    buffer <<= quotient + 1;
+    numBits -= quotient + 1;
+    
+    return (static_cast<uint64_t> (quotient) << riceParameter) | read (riceParameter);
+}
+
+//=============================================================
+template <class T>
+CompressedAudioBuffer<T>::CompressedAudioBuffer (int numSamplesPerBlock, int numCachedBlocks)
+ : blockSize (std::max (numSamplesPerBlock, 1))
+{
+    cache.resize (std::max (numCachedBlocks, 1));
+    scratch.resize (blockSize);
+}
+
+//=============================================================
+template <class T>
+bool CompressedAudioBuffer<T>::load (const std::string& filePath)
+{
+    AudioFile<int32_t> rawAudio;
+    return loadRawSampleValues (filePath, rawAudio, logErrorsToConsole) && compress (rawAudio);
+}
+
+//=============================================================
+template <class T>
+bool CompressedAudioBuffer<T>::loadFromMemory (std::vector<uint8_t>& fileData)
+{
+    AudioFile<int32_t> rawAudio;
+    return loadRawSampleValues (fileData, rawAudio, logErrorsToConsole) && compress (rawAudio);
+}
+
+//=============================================================
+template <class T>
+bool CompressedAudioBuffer<T>::compress (const AudioFile<int32_t>& rawAudio)
+{
+    int newBitDepth = rawAudio.getBitDepth();
+    bool isFloatingPoint = rawAudio.isFloatingPointFormat();
+    
+    if (newBitDepth != 8 && newBitDepth != 16 && newBitDepth != 24 && newBitDepth != 32)
+    {
+        reportError ("ERROR: this audio has a bit depth that is not 8, 16, 24 or 32 bits");
+        return false;
+    }
+    
+    if (isFloatingPoint && ! std::is_floating_point<T>::value)
+    {
+        reportError ("ERROR: floating point audio can only be decompressed to a floating point type");
+        return false;
+    }
+    
+    if (std::numeric_limits<T>::is_integer && static_cast<int> (sizeof (T)) * 8 < newBitDepth)
+    {
+        reportError ("ERROR: the sample type is too small for the bit depth of this audio");
+        return false;
+    }
+    
+    return compressSamples (rawAudio.samples, rawAudio.getSampleRate(), newBitDepth, isFloatingPoint);
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::clear()
+{
+    std::lock_guard<std::mutex> guard (cacheLock);
+    
+    data.clear();
+    data.shrink_to_fit();
+    blockOffsets.clear();
+    blockOffsets.shrink_to_fit();
+    numBlocks = 0;
+    numChannels = 0;
+    numSamplesPerChannel = 0;
+    sampleRate = 0;
+    bitDepth = 0;
+    floatingPointFormat = false;
+    
+    for (auto& cachedBlock : cache)
+    {
+        cachedBlock = CachedBlock();
+    }
+}
+
+//=============================================================
+template <class T>
+uint32_t CompressedAudioBuffer<T>::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//=============================================================
+template <class T>
+int CompressedAudioBuffer<T>::getNumChannels() const
+{
+    return numChannels;
+}
+
+//=============================================================
+template <class T>
+int CompressedAudioBuffer<T>::getBitDepth() const
+{
+    return bitDepth;
+}
+
+//=============================================================
+template <class T>
+int CompressedAudioBuffer<T>::getNumSamplesPerChannel() const
+{
+    return numSamplesPerChannel;
+}
+
+//=============================================================
+template <class T>
+double CompressedAudioBuffer<T>::getLengthInSeconds() const
+{
+    if (sampleRate == 0)
+        return 0.;
+    
+    return static_cast<double> (numSamplesPerChannel) / static_cast<double> (sampleRate);
+}
+
+//=============================================================
+template <class T>
+int CompressedAudioBuffer<T>::getNumSamplesPerBlock() const
+{
+    return blockSize;
+}
+
+//=============================================================
+template <class T>
+T CompressedAudioBuffer<T>::getSample (int channel, int sampleIndex) const
+{
+    T sample;
+    readSamples (channel, sampleIndex, 1, &sample);
+    return sample;
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::readSamples (int channel, int startSample, int numSamples, T* destination) const
+{
+    assert (channel >= 0 && channel < numChannels);
+    assert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= numSamplesPerChannel);
+    
+    std::lock_guard<std::mutex> guard (cacheLock);
+    
+    while (numSamples > 0)
+    {
+        int block = startSample / blockSize;
+        int offsetInBlock = startSample - block * blockSize;
+        int numSamplesInBlock = getNumSamplesInBlock (block);
+        int numSamplesToCopy = std::min (numSamples, numSamplesInBlock - offsetInBlock);
+        
+        const CachedBlock* cachedBlock = findCachedBlock (channel, block);
+        
+        if (cachedBlock == nullptr && numSamplesToCopy == numSamplesInBlock)
+        {
+            // whole blocks are decoded straight into the destination, so that
+            // long reads don't push everything else out of the cache
+            decodeBlock (channel, block, scratch.data());
+            convertCodes (scratch.data(), numSamplesToCopy, destination);
+        }
+        else
+        {
+            if (cachedBlock == nullptr)
+                cachedBlock = &decodeIntoCache (channel, block);
+            
+            const T* samples = cachedBlock->samples.data() + offsetInBlock;
+            std::copy (samples, samples + numSamplesToCopy, destination);
+        }
+        
+        startSample += numSamplesToCopy;
+        numSamples -= numSamplesToCopy;
+        destination += numSamplesToCopy;
+    }
+}
+
+//=============================================================
+template <class T>
+bool CompressedAudioBuffer<T>::decompress (AudioFile<T>& audioFile) const
+{
+    if (numChannels == 0)
+        return false;
+    
+    std::vector<std::vector<T>> newSamples (numChannels, std::vector<T> (numSamplesPerChannel));
+    
+    for (int channel = 0; channel < numChannels; channel++)
+        readSamples (channel, 0, numSamplesPerChannel, newSamples[channel].data());
+    
+    // moving the samples in means copies of the AudioFile can still share them
+    audioFile.setAudioBuffer (std::move (newSamples));
+    audioFile.setBitDepth (bitDepth);
+    audioFile.setSampleRate (sampleRate);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+size_t CompressedAudioBuffer<T>::getCompressedSizeInBytes() const
+{
+    return data.size() + blockOffsets.size() * sizeof (uint64_t);
+}
+
+//=============================================================
+template <class T>
+size_t CompressedAudioBuffer<T>::getPCMSizeInBytes() const
+{
+    return static_cast<size_t> (numChannels) * static_cast<size_t> (numSamplesPerChannel) * static_cast<size_t> (bitDepth / 8);
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+bool CompressedAudioBuffer<T>::compressSamples (const std::vector<std::vector<int32_t>>& codes, uint32_t newSampleRate, int newBitDepth, bool isFloatingPoint)
+{
+    clear();
+    
+    if (codes.empty())
+    {
+        reportError ("ERROR: there is no audio to compress");
+        return false;
+    }
+    
+    for (auto& channelCodes : codes)
+    {
+        if (channelCodes.size() != codes[0].size() || channelCodes.size() > static_cast<size_t> (std::numeric_limits<int>::max()))
+        {
+            reportError ("ERROR: the channels of this audio have different or unsupported lengths");
+            return false;
+        }
+    }
+    
+    std::lock_guard<std::mutex> guard (cacheLock);
+    
+    numChannels = static_cast<int> (codes.size());
+    numSamplesPerChannel = static_cast<int> (codes[0].size());
+    numBlocks = (numSamplesPerChannel + blockSize - 1) / blockSize;
+    sampleRate = newSampleRate;
+    bitDepth = newBitDepth;
+    floatingPointFormat = isFloatingPoint;
+    
+    blockOffsets.reserve (static_cast<size_t> (numChannels) * numBlocks + 1);
+    data.reserve (getPCMSizeInBytes() / 2);
+    
+    std::vector<int64_t> residuals (blockSize);
+    
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        for (int block = 0; block < numBlocks; block++)
+        {
+            blockOffsets.push_back (data.size());
+            encodeBlock (codes[channel].data() + static_cast<size_t> (block) * blockSize, getNumSamplesInBlock (block), residuals);
+        }
+    }
+    
+    blockOffsets.push_back (data.size());
+    
+    // padding, so that reading the last block never refills from past the end of the data
+    data.insert (data.end(), 8, 0);
+    data.shrink_to_fit();
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::encodeBlock (const int32_t* codes, int numSamples, std::vector<int64_t>& residuals)
+{
+    // the residual of sample i for predictor order p is the p-th difference of the
+    // samples up to i (the first p samples of the block use lower orders, so every
+    // block can be decoded without any other block)
+    auto getResidual = [codes] (int order, int i) -> int64_t
+    {
+        int64_t x0 = codes[i];
+        
+        switch (std::min (order, i))
+        {
+            case 0: return x0;
+            case 1: return x0 - codes[i - 1];
+            case 2: return x0 - 2 * static_cast<int64_t> (codes[i - 1]) + codes[i - 2];
+            default: return x0 - 3 * static_cast<int64_t> (codes[i - 1]) + 3 * static_cast<int64_t> (codes[i - 2]) - codes[i - 3];
+        }
+    };
+    
+    // pick the predictor that leaves the smallest residuals
+    uint64_t costs[numPredictorOrders] = {};
+    
+    for (int i = 0; i < numSamples; i++)
+    {
+        for (int order = 0; order < numPredictorOrders; order++)
+        {
+            int64_t residual = getResidual (order, i);
+            costs[order] += static_cast<uint64_t> (residual < 0 ? -residual : residual);
+        }
+    }
+    
+    int predictorOrder = static_cast<int> (std::min_element (costs, costs + numPredictorOrders) - costs);
+    
+    for (int i = 0; i < numSamples; i++)
+        residuals[i] = getResidual (predictorOrder, i);
+    
+    BitWriter writer (data);
+    writer.write (static_cast<uint64_t> (predictorOrder), 2);
+    
+    for (int start = 0; start < numSamples; start += numSamplesPerPartition)
+    {
+        int end = std::min (start + numSamplesPerPartition, numSamples);
+        
+        // zig-zag encode the residuals so that small negative values become small positive ones
+        uint64_t sum = 0;
+        
+        for (int i = start; i < end; i++)
+        {
+            uint64_t value = (static_cast<uint64_t> (residuals[i]) << 1) ^ static_cast<uint64_t> (residuals[i] >> 63);
+            residuals[i] = static_cast<int64_t> (value);
+            sum += value;
+        }
+        
+        // a Rice parameter close to log2 of the mean value keeps the codes short
+        uint64_t mean = sum / static_cast<uint64_t> (end - start);
+        int riceParameter = 0;
+        
+        while (riceParameter < numEscapedBits - 8 && (static_cast<uint64_t> (1) << (riceParameter + 1)) <= mean)
+            riceParameter++;
+        
+        writer.write (static_cast<uint64_t> (riceParameter), 6);
+        
+        for (int i = start; i < end; i++)
+            writer.writeRice (static_cast<uint64_t> (residuals[i]), riceParameter);
+    }
+    
+    writer.flush();
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::decodeBlock (int channel, int block, int32_t* codes) const
+{
+    size_t blockIndex = static_cast<size_t> (channel) * numBlocks + block;
+    BitReader reader (data.data() + blockOffsets[blockIndex], data.data() + data.size());
+    
+    int numSamples = getNumSamplesInBlock (block);
+    int predictorOrder = static_cast<int> (reader.read (2));
+    
+    int64_t x1 = 0, x2 = 0, x3 = 0;
+    
+    for (int start = 0; start < numSamples; start += numSamplesPerPartition)
+    {
+        int end = std::min (start + numSamplesPerPartition, numSamples);
+        int riceParameter = static_cast<int> (reader.read (6));
+        
+        for (int i = start; i < end; i++)
+        {
+            uint64_t value = reader.readRice (riceParameter);
+            int64_t residual = static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1);
+            int64_t x0;
+            
+            switch (std::min (predictorOrder, i))
+            {
+                case 0: x0 = residual; break;
+                case 1: x0 = residual + x1; break;
+                case 2: x0 = residual + 2 * x1 - x2; break;
+                default: x0 = residual + 3 * x1 - 3 * x2 + x3; break;
+            }
+            
+            codes[i] = static_cast<int32_t> (x0);
+            x3 = x2;
+            x2 = x1;
+            x1 = x0;
+        }
+    }
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::convertCodes (const int32_t* codes, int numSamples, T* destination) const
+{
+    if (floatingPointFormat)
+    {
+        for (int i = 0; i < numSamples; i++)
+        {
+            float sample;
+            memcpy (&sample, &codes[i], sizeof (float));
+            destination[i] = static_cast<T> (sample);
+        }
+    }
+    else if (bitDepth == 8)
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i] = AudioSampleConverter<T>::signedByteToSample (static_cast<int8_t> (codes[i]));
+    }
+    else if (bitDepth == 16)
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i] = AudioSampleConverter<T>::sixteenBitIntToSample (static_cast<int16_t> (codes[i]));
+    }
+    else if (bitDepth == 24)
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i] = AudioSampleConverter<T>::twentyFourBitIntToSample (codes[i]);
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; i++)
+            destination[i] = AudioSampleConverter<T>::thirtyTwoBitIntToSample (codes[i]);
+    }
+}
+
+//=============================================================
+template <class T>
+const typename CompressedAudioBuffer<T>::CachedBlock* CompressedAudioBuffer<T>::findCachedBlock (int channel, int block) const
+{
+    for (auto& cachedBlock : cache)
+    {
+        if (cachedBlock.channel == channel && cachedBlock.block == block)
+        {
+            cachedBlock.lastUsed = ++cacheCounter;
+            return &cachedBlock;
+        }
+    }
+    
+    return nullptr;
+}
+
+//=============================================================
+template <class T>
+const typename CompressedAudioBuffer<T>::CachedBlock& CompressedAudioBuffer<T>::decodeIntoCache (int channel, int block) const
+{
+    auto leastRecentlyUsed = std::min_element (cache.begin(), cache.end(), [] (const CachedBlock& a, const CachedBlock& b)
+    {
+        return a.lastUsed < b.lastUsed;
+    });
+    
+    int numSamples = getNumSamplesInBlock (block);
+    decodeBlock (channel, block, scratch.data());
+    
+    leastRecentlyUsed->samples.resize (numSamples);
+    convertCodes (scratch.data(), numSamples, leastRecentlyUsed->samples.data());
+    
+    leastRecentlyUsed->channel = channel;
+    leastRecentlyUsed->block = block;
+    leastRecentlyUsed->lastUsed = ++cacheCounter;
+    
+    return *leastRecentlyUsed;
+}
+
+//=============================================================
+template <class T>
+int CompressedAudioBuffer<T>::getNumSamplesInBlock (int block) const
+{
+    return std::min (blockSize, numSamplesPerChannel - block * blockSize);
+}
+
+//=============================================================
+template <class T>
+void CompressedAudioBuffer<T>::reportError (std::string errorMessage)
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
@@ -0,0 +1,142 @@
+//=======================================================================
+/** @file InterleavedAudioFile.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+#include "AudioHeader.h"
+
+#include <string>
+#include <vector>
+
+//=============================================================
+/** An audio file whose samples are kept as interleaved frames, in the same order as they
+ * are stored in WAV and AIFF files:
+ *
+ *      frames[sampleIndex * getNumChannels() + channel]
+ *
+ * This suits code that plays or streams frames, as loading and saving are just a conversion
+ * of each sample to or from the file's format, with no reordering of the samples. Where the
+ * sample type matches the file (e.g. int16_t samples and a 16-bit WAV file), the sample
+ * data is read straight into the frames.
+ */
+template <class T>
+class InterleavedAudioFile
+{
+public:
+    
+    //=============================================================
+    /** Constructor */
+    InterleavedAudioFile();
+    
+    //=============================================================
+    /** Loads an audio file from a given file path.
+     * @Returns true if the file was successfully loaded
+     */
+    bool load (std::string filePath);
+    
+    /** Loads an audio file from data in memory */
+    bool loadFromMemory (std::vector<uint8_t>& fileData);
+    
+    /** Saves an audio file to a given file path.
+     * @Returns true if the file was successfully saved
+     */
+    bool save (std::string filePath, AudioFileFormat format = AudioFileFormat::Wave);
+    
+    //=============================================================
+    /** @Returns the sample rate */
+    uint32_t getSampleRate() const;
+    
+    /** @Returns the number of audio channels */
+    int getNumChannels() const;
+    
+    /** @Returns the bit depth of each sample */
+    int getBitDepth() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamplesPerChannel() const;
+    
+    /** @Returns the length in seconds of the audio file based on the number of samples and sample rate */
+    double getLengthInSeconds() const;
+    
+    /** @Returns true if the samples in the most recently loaded file were stored as floating point values */
+    bool isFloatingPointFormat() const;
+    
+    //=============================================================
+    /** Sets the number of channels and samples per channel, resizing the frames. As the frames
+     * are interleaved, existing audio is only kept if the number of channels is unchanged.
+     */
+    void setAudioBufferSize (int numChannels, int numSamples);
+    
+    /** Sets the bit depth for the audio file. If you use the save() function, this bit depth rate will be used */
+    void setBitDepth (int numBitsPerSample);
+    
+    /** Sets the sample rate for the audio file. If you use the save() function, this sample rate will be used */
+    void setSampleRate (uint32_t newSampleRate);
+    
+    /** Sets how floating point samples are dithered when they are saved at 8, 16 or 24 bits (see AudioFile::setDither()) */
+    void setDither (DitherType newDitherType);
+    
+    /** Sets how many threads encode the samples when a large file is saved (see AudioFile::setNumEncodingThreads()) */
+    void setNumEncodingThreads (int numThreads);
+    
+    //=============================================================
+    /** Sets whether the library should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+    
+    //=============================================================
+    /** The audio samples, as interleaved frames of getNumChannels() samples */
+    std::vector<T> frames;
+    
+    /** An optional iXML chunk that can be added to the file */
+    std::string iXMLChunk;
+    
+private:
+    
+    //=============================================================
+    bool readSampleData (std::ifstream& file, const AudioHeader<T>& header, const std::string& filePath);
+    void setFormat (const AudioHeader<T>& header);
+    
+    //=============================================================
+    void reportError (std::string errorMessage);
+    
+    //=============================================================
+    static constexpr size_t numBytesPerRead = 65536;
+    
+    //=============================================================
+    int numChannels {1};
+    uint32_t sampleRate {44100};
+    int bitDepth {16};
+    bool floatingPointFormat {false};
+    bool logErrorsToConsole {true};
+    DitherType ditherType {DitherType::None};
+    int numEncodingThreads {1};
+};
+
+#include "InterleavedAudioFile.inl"
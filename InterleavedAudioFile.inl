@@ -0,0 +1,240 @@
+//=======================================================================
+/** @file InterleavedAudioFile.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+InterleavedAudioFile<T>::InterleavedAudioFile()
+{
+}
+
+//=============================================================
+template <class T>
+bool InterleavedAudioFile<T>::load (std::string filePath)
+{
+    AudioHeader<T> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeader (filePath))
+        return false;
+    
+    std::ifstream file (filePath, std::ios::binary);
+    file.seekg (static_cast<std::streamoff> (header.getSampleDataOffset()));
+    
+    return readSampleData (file, header, filePath);
+}
+
+//=============================================================
+template <class T>
+bool InterleavedAudioFile<T>::loadFromMemory (std::vector<uint8_t>& fileData)
+{
+    AudioHeader<T> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeaderFromMemory (fileData.data(), fileData.size()))
+        return false;
+    
+    setFormat (header);
+    
+    frames.resize (static_cast<size_t> (header.getNumSamplesPerChannel()) * numChannels);
+    
+    AudioSampleConverter<T>::decodeSamples (fileData.data() + header.getSampleDataOffset(), static_cast<size_t> (bitDepth / 8), static_cast<int> (frames.size()),
+                                            bitDepth, header.getAudioFormat(), floatingPointFormat, frames.data());
+    return true;
+}
+
+//=============================================================
+template <class T>
+bool InterleavedAudioFile<T>::readSampleData (std::ifstream& file, const AudioHeader<T>& header, const std::string& filePath)
+{
+    size_t numBytesPerSample = static_cast<size_t> (header.getBitDepth() / 8);
+    size_t numSamples = static_cast<size_t> (header.getNumSamplesPerChannel()) * header.getNumChannels();
+    
+    std::vector<T> newFrames (numSamples);
+    
+    if (AudioSampleConverter<T>::isStoredAsIs (header.getBitDepth(), header.getAudioFormat(), header.isFloatingPointFormat()))
+    {
+        // the file holds exactly the bytes of the frames, so read them in place
+        file.read (reinterpret_cast<char*> (newFrames.data()), static_cast<std::streamsize> (numSamples * sizeof (T)));
+    }
+    else
+    {
+        // convert the sample data a piece at a time as it is read
+        std::vector<uint8_t> sampleData (std::min (numBytesPerRead / numBytesPerSample, numSamples) * numBytesPerSample);
+        
+        for (size_t start = 0; start < numSamples && file.good(); start += sampleData.size() / numBytesPerSample)
+        {
+            size_t numSamplesToRead = std::min (sampleData.size() / numBytesPerSample, numSamples - start);
+            file.read (reinterpret_cast<char*> (sampleData.data()), static_cast<std::streamsize> (numSamplesToRead * numBytesPerSample));
+            
+            AudioSampleConverter<T>::decodeSamples (sampleData.data(), numBytesPerSample, static_cast<int> (numSamplesToRead), header.getBitDepth(),
+                                                    header.getAudioFormat(), header.isFloatingPointFormat(), newFrames.data() + start);
+        }
+    }
+    
+    if (numSamples > 0 && ! file.good())
+    {
+        reportError ("ERROR: Couldn't read the samples from the file\n" + filePath);
+        return false;
+    }
+    
+    setFormat (header);
+    frames = std::move (newFrames);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::setFormat (const AudioHeader<T>& header)
+{
+    numChannels = header.getNumChannels();
+    sampleRate = header.getSampleRate();
+    bitDepth = header.getBitDepth();
+    floatingPointFormat = header.isFloatingPointFormat();
+    iXMLChunk = header.getIXMLChunk();
+}
+
+//=============================================================
+template <class T>
+bool InterleavedAudioFile<T>::save (std::string filePath, AudioFileFormat format)
+{
+    // AudioFile writes the file, reading the samples straight from the frames
+    AudioFile<T> writer;
+    writer.shouldLogErrorsToConsole (logErrorsToConsole);
+    writer.setSampleRate (sampleRate);
+    writer.setBitDepth (bitDepth);
+    writer.setDither (ditherType);
+    writer.setNumEncodingThreads (numEncodingThreads);
+    writer.iXMLChunk = iXMLChunk;
+    
+    return writer.save (filePath, AudioBufferView<const T>::interleaved (frames.data(), numChannels, getNumSamplesPerChannel()), format);
+}
+
+//=============================================================
+template <class T>
+uint32_t InterleavedAudioFile<T>::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//=============================================================
+template <class T>
+int InterleavedAudioFile<T>::getNumChannels() const
+{
+    return numChannels;
+}
+
+//=============================================================
+template <class T>
+int InterleavedAudioFile<T>::getBitDepth() const
+{
+    return bitDepth;
+}
+
+//=============================================================
+template <class T>
+int InterleavedAudioFile<T>::getNumSamplesPerChannel() const
+{
+    return numChannels > 0 ? static_cast<int> (frames.size() / numChannels) : 0;
+}
+
+//=============================================================
+template <class T>
+double InterleavedAudioFile<T>::getLengthInSeconds() const
+{
+    return (double)getNumSamplesPerChannel() / (double)sampleRate;
+}
+
+//=============================================================
+template <class T>
+bool InterleavedAudioFile<T>::isFloatingPointFormat() const
+{
+    return floatingPointFormat;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::setAudioBufferSize (int newNumChannels, int numSamples)
+{
+    if (newNumChannels != numChannels)
+    {
+        frames.assign (static_cast<size_t> (newNumChannels) * numSamples, T());
+        numChannels = newNumChannels;
+    }
+    else
+    {
+        frames.resize (static_cast<size_t> (numChannels) * numSamples, T());
+    }
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::setBitDepth (int numBitsPerSample)
+{
+    bitDepth = numBitsPerSample;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::setSampleRate (uint32_t newSampleRate)
+{
+    sampleRate = newSampleRate;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::setDither (DitherType newDitherType)
+{
+    ditherType = newDitherType;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::setNumEncodingThreads (int numThreads)
+{
+    numEncodingThreads = numThreads;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+void InterleavedAudioFile<T>::reportError (std::string errorMessage)
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
@@ -0,0 +1,185 @@
+//=======================================================================
+/** @file LazyAudioFile.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+#include "AudioHeader.h"
+#include "MemoryMappedFile.h"
+
+#include <string>
+
+//=============================================================
+/** Read-only access to an audio file that only decodes the samples you read.
+ *
+ * Loading a file only reads its header, and maps the file into memory rather than reading
+ * it, so the length, sample rate, etc. are available straight away however long the file
+ * is. Samples are decoded straight from the mapped file as they are read, so only the
+ * parts of the file that are actually read are ever loaded from disk.
+ *
+ * For code that needs the samples of a whole AudioFile, getAudioFile() decodes the
+ * complete file the first time it is called. Code that has its own buffers can decode
+ * into them with decodeInto(), which never allocates memory.
+ *
+ * This class uses MemoryMappedFile, so you need to link against the AudioFile library.
+ */
+template <class T>
+class LazyAudioFile
+{
+public:
+    
+    //=============================================================
+    /** Constructor */
+    LazyAudioFile();
+    
+    LazyAudioFile (const LazyAudioFile&) = delete;
+    LazyAudioFile& operator= (const LazyAudioFile&) = delete;
+    
+    //=============================================================
+    /** Reads the header of the audio file at the given path and maps the file into memory.
+     * No samples are decoded.
+     * @Returns true if the file was successfully opened
+     */
+    bool load (const std::string& filePath);
+    
+    /** Reads the header of an audio file that is already in memory. The data isn't copied,
+     * so it must stay valid until the file is cleared or another file is loaded.
+     * @Returns true if the data holds a complete audio file
+     */
+    bool loadFromMemory (const uint8_t* fileData, size_t fileSize);
+    
+    /** Closes the file and removes any decoded audio */
+    void clear();
+    
+    //=============================================================
+    /** @Returns the sample rate */
+    uint32_t getSampleRate() const;
+    
+    /** @Returns the number of audio channels */
+    int getNumChannels() const;
+    
+    /** @Returns the bit depth of each sample */
+    int getBitDepth() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamplesPerChannel() const;
+    
+    /** @Returns the length in seconds of the audio */
+    double getLengthInSeconds() const;
+    
+    /** @Returns true if the samples in the file are stored as floating point values */
+    bool isFloatingPointFormat() const;
+    
+    //=============================================================
+    /** @Returns a single sample. If you need more than a handful of samples,
+     * readSamples() is much faster
+     */
+    T getSample (int channel, int sampleIndex) const;
+    
+    /** Decodes a range of samples from one channel into the destination buffer, which
+     * must have room for numSamples samples. The range must lie within the audio.
+     * This can be called from several threads at once.
+     */
+    void readSamples (int channel, int startSample, int numSamples, T* destination) const;
+    
+    //=============================================================
+    /** Decodes all of the audio straight into your own buffers, one per channel. No memory
+     * is allocated (unless an error is logged), so once a file is loaded this can be used on
+     * a thread that mustn't block. This can be called from several threads at once.
+     * @param channels pointers to the buffers for each channel
+     * @param numChannels the number of buffers, which must be the number of channels in the file
+     * @param capacityInSamples the number of samples each buffer has room for
+     * @Returns true if the audio was decoded, or false (without writing to the buffers) if the
+     * buffers don't match the file or are too small
+     */
+    bool decodeInto (T* const* channels, int numChannels, int capacityInSamples) const;
+    
+    /** Decodes numSamples samples of each channel, from startSample onwards, into your own buffers.
+     * The range must lie within the audio.
+     */
+    bool decodeInto (int startSample, int numSamples, T* const* channels, int numChannels, int capacityInSamples) const;
+    
+    /** Decodes all of the audio into a single buffer of interleaved frames
+     * @param frameStride the number of samples from the start of one frame to the start of the
+     * next, which must be at least the number of channels in the file
+     * @param capacityInFrames the number of frames the buffer has room for
+     * @Returns true if the audio was decoded, or false (without writing to the buffer) if the
+     * buffer is too small
+     */
+    bool decodeInterleavedInto (T* destination, int frameStride, int capacityInFrames) const;
+    
+    /** Decodes numSamples frames, from startSample onwards, into a buffer of interleaved frames.
+     * The range must lie within the audio.
+     */
+    bool decodeInterleavedInto (int startSample, int numSamples, T* destination, int frameStride, int capacityInFrames) const;
+    
+    /** Decodes samples into a view of your own buffers, filling the view with the samples from
+     * startSample onwards. The view must have the same number of channels as the file.
+     */
+    bool decodeInto (const AudioBufferView<T>& destination, int startSample = 0) const;
+    
+    //=============================================================
+    /** Returns the whole file as an AudioFile. All of the samples are decoded the first
+     * time this is called, and the same AudioFile is returned after that. If you need to
+     * modify the audio, copy the AudioFile (which doesn't copy any samples until you do).
+     */
+    const AudioFile<T>& getAudioFile();
+    
+    /** @Returns true if getAudioFile() has decoded all of the samples */
+    bool isFullyDecoded() const;
+    
+    //=============================================================
+    /** Sets whether the file should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+    
+private:
+    
+    //=============================================================
+    bool checkSampleDataIsComplete();
+    bool checkRange (int startSample, int numSamples, int capacityInFrames) const;
+    const uint8_t* getFrame (int sampleIndex) const;
+    
+    //=============================================================
+    void reportError (std::string errorMessage) const;
+    
+    //=============================================================
+    static constexpr int numFramesPerStridedBlock = 256;
+    
+    //=============================================================
+    AudioHeader<T> header;
+    MemoryMappedFile file;
+    const uint8_t* data {nullptr};
+    size_t dataSize {0};
+    AudioFile<T> audioFile;
+    bool loaded {false};
+    bool fullyDecoded {false};
+    bool logErrorsToConsole {true};
+};
+
+#include "LazyAudioFile.inl"
@@ -0,0 +1,364 @@
+//=======================================================================
+/** @file LazyAudioFile.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+LazyAudioFile<T>::LazyAudioFile()
+{
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::load (const std::string& filePath)
+{
+    clear();
+    
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeader (filePath))
+        return false;
+    
+    if (! file.open (filePath))
+    {
+        reportError ("ERROR: File doesn't exist or otherwise can't load file\n" + filePath);
+        return false;
+    }
+    
+    data = file.data();
+    dataSize = file.size();
+    
+    // the header has checked the samples are in the file, but it may have changed since
+    return checkSampleDataIsComplete();
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::loadFromMemory (const uint8_t* fileData, size_t fileSize)
+{
+    clear();
+    
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (fileData == nullptr || ! header.loadHeaderFromMemory (fileData, fileSize))
+        return false;
+    
+    data = fileData;
+    dataSize = fileSize;
+    
+    return checkSampleDataIsComplete();
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::checkSampleDataIsComplete()
+{
+    uint64_t numSampleDataBytes = static_cast<uint64_t> (header.getNumSamplesPerChannel()) * header.getNumChannels() * (header.getBitDepth() / 8);
+    
+    if (header.getSampleDataOffset() + numSampleDataBytes > dataSize)
+    {
+        reportError ("ERROR: read file error as the metadata indicates more samples than there are in the file data");
+        clear();
+        return false;
+    }
+    
+    loaded = true;
+    return true;
+}
+
+//=============================================================
+template <class T>
+void LazyAudioFile<T>::clear()
+{
+    file.close();
+    data = nullptr;
+    dataSize = 0;
+    header = AudioHeader<T>();
+    audioFile = AudioFile<T>();
+    loaded = false;
+    fullyDecoded = false;
+}
+
+//=============================================================
+template <class T>
+uint32_t LazyAudioFile<T>::getSampleRate() const
+{
+    return loaded ? header.getSampleRate() : 0;
+}
+
+//=============================================================
+template <class T>
+int LazyAudioFile<T>::getNumChannels() const
+{
+    return loaded ? header.getNumChannels() : 0;
+}
+
+//=============================================================
+template <class T>
+int LazyAudioFile<T>::getBitDepth() const
+{
+    return loaded ? header.getBitDepth() : 0;
+}
+
+//=============================================================
+template <class T>
+int LazyAudioFile<T>::getNumSamplesPerChannel() const
+{
+    return loaded ? header.getNumSamplesPerChannel() : 0;
+}
+
+//=============================================================
+template <class T>
+double LazyAudioFile<T>::getLengthInSeconds() const
+{
+    return loaded ? header.getLengthInSeconds() : 0.;
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::isFloatingPointFormat() const
+{
+    return loaded && header.isFloatingPointFormat();
+}
+
+//=============================================================
+template <class T>
+T LazyAudioFile<T>::getSample (int channel, int sampleIndex) const
+{
+    T sample;
+    readSamples (channel, sampleIndex, 1, &sample);
+    return sample;
+}
+
+//=============================================================
+template <class T>
+void LazyAudioFile<T>::readSamples (int channel, int startSample, int numSamples, T* destination) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    assert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= getNumSamplesPerChannel());
+    
+    size_t numBytesPerSample = static_cast<size_t> (getBitDepth() / 8);
+    size_t numBytesPerFrame = numBytesPerSample * getNumChannels();
+    
+    const uint8_t* source = getFrame (startSample) + numBytesPerSample * channel;
+    
+    AudioSampleConverter<T>::decodeSamples (source, numBytesPerFrame, numSamples, getBitDepth(), header.getAudioFormat(), isFloatingPointFormat(), destination);
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::decodeInto (T* const* channels, int numChannels, int capacityInSamples) const
+{
+    return decodeInto (0, getNumSamplesPerChannel(), channels, numChannels, capacityInSamples);
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::decodeInto (int startSample, int numSamples, T* const* channels, int numChannels, int capacityInSamples) const
+{
+    if (! checkRange (startSample, numSamples, capacityInSamples))
+        return false;
+    
+    if (numChannels != getNumChannels() || channels == nullptr)
+    {
+        reportError ("ERROR: the number of buffers to decode into doesn't match the number of channels in the file");
+        return false;
+    }
+    
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        if (channels[channel] == nullptr)
+        {
+            reportError ("ERROR: one of the buffers to decode into is null");
+            return false;
+        }
+    }
+    
+    return decodeInto (AudioBufferView<T> (channels, numChannels, numSamples), startSample);
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::decodeInterleavedInto (T* destination, int frameStride, int capacityInFrames) const
+{
+    return decodeInterleavedInto (0, getNumSamplesPerChannel(), destination, frameStride, capacityInFrames);
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::decodeInterleavedInto (int startSample, int numSamples, T* destination, int frameStride, int capacityInFrames) const
+{
+    if (! checkRange (startSample, numSamples, capacityInFrames))
+        return false;
+    
+    if (frameStride < getNumChannels() || destination == nullptr)
+    {
+        reportError ("ERROR: the frame stride of the buffer to decode into is smaller than the number of channels in the file");
+        return false;
+    }
+    
+    return decodeInto (AudioBufferView<T>::interleaved (destination, getNumChannels(), numSamples, frameStride), startSample);
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::decodeInto (const AudioBufferView<T>& destination, int startSample) const
+{
+    int numSamples = destination.getNumSamples();
+    
+    if (! checkRange (startSample, numSamples, numSamples))
+        return false;
+    
+    if (destination.getNumChannels() != getNumChannels())
+    {
+        reportError ("ERROR: the number of buffers to decode into doesn't match the number of channels in the file");
+        return false;
+    }
+    
+    size_t numBytesPerSample = static_cast<size_t> (getBitDepth() / 8);
+    size_t numBytesPerFrame = numBytesPerSample * getNumChannels();
+    bool isContiguous = destination.getSampleStride() == 1;
+    
+    // frames are decoded a tile at a time, so they stay in the cache while each channel is
+    // decoded. Channels that aren't contiguous are decoded into a block on the stack, then
+    // written to the destination
+    int numFramesPerTile = std::max (static_cast<int> (AudioSampleConverter<T>::numBytesPerTile / numBytesPerFrame), 16);
+    
+    if (! isContiguous)
+        numFramesPerTile = std::min (numFramesPerTile, numFramesPerStridedBlock);
+    
+    T block[numFramesPerStridedBlock];
+    
+    for (int start = 0; start < numSamples; start += numFramesPerTile)
+    {
+        int numFramesInTile = std::min (numFramesPerTile, numSamples - start);
+        const uint8_t* frames = getFrame (startSample + start);
+        
+        for (int channel = 0; channel < getNumChannels(); channel++)
+        {
+            T* channelDestination = destination.getPointer (channel, start);
+            
+            AudioSampleConverter<T>::decodeSamples (frames + numBytesPerSample * channel, numBytesPerFrame, numFramesInTile, getBitDepth(),
+                                                    header.getAudioFormat(), isFloatingPointFormat(), isContiguous ? channelDestination : block);
+            
+            if (! isContiguous)
+            {
+                for (int i = 0; i < numFramesInTile; i++)
+                    channelDestination[i * destination.getSampleStride()] = block[i];
+            }
+        }
+    }
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::checkRange (int startSample, int numSamples, int capacityInFrames) const
+{
+    if (! loaded)
+    {
+        reportError ("ERROR: no audio file is loaded to decode");
+        return false;
+    }
+    
+    if (startSample < 0 || numSamples < 0 || startSample > getNumSamplesPerChannel() - numSamples)
+    {
+        reportError ("ERROR: the range of samples to decode isn't inside the audio");
+        return false;
+    }
+    
+    if (numSamples > capacityInFrames)
+    {
+        reportError ("ERROR: the buffer to decode into is too small, as the audio needs " + std::to_string (numSamples) + " samples per channel");
+        return false;
+    }
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+const uint8_t* LazyAudioFile<T>::getFrame (int sampleIndex) const
+{
+    size_t numBytesPerFrame = static_cast<size_t> (getNumChannels() * (getBitDepth() / 8));
+    return data + header.getSampleDataOffset() + numBytesPerFrame * sampleIndex;
+}
+
+//=============================================================
+template <class T>
+const AudioFile<T>& LazyAudioFile<T>::getAudioFile()
+{
+    if (loaded && ! fullyDecoded)
+    {
+        // decode into plain vectors, which are then moved into the buffer without copying
+        std::vector<std::vector<T>> decodedSamples (getNumChannels());
+        std::vector<T*> channels;
+        
+        for (auto& channelSamples : decodedSamples)
+        {
+            channelSamples.resize (getNumSamplesPerChannel());
+            channels.push_back (channelSamples.data());
+        }
+        
+        decodeInto (channels.data(), getNumChannels(), getNumSamplesPerChannel());
+        
+        audioFile.setAudioBuffer (std::move (decodedSamples));
+        audioFile.setSampleRate (getSampleRate());
+        audioFile.setBitDepth (getBitDepth());
+        audioFile.iXMLChunk = header.getIXMLChunk();
+        fullyDecoded = true;
+    }
+    
+    return audioFile;
+}
+
+//=============================================================
+template <class T>
+bool LazyAudioFile<T>::isFullyDecoded() const
+{
+    return fullyDecoded;
+}
+
+//=============================================================
+template <class T>
+void LazyAudioFile<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+void LazyAudioFile<T>::reportError (std::string errorMessage) const
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
@@ -10,15 +10,31 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <cerrno>
+#endif
+
+#if defined(_WIN32)
+static std::string getSharedMemoryObjectName(const std::string& name)
+{
+    return "Local\\" + name;
+}
+#else
+static std::string getSharedMemoryObjectName(const std::string& name)
+{
+    return "/" + name;
+}
 #endif
 
 MemoryMappedFile::MemoryMappedFile()
-    : mappedData(nullptr)
 #if defined(_WIN32)
-    , fileHandle(nullptr)
+    : fileHandle(nullptr)
     , mappingHandle(nullptr)
+#else
+    : fileDescriptor(-1)
 #endif
+    , mappedData(nullptr)
     , fileSize(0)
+    , isWritable(false)
 {
 }
 
@@ -29,12 +45,15 @@ MemoryMappedFile::~MemoryMappedFile()
 
 bool MemoryMappedFile::open(const std::string& filePath)
 {
+    close();
+
 #if defined(_WIN32)
     fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
     if (fileHandle == INVALID_HANDLE_VALUE)
     {
         std::cerr << "ERROR: Could not open file: " << filePath << std::endl;
+        fileHandle = nullptr;
         return false;
     }
 
@@ -44,45 +63,229 @@ bool MemoryMappedFile::open(const std::string& filePath)
     if (!mappingHandle)
     {
         std::cerr << "ERROR: Could not create file mapping: " << filePath << std::endl;
-        CloseHandle(fileHandle);
+        close();
+        return false;
+    }
+#else
+    fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        std::cerr << "ERROR: Could not open file: " << filePath << std::endl;
         return false;
     }
 
-    mappedData = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
-    if (!mappedData)
+    struct stat statBuf;
+    if (fstat(fileDescriptor, &statBuf) < 0)
     {
-        std::cerr << "ERROR: Could not map view of file: " << filePath << std::endl;
-        CloseHandle(mappingHandle);
-        CloseHandle(fileHandle);
+        std::cerr << "ERROR: Could not get file size: " << filePath << std::endl;
+        close();
+        return false;
+    }
+
+    fileSize = statBuf.st_size;
+#endif
+
+    return mapView(filePath, false);
+}
+
+bool MemoryMappedFile::create(const std::string& filePath, size_t numBytes)
+{
+    close();
+
+#if defined(_WIN32)
+    fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                             CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "ERROR: Could not create file: " << filePath << std::endl;
+        fileHandle = nullptr;
+        return false;
+    }
+
+    // creating a mapping larger than the file extends the file to that size
+    uint64_t size = static_cast<uint64_t>(numBytes);
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READWRITE,
+                                       static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), NULL);
+    if (!mappingHandle)
+    {
+        std::cerr << "ERROR: Could not create file mapping: " << filePath << std::endl;
+        close();
         return false;
     }
 #else
-    fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    fileDescriptor = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
     if (fileDescriptor < 0)
     {
-        std::cerr << "ERROR: Could not open file: " << filePath << std::endl;
+        std::cerr << "ERROR: Could not create file: " << filePath << std::endl;
+        return false;
+    }
+
+    if (ftruncate(fileDescriptor, static_cast<off_t>(numBytes)) < 0)
+    {
+        std::cerr << "ERROR: Could not resize file: " << filePath << std::endl;
+        close();
+        return false;
+    }
+
+#if defined(__linux__)
+    // allocating the blocks now means running out of disk space is an error here, rather than
+    // a signal when the mapping is written to. Not every file system supports this, though
+    if (fallocate(fileDescriptor, 0, 0, static_cast<off_t>(numBytes)) < 0 && errno == ENOSPC)
+    {
+        std::cerr << "ERROR: Not enough space for file: " << filePath << std::endl;
+        close();
+        return false;
+    }
+#endif
+#endif
+
+    fileSize = numBytes;
+    return mapView(filePath, true);
+}
+
+bool MemoryMappedFile::flush()
+{
+    if (!mappedData || !isWritable)
+        return false;
+
+#if defined(_WIN32)
+    return FlushViewOfFile(mappedData, 0) && (!fileHandle || FlushFileBuffers(fileHandle));
+#else
+    return msync(const_cast<uint8_t*>(mappedData), fileSize, MS_SYNC) == 0;
+#endif
+}
+
+bool MemoryMappedFile::createSharedMemory(const std::string& name, size_t numBytes)
+{
+    close();
+
+    std::string objectName = getSharedMemoryObjectName(name);
+
+#if defined(_WIN32)
+    uint64_t size = static_cast<uint64_t>(numBytes);
+    mappingHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                       static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF),
+                                       objectName.c_str());
+    if (!mappingHandle)
+        return false;
+
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        close();
         return false;
     }
+#else
+    // an existing object with this name is expected when another process got there
+    // first, so we leave it to the caller to decide whether that is an error
+    fileDescriptor = shm_open(objectName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fileDescriptor < 0)
+        return false;
+
+    if (ftruncate(fileDescriptor, static_cast<off_t>(numBytes)) < 0)
+    {
+        std::cerr << "ERROR: Could not resize shared memory: " << name << std::endl;
+        close();
+        shm_unlink(objectName.c_str());
+        return false;
+    }
+#endif
+
+    fileSize = numBytes;
+
+    if (!mapView(name, true))
+    {
+        removeSharedMemory(name);
+        return false;
+    }
+
+    return true;
+}
+
+bool MemoryMappedFile::openSharedMemory(const std::string& name, bool writable)
+{
+    close();
+
+    std::string objectName = getSharedMemoryObjectName(name);
+
+#if defined(_WIN32)
+    mappingHandle = OpenFileMappingA(writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, FALSE, objectName.c_str());
+    if (!mappingHandle)
+        return false;
+
+    if (!mapView(name, writable))
+        return false;
+
+    // the size of a named mapping isn't stored anywhere, so use the size of the
+    // mapped region (which is rounded up to a whole number of pages)
+    MEMORY_BASIC_INFORMATION info;
+    if (VirtualQuery(mappedData, &info, sizeof(info)) == 0)
+    {
+        close();
+        return false;
+    }
+
+    fileSize = info.RegionSize;
+    return true;
+#else
+    fileDescriptor = shm_open(objectName.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if (fileDescriptor < 0)
+        return false;
 
     struct stat statBuf;
     if (fstat(fileDescriptor, &statBuf) < 0)
     {
-        std::cerr << "ERROR: Could not get file size: " << filePath << std::endl;
-        ::close(fileDescriptor);
+        close();
         return false;
     }
 
     fileSize = statBuf.st_size;
 
-    mappedData = static_cast<const uint8_t*>(mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fileDescriptor, 0));
-    if (mappedData == MAP_FAILED)
+    // the creator may not have sized the object yet
+    if (fileSize == 0)
     {
-        std::cerr << "ERROR: Could not memory-map file: " << filePath << std::endl;
-        ::close(fileDescriptor);
-        mappedData = nullptr;
+        close();
+        return false;
+    }
+
+    return mapView(name, writable);
+#endif
+}
+
+bool MemoryMappedFile::removeSharedMemory(const std::string& name)
+{
+#if defined(_WIN32)
+    (void)name;
+    return true;
+#else
+    return shm_unlink(getSharedMemoryObjectName(name).c_str()) == 0;
+#endif
+}
+
+bool MemoryMappedFile::mapView(const std::string& description, bool writable)
+{
+#if defined(_WIN32)
+    DWORD access = writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ;
+    mappedData = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, access, 0, 0, 0));
+    if (!mappedData)
+    {
+        std::cerr << "ERROR: Could not map view of file: " << description << std::endl;
+        close();
         return false;
     }
+#else
+    int protection = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* mapping = mmap(nullptr, fileSize, protection, MAP_SHARED, fileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "ERROR: Could not memory-map file: " << description << std::endl;
+        close();
+        return false;
+    }
+
+    mappedData = static_cast<const uint8_t*>(mapping);
 #endif
+
+    isWritable = writable;
     return true;
 }
 
@@ -116,6 +319,8 @@ void MemoryMappedFile::close()
         fileDescriptor = -1;
     }
 #endif
+    fileSize = 0;
+    isWritable = false;
 }
 
 const uint8_t* MemoryMappedFile::data() const
@@ -123,6 +328,11 @@ const uint8_t* MemoryMappedFile::data() const
     return mappedData;
 }
 
+uint8_t* MemoryMappedFile::writableData()
+{
+    return isWritable ? const_cast<uint8_t*>(mappedData) : nullptr;
+}
+
 size_t MemoryMappedFile::size() const
 {
     return fileSize;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
+#include <cstddef>
 
 class MemoryMappedFile
 {
@@ -8,22 +10,54 @@ public:
     MemoryMappedFile();
     ~MemoryMappedFile();
 
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    /** Maps an existing file into memory for reading */
     bool open(const std::string& filePath);
+
+    /** Creates a file of the given size (replacing any file already at the path) and maps it
+     *  for reading and writing. The file's space is allocated up front where the platform allows it.
+     */
+    bool create(const std::string& filePath, size_t numBytes);
+
+    /** Creates a new named shared memory object of the given size and maps it for reading and writing.
+     *  The memory is zero-initialised. Fails if an object with this name already exists.
+     */
+    bool createSharedMemory(const std::string& name, size_t numBytes);
+
+    /** Maps an existing named shared memory object, optionally for writing */
+    bool openSharedMemory(const std::string& name, bool writable = false);
+
+    /** Removes a named shared memory object. Anything that already has it mapped can keep using it.
+     *  On Windows, shared memory is removed automatically once nothing has it open, so this does nothing.
+     */
+    static bool removeSharedMemory(const std::string& name);
+
+    /** Writes any changes to a writable mapping back to the file, and waits until they are on disk */
+    bool flush();
+
     void close();
 
     const uint8_t* data() const;
+
+    /** @Returns a writable pointer to the mapped data, or nullptr if it was mapped read-only */
+    uint8_t* writableData();
+
     size_t size() const;
 
 private:
+    bool mapView(const std::string& description, bool writable);
+
 #if defined(_WIN32)
     // Windows-specific members
     void* fileHandle;
     void* mappingHandle;
-    const uint8_t* mappedData;
 #else
     // POSIX-specific members
     int fileDescriptor;
-    const uint8_t* mappedData;
 #endif
+    const uint8_t* mappedData;
     size_t fileSize;
+    bool isWritable;
 };
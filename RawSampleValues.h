@@ -0,0 +1,117 @@
+//=======================================================================
+/** @file RawSampleValues.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+//=============================================================
+/** Loads the raw sample values of an audio file in memory: the integer sample values
+ * of an 8, 16, 24 or 32-bit PCM file, or the bit patterns of the samples of a 32-bit
+ * floating point file (in which case rawAudio.isFloatingPointFormat() returns true).
+ *
+ * This is useful for storing audio in some other form without losing anything, as
+ * the samples of an AudioFile<T> can be reproduced exactly from these values.
+ * @Returns true if the file was successfully loaded
+ */
+inline bool loadRawSampleValues (std::vector<uint8_t>& fileData, AudioFile<int32_t>& rawAudio, bool logErrorsToConsole = true)
+{
+    rawAudio.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    AudioHeader<int32_t> header;
+    header.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    if (! header.loadHeaderFromMemory (fileData.data(), fileData.size()))
+        return false;
+    
+    if (! header.isFloatingPointFormat())
+        return rawAudio.loadFromMemory (fileData);
+    
+    // integer types don't keep floating point samples intact, so the bit patterns of the samples
+    // are read straight from the data chunk, exactly as if they were 32-bit integer samples
+    int numChannelsInFile = header.getNumChannels();
+    int numSamples = header.getNumSamplesPerChannel();
+    uint64_t sampleDataOffset = header.getSampleDataOffset();
+    uint64_t numSampleDataBytes = static_cast<uint64_t> (numChannelsInFile) * static_cast<uint64_t> (numSamples) * sizeof (int32_t);
+    
+    if (numChannelsInFile < 1 || sampleDataOffset + numSampleDataBytes > fileData.size())
+    {
+        rawAudio.reportError ("ERROR: read file error as the metadata indicates more samples than there are in the file data");
+        return false;
+    }
+    
+    std::vector<int> channels;
+    
+    if (! rawAudio.getChannelsToDecode (numChannelsInFile, channels))
+        return false;
+    
+    std::vector<std::vector<int32_t>> rawValues (channels.size(), std::vector<int32_t> (numSamples));
+    std::vector<int32_t*> destinations;
+    
+    for (auto& channelValues : rawValues)
+        destinations.push_back (channelValues.data());
+    
+    AudioSampleConverter<int32_t>::decodeFrames (fileData.data() + sampleDataOffset, numChannelsInFile, numSamples, 32, header.getAudioFormat(), false,
+                                                 channels.data(), static_cast<int> (channels.size()), destinations.data());
+    
+    rawAudio.samples = std::move (rawValues);
+    rawAudio.audioFileFormat = header.getAudioFormat();
+    rawAudio.sampleRate = header.getSampleRate();
+    rawAudio.bitDepth = header.getBitDepth();
+    rawAudio.floatingPointFormat = true;
+    rawAudio.iXMLChunk = header.getIXMLChunk();
+    
+    return true;
+}
+
+//=============================================================
+/** Loads the raw sample values of an audio file from a given file path.
+ * @see loadRawSampleValues (std::vector<uint8_t>&, AudioFile<int32_t>&, bool)
+ */
+inline bool loadRawSampleValues (const std::string& filePath, AudioFile<int32_t>& rawAudio, bool logErrorsToConsole = true)
+{
+    std::ifstream file (filePath, std::ios::binary);
+    
+    if (! file.good())
+    {
+        if (logErrorsToConsole)
+            std::cout << "ERROR: File doesn't exist or otherwise can't load file\n" << filePath << std::endl;
+        
+        return false;
+    }
+    
+    std::vector<uint8_t> fileData ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    
+    return loadRawSampleValues (fileData, rawAudio, logErrorsToConsole);
+}
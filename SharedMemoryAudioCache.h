@@ -0,0 +1,246 @@
+//=======================================================================
+/** @file SharedMemoryAudioCache.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+#include "AudioFileCache.h"
+#include "MemoryMappedFile.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+//=============================================================
+/** A cache of decoded audio that is shared between processes.
+ *
+ * Decoded audio is stored as planar buffers in named shared memory, so when several
+ * processes on the same machine use a cache with the same name, a file only needs to
+ * be decoded (and held in memory) once - every other process simply maps the buffers
+ * that are already there. The cache is found through a small, fixed-size index (also
+ * in shared memory) which is updated with atomic operations rather than locks.
+ *
+ * As with AudioFileCache, files are identified by their path, modification time and
+ * size. Each path has one slot in the index, so when a file changes, the next load
+ * decodes it into the same slot and releases the shared audio of the old version
+ * (processes that have the old audio mapped can keep using it). Shared audio stays in
+ * memory until remove() is called for the cache, even after every process using it has
+ * exited (on Windows, shared memory is released once no process has it open).
+ *
+ * This class uses MemoryMappedFile, so you need to link against the AudioFile library.
+ */
+template <class T>
+class SharedMemoryAudioCache
+{
+public:
+
+    //=============================================================
+    /** Read-only decoded audio handed out by the cache */
+    class Entry
+    {
+    public:
+        /** @Returns the sample rate */
+        uint32_t getSampleRate() const;
+
+        /** @Returns the number of audio channels */
+        int getNumChannels() const;
+
+        /** @Returns the bit depth of the file the audio was decoded from */
+        int getBitDepth() const;
+
+        /** @Returns the number of samples per channel */
+        int getNumSamplesPerChannel() const;
+
+        /** @Returns the length in seconds of the audio */
+        double getLengthInSeconds() const;
+
+        /** @Returns a pointer to the samples of a given channel */
+        const T* getReadPointer (int channel) const;
+
+        /** @Returns true if the samples live in shared memory, or false if the cache
+         * couldn't share them and they were decoded into this process' memory instead
+         */
+        bool isInSharedMemory() const;
+
+        /** Copies the audio into an AudioFile */
+        void copyTo (AudioFile<T>& audioFile) const;
+
+    private:
+        friend class SharedMemoryAudioCache;
+
+        std::shared_ptr<MemoryMappedFile> segment;
+        std::vector<std::vector<T>> privateSamples;
+        std::vector<const T*> channels;
+        uint64_t numSamplesPerChannel = 0;
+        uint32_t sampleRate = 0;
+        int bitDepth = 0;
+    };
+
+    typedef std::shared_ptr<const Entry> SharedEntry;
+
+    //=============================================================
+    /** Counters describing how this process has used the cache */
+    struct Statistics
+    {
+        uint64_t hits = 0;           // audio that was already in shared memory
+        uint64_t misses = 0;         // audio this process decoded and shared
+        uint64_t privateLoads = 0;   // audio this process decoded but couldn't share
+    };
+
+    //=============================================================
+    /** Connects to the cache with the given name, creating it if no other process has yet.
+     * @param cacheName a name that is unique to your application. Keep it short, as some
+     * platforms (e.g. macOS) limit shared memory names to 31 characters
+     * @param numIndexSlots the maximum number of different file paths the cache can hold.
+     * This is only used by the process that creates the cache
+     */
+    SharedMemoryAudioCache (const std::string& cacheName, uint32_t numIndexSlots = 4096);
+
+    SharedMemoryAudioCache (const SharedMemoryAudioCache&) = delete;
+    SharedMemoryAudioCache& operator= (const SharedMemoryAudioCache&) = delete;
+
+    //=============================================================
+    /** @Returns true if the cache is connected to its shared index. If not, files are
+     * still loaded but are decoded into this process' memory.
+     */
+    bool isConnected() const;
+
+    /** Returns decoded audio for the file at the given path. If another process has already
+     * decoded the file, its shared buffers are mapped into this process rather than decoding
+     * the file again.
+     * @Returns the decoded audio, or nullptr if the file couldn't be loaded
+     */
+    SharedEntry load (const std::string& filePath);
+
+    //=============================================================
+    /** @Returns the counters for this process */
+    Statistics getStatistics() const;
+
+    /** Sets whether the cache should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+
+    /** Sets how long to wait for another process that is decoding the same file before
+     * giving up and decoding it privately. By default this is 10 seconds.
+     */
+    void setMaximumWaitTimeInMilliseconds (int milliseconds);
+
+    //=============================================================
+    /** Removes the shared index and all shared audio for the cache with the given name.
+     * Processes that already have audio mapped can keep using it, but this should only
+     * be called when no processes are using the cache.
+     */
+    static void remove (const std::string& cacheName);
+
+private:
+
+    //=============================================================
+    enum SlotState : uint32_t
+    {
+        Claimed = 0,
+        Decoding = 1,
+        Ready = 2,
+        Failed = 3
+    };
+
+    struct IndexSlot
+    {
+        std::atomic<uint64_t> key;      // the file path, or zero if the slot has never been used
+        std::atomic<uint64_t> status;   // the slot state, its generation, and the process that set it
+        std::atomic<uint64_t> version;  // the file's path, modification time and size
+    };
+
+    struct IndexHeader
+    {
+        std::atomic<uint64_t> magic;    // written last by the process that creates the index
+        uint32_t numSlots;
+        uint32_t reserved;
+    };
+
+    struct SegmentHeader
+    {
+        uint64_t magic;
+        uint64_t key;
+        uint64_t numSamplesPerChannel;
+        uint64_t channelStride;
+        uint32_t numChannels;
+        uint32_t sampleRate;
+        uint32_t bitDepth;
+        uint32_t sampleType;    // see getSampleType()
+    };
+
+    static_assert (std::atomic<uint64_t>::is_always_lock_free, "The shared index needs lock-free atomics");
+
+    //=============================================================
+    static constexpr uint64_t indexMagic = 0x4146534d494e4432ULL;
+    static constexpr uint64_t segmentMagic = 0x4146534d53454732ULL;
+    static constexpr size_t alignment = 64;
+    static constexpr size_t indexHeaderSize = alignment;
+
+    //=============================================================
+    static std::string getIndexName (const std::string& cacheName);
+    static std::string getSegmentName (const std::string& cacheName, uint64_t key);
+    static uint32_t getSampleType();
+    static uint64_t getKey (const AudioFileIdentity& identity);
+    static uint64_t getPathKey (const AudioFileIdentity& identity);
+    static uint64_t makeStatus (SlotState state, uint32_t generation, uint32_t processId);
+    static SlotState getState (uint64_t status);
+    static uint32_t getGeneration (uint64_t status);
+    static uint32_t getProcessId (uint64_t status);
+    static uint32_t getCurrentProcessId();
+    static bool isProcessAlive (uint32_t processId);
+
+    //=============================================================
+    bool connectToIndex (uint32_t numIndexSlots);
+    IndexSlot* getSlots();
+
+    SharedEntry waitForSlot (IndexSlot& slot, uint64_t key, const AudioFileIdentity& identity);
+    bool claimSlot (IndexSlot& slot, uint64_t& status, uint64_t version, uint64_t key);
+    SharedEntry decodeIntoSlot (IndexSlot& slot, uint64_t status, uint64_t key, const AudioFileIdentity& identity);
+    SharedEntry attachToSegment (uint64_t key);
+    SharedEntry loadPrivately (const std::string& filePath);
+    SharedEntry createPrivateEntry (AudioFile<T>& audioFile);
+
+    //=============================================================
+    void reportError (std::string errorMessage);
+
+    //=============================================================
+    std::string name;
+    MemoryMappedFile index;
+    uint32_t numSlots {0};
+    bool connected {false};
+    bool logErrorsToConsole {true};
+    int maximumWaitTimeInMilliseconds {10000};
+
+    std::atomic<uint64_t> numHits {0};
+    std::atomic<uint64_t> numMisses {0};
+    std::atomic<uint64_t> numPrivateLoads {0};
+};
+
+#include "SharedMemoryAudioCache.inl"
@@ -0,0 +1,611 @@
+//=======================================================================
+/** @file SharedMemoryAudioCache.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <cstdio>
+
+#if defined (_WIN32)
+    #include <process.h>
+#else
+    #include <unistd.h>
+    #include <signal.h>
+    #include <cerrno>
+#endif
+
+//=============================================================
+template <class T>
+uint32_t SharedMemoryAudioCache<T>::Entry::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//=============================================================
+template <class T>
+int SharedMemoryAudioCache<T>::Entry::getNumChannels() const
+{
+    return static_cast<int> (channels.size());
+}
+
+//=============================================================
+template <class T>
+int SharedMemoryAudioCache<T>::Entry::getBitDepth() const
+{
+    return bitDepth;
+}
+
+//=============================================================
+template <class T>
+int SharedMemoryAudioCache<T>::Entry::getNumSamplesPerChannel() const
+{
+    return static_cast<int> (numSamplesPerChannel);
+}
+
+//=============================================================
+template <class T>
+double SharedMemoryAudioCache<T>::Entry::getLengthInSeconds() const
+{
+    return (double) numSamplesPerChannel / (double) sampleRate;
+}
+
+//=============================================================
+template <class T>
+const T* SharedMemoryAudioCache<T>::Entry::getReadPointer (int channel) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    return channels[channel];
+}
+
+//=============================================================
+template <class T>
+bool SharedMemoryAudioCache<T>::Entry::isInSharedMemory() const
+{
+    return segment != nullptr;
+}
+
+//=============================================================
+template <class T>
+void SharedMemoryAudioCache<T>::Entry::copyTo (AudioFile<T>& audioFile) const
+{
+    std::vector<std::vector<T>> newSamples (channels.size());
+
+    for (size_t channel = 0; channel < channels.size(); channel++)
+        newSamples[channel].assign (channels[channel], channels[channel] + numSamplesPerChannel);
+
+    // moving the samples in means they are only copied once
+    audioFile.setAudioBuffer (std::move (newSamples));
+    audioFile.setSampleRate (sampleRate);
+    audioFile.setBitDepth (bitDepth);
+}
+
+//=============================================================
+template <class T>
+SharedMemoryAudioCache<T>::SharedMemoryAudioCache (const std::string& cacheName, uint32_t numIndexSlots)
+ :  name (cacheName)
+{
+    connected = numIndexSlots > 0 && connectToIndex (numIndexSlots);
+
+    if (! connected)
+        reportError ("ERROR: couldn't connect to the shared audio cache '" + cacheName + "', so audio will not be shared");
+}
+
+//=============================================================
+template <class T>
+bool SharedMemoryAudioCache<T>::isConnected() const
+{
+    return connected;
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SharedEntry SharedMemoryAudioCache<T>::load (const std::string& filePath)
+{
+    AudioFileIdentity identity;
+
+    if (! identity.read (filePath))
+    {
+        reportError ("ERROR: File doesn't exist or otherwise can't load file\n" + filePath);
+        return nullptr;
+    }
+
+    if (! connected)
+        return loadPrivately (identity.filePath);
+
+    uint64_t key = getKey (identity);
+    uint64_t pathKey = getPathKey (identity);
+    IndexSlot* slots = getSlots();
+
+    // open addressing with linear probing on the file path. Slots are claimed with a
+    // compare-and-swap on their key and are never released, so a probe sequence is never
+    // broken. Instead, a file that has changed is decoded into the slot of its old version
+    for (uint32_t probe = 0; probe < numSlots; probe++)
+    {
+        IndexSlot& slot = slots[(pathKey + probe) % numSlots];
+        uint64_t slotKey = slot.key.load (std::memory_order_acquire);
+
+        if (slotKey == 0)
+        {
+            if (slot.key.compare_exchange_strong (slotKey, pathKey, std::memory_order_acq_rel))
+            {
+                uint64_t status = makeStatus (Decoding, 1, getCurrentProcessId());
+                slot.version.store (key, std::memory_order_release);
+                slot.status.store (status, std::memory_order_release);
+                return decodeIntoSlot (slot, status, key, identity);
+            }
+
+            // another process claimed the slot first, and slotKey now holds its key
+        }
+
+        if (slotKey == pathKey)
+            return waitForSlot (slot, key, identity);
+    }
+
+    reportError ("ERROR: the shared audio cache '" + name + "' is full");
+    return loadPrivately (identity.filePath);
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::Statistics SharedMemoryAudioCache<T>::getStatistics() const
+{
+    Statistics statistics;
+    statistics.hits = numHits.load();
+    statistics.misses = numMisses.load();
+    statistics.privateLoads = numPrivateLoads.load();
+    return statistics;
+}
+
+//=============================================================
+template <class T>
+void SharedMemoryAudioCache<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+void SharedMemoryAudioCache<T>::setMaximumWaitTimeInMilliseconds (int milliseconds)
+{
+    maximumWaitTimeInMilliseconds = milliseconds;
+}
+
+//=============================================================
+template <class T>
+void SharedMemoryAudioCache<T>::remove (const std::string& cacheName)
+{
+    MemoryMappedFile indexToRemove;
+
+    if (indexToRemove.openSharedMemory (getIndexName (cacheName), true) && indexToRemove.size() >= indexHeaderSize)
+    {
+        auto* header = reinterpret_cast<IndexHeader*> (indexToRemove.writableData());
+
+        if (header->magic.load (std::memory_order_acquire) == indexMagic
+             && indexToRemove.size() >= indexHeaderSize + header->numSlots * sizeof (IndexSlot))
+        {
+            auto* slots = reinterpret_cast<IndexSlot*> (indexToRemove.writableData() + indexHeaderSize);
+
+            for (uint32_t i = 0; i < header->numSlots; i++)
+            {
+                uint64_t version = slots[i].version.load (std::memory_order_acquire);
+
+                if (version != 0)
+                    MemoryMappedFile::removeSharedMemory (getSegmentName (cacheName, version));
+            }
+        }
+    }
+
+    MemoryMappedFile::removeSharedMemory (getIndexName (cacheName));
+}
+
+//=============================================================
+template <class T>
+std::string SharedMemoryAudioCache<T>::getIndexName (const std::string& cacheName)
+{
+    return cacheName + "-index";
+}
+
+//=============================================================
+template <class T>
+std::string SharedMemoryAudioCache<T>::getSegmentName (const std::string& cacheName, uint64_t key)
+{
+    char hexKey[17];
+    std::snprintf (hexKey, sizeof (hexKey), "%016llx", static_cast<unsigned long long> (key));
+    return cacheName + "-" + hexKey;
+}
+
+//=============================================================
+template <class T>
+uint32_t SharedMemoryAudioCache<T>::getSampleType()
+{
+    // fixed point types are classes, so they need a bit of their own to tell them apart
+    // from the unsigned integers of the same size
+    uint32_t sampleType = sizeof (T);
+
+    if (std::is_floating_point<T>::value)
+        sampleType |= 0x100;
+
+    if (std::is_signed<T>::value)
+        sampleType |= 0x200;
+
+    if (FixedPointFormat<T>::isFixedPoint)
+        sampleType |= 0x400;
+
+    return sampleType;
+}
+
+//=============================================================
+template <class T>
+uint64_t SharedMemoryAudioCache<T>::getKey (const AudioFileIdentity& identity)
+{
+    // processes using different sample types must not share buffers
+    uint64_t key = identity.getHash() ^ (getSampleType() * 0x9E3779B97F4A7C15ULL);
+    return key == 0 ? 1 : key;
+}
+
+//=============================================================
+template <class T>
+uint64_t SharedMemoryAudioCache<T>::getPathKey (const AudioFileIdentity& identity)
+{
+    AudioFileIdentity pathOnly;
+    pathOnly.filePath = identity.filePath;
+    return getKey (pathOnly);
+}
+
+//=============================================================
+template <class T>
+uint64_t SharedMemoryAudioCache<T>::makeStatus (SlotState state, uint32_t generation, uint32_t processId)
+{
+    return (static_cast<uint64_t> (processId) << 32) | (static_cast<uint64_t> (generation & 0xFFFFFF) << 8) | static_cast<uint64_t> (state);
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SlotState SharedMemoryAudioCache<T>::getState (uint64_t status)
+{
+    return static_cast<SlotState> (status & 0xFF);
+}
+
+//=============================================================
+template <class T>
+uint32_t SharedMemoryAudioCache<T>::getGeneration (uint64_t status)
+{
+    return static_cast<uint32_t> ((status >> 8) & 0xFFFFFF);
+}
+
+//=============================================================
+template <class T>
+uint32_t SharedMemoryAudioCache<T>::getProcessId (uint64_t status)
+{
+    return static_cast<uint32_t> (status >> 32);
+}
+
+//=============================================================
+template <class T>
+uint32_t SharedMemoryAudioCache<T>::getCurrentProcessId()
+{
+#if defined (_WIN32)
+    return static_cast<uint32_t> (_getpid());
+#else
+    return static_cast<uint32_t> (getpid());
+#endif
+}
+
+//=============================================================
+template <class T>
+bool SharedMemoryAudioCache<T>::isProcessAlive (uint32_t processId)
+{
+#if defined (_WIN32)
+    // we have no cheap way to check this without including windows.h, so a process
+    // waiting on a crashed one will time out and decode the file itself instead
+    (void) processId;
+    return true;
+#else
+    return kill (static_cast<pid_t> (processId), 0) == 0 || errno == EPERM;
+#endif
+}
+
+//=============================================================
+template <class T>
+bool SharedMemoryAudioCache<T>::connectToIndex (uint32_t numIndexSlots)
+{
+    std::string indexName = getIndexName (name);
+    size_t indexSize = indexHeaderSize + numIndexSlots * sizeof (IndexSlot);
+
+    for (int attempt = 0; attempt < 1000; attempt++)
+    {
+        // shared memory starts zeroed, which is an empty index
+        if (index.createSharedMemory (indexName, indexSize))
+        {
+            auto* header = reinterpret_cast<IndexHeader*> (index.writableData());
+            header->numSlots = numIndexSlots;
+            header->magic.store (indexMagic, std::memory_order_release);
+
+            numSlots = numIndexSlots;
+            return true;
+        }
+
+        // otherwise another process created it, so wait until it has been initialised
+        if (index.openSharedMemory (indexName, true) && index.size() >= indexHeaderSize)
+        {
+            auto* header = reinterpret_cast<IndexHeader*> (index.writableData());
+
+            if (header->magic.load (std::memory_order_acquire) == indexMagic)
+            {
+                if (header->numSlots == 0 || index.size() < indexHeaderSize + header->numSlots * sizeof (IndexSlot))
+                {
+                    reportError ("ERROR: the index of the shared audio cache '" + name + "' seems to be corrupted");
+                    index.close();
+                    return false;
+                }
+
+                numSlots = header->numSlots;
+                return true;
+            }
+        }
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+
+    index.close();
+    return false;
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::IndexSlot* SharedMemoryAudioCache<T>::getSlots()
+{
+    return reinterpret_cast<IndexSlot*> (index.writableData() + indexHeaderSize);
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SharedEntry SharedMemoryAudioCache<T>::waitForSlot (IndexSlot& slot, uint64_t key, const AudioFileIdentity& identity)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds (maximumWaitTimeInMilliseconds);
+
+    while (true)
+    {
+        // the version only changes just after the status has moved to a new generation, so if
+        // the status is the same either side of reading the version, the two belong together
+        uint64_t status = slot.status.load (std::memory_order_acquire);
+        uint64_t version = slot.version.load (std::memory_order_acquire);
+
+        if (slot.status.load (std::memory_order_acquire) != status)
+            continue;
+
+        SlotState state = getState (status);
+
+        if (state == Ready && version == key)
+        {
+            if (auto entry = attachToSegment (key))
+            {
+                numHits++;
+                return entry;
+            }
+
+            // the shared audio has gone (e.g. the cache was removed), so let it be decoded again
+            slot.status.compare_exchange_strong (status, makeStatus (Failed, getGeneration (status), 0), std::memory_order_acq_rel);
+            continue;
+        }
+
+        // the slot holds a different version of the file, or decoding it failed
+        if (state == Ready || state == Failed)
+        {
+            if (claimSlot (slot, status, version, key))
+                return decodeIntoSlot (slot, status, key, identity);
+
+            continue;
+        }
+
+        // the file is being decoded - if the process doing that has died, take over from it
+        uint32_t owner = getProcessId (status);
+
+        if (state == Decoding && owner != 0 && ! isProcessAlive (owner))
+        {
+            if (claimSlot (slot, status, version, key))
+                return decodeIntoSlot (slot, status, key, identity);
+
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() > deadline)
+            return loadPrivately (identity.filePath);
+
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+}
+
+//=============================================================
+template <class T>
+bool SharedMemoryAudioCache<T>::claimSlot (IndexSlot& slot, uint64_t& status, uint64_t version, uint64_t key)
+{
+    uint64_t claimedStatus = makeStatus (Decoding, getGeneration (status) + 1, getCurrentProcessId());
+
+    if (! slot.status.compare_exchange_strong (status, claimedStatus, std::memory_order_acq_rel))
+        return false;
+
+    slot.version.store (key, std::memory_order_release);
+
+    // no process can attach to the audio of an old version of the file now, so release it.
+    // Processes that already have it mapped can carry on using it
+    if (version != key && version != 0)
+        MemoryMappedFile::removeSharedMemory (getSegmentName (name, version));
+
+    status = claimedStatus;
+    return true;
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SharedEntry SharedMemoryAudioCache<T>::decodeIntoSlot (IndexSlot& slot, uint64_t status, uint64_t key, const AudioFileIdentity& identity)
+{
+    AudioFile<T> audioFile;
+    audioFile.shouldLogErrorsToConsole (logErrorsToConsole);
+
+    if (! audioFile.load (identity.filePath))
+    {
+        slot.status.store (makeStatus (Failed, getGeneration (status), 0), std::memory_order_release);
+        return nullptr;
+    }
+
+    // don't share audio that doesn't match the key if the file changed while we were decoding it
+    AudioFileIdentity identityAfterLoading;
+
+    if (! identityAfterLoading.read (identity.filePath) || identityAfterLoading != identity)
+    {
+        slot.status.store (makeStatus (Failed, getGeneration (status), 0), std::memory_order_release);
+        numPrivateLoads++;
+        return createPrivateEntry (audioFile);
+    }
+
+    size_t numChannels = static_cast<size_t> (audioFile.getNumChannels());
+    size_t numSamplesPerChannel = static_cast<size_t> (audioFile.getNumSamplesPerChannel());
+    size_t channelStrideInBytes = ((numSamplesPerChannel * sizeof (T) + alignment - 1) / alignment) * alignment;
+    size_t segmentSize = alignment + std::max (numChannels * channelStrideInBytes, alignment);
+
+    std::string segmentName = getSegmentName (name, key);
+    auto segment = std::make_shared<MemoryMappedFile>();
+
+    if (! segment->createSharedMemory (segmentName, segmentSize))
+    {
+        // left over from a process that crashed part way through, or from before the cache
+        // was told the audio had gone, so nobody is relying on its contents
+        MemoryMappedFile::removeSharedMemory (segmentName);
+
+        if (! segment->createSharedMemory (segmentName, segmentSize))
+        {
+            reportError ("ERROR: couldn't create shared memory for " + identity.filePath);
+            slot.status.store (makeStatus (Failed, getGeneration (status), 0), std::memory_order_release);
+            numPrivateLoads++;
+            return createPrivateEntry (audioFile);
+        }
+    }
+
+    SegmentHeader header;
+    header.magic = segmentMagic;
+    header.key = key;
+    header.numSamplesPerChannel = numSamplesPerChannel;
+    header.channelStride = channelStrideInBytes / sizeof (T);
+    header.numChannels = static_cast<uint32_t> (numChannels);
+    header.sampleRate = audioFile.getSampleRate();
+    header.bitDepth = static_cast<uint32_t> (audioFile.getBitDepth());
+    header.sampleType = getSampleType();
+
+    uint8_t* data = segment->writableData();
+    std::memcpy (data, &header, sizeof (header));
+
+    for (size_t channel = 0; channel < numChannels; channel++)
+        std::memcpy (data + alignment + channel * channelStrideInBytes, audioFile.samples[channel].data(), numSamplesPerChannel * sizeof (T));
+
+    slot.status.store (makeStatus (Ready, getGeneration (status), getCurrentProcessId()), std::memory_order_release);
+    numMisses++;
+
+    auto entry = std::make_shared<Entry>();
+    entry->segment = segment;
+    entry->numSamplesPerChannel = numSamplesPerChannel;
+    entry->sampleRate = header.sampleRate;
+    entry->bitDepth = static_cast<int> (header.bitDepth);
+
+    for (size_t channel = 0; channel < numChannels; channel++)
+        entry->channels.push_back (reinterpret_cast<const T*> (data + alignment + channel * channelStrideInBytes));
+
+    return entry;
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SharedEntry SharedMemoryAudioCache<T>::attachToSegment (uint64_t key)
+{
+    auto segment = std::make_shared<MemoryMappedFile>();
+
+    if (! segment->openSharedMemory (getSegmentName (name, key), false) || segment->size() < alignment)
+        return nullptr;
+
+    SegmentHeader header;
+    std::memcpy (&header, segment->data(), sizeof (header));
+
+    if (header.magic != segmentMagic || header.key != key || header.sampleType != getSampleType()
+         || header.channelStride < header.numSamplesPerChannel
+         || segment->size() < alignment + header.numChannels * header.channelStride * sizeof (T))
+        return nullptr;
+
+    auto entry = std::make_shared<Entry>();
+    entry->segment = segment;
+    entry->numSamplesPerChannel = header.numSamplesPerChannel;
+    entry->sampleRate = header.sampleRate;
+    entry->bitDepth = static_cast<int> (header.bitDepth);
+
+    const T* samples = reinterpret_cast<const T*> (segment->data() + alignment);
+
+    for (uint32_t channel = 0; channel < header.numChannels; channel++)
+        entry->channels.push_back (samples + channel * header.channelStride);
+
+    return entry;
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SharedEntry SharedMemoryAudioCache<T>::loadPrivately (const std::string& filePath)
+{
+    AudioFile<T> audioFile;
+    audioFile.shouldLogErrorsToConsole (logErrorsToConsole);
+
+    if (! audioFile.load (filePath))
+        return nullptr;
+
+    numPrivateLoads++;
+    return createPrivateEntry (audioFile);
+}
+
+//=============================================================
+template <class T>
+typename SharedMemoryAudioCache<T>::SharedEntry SharedMemoryAudioCache<T>::createPrivateEntry (AudioFile<T>& audioFile)
+{
+    auto entry = std::make_shared<Entry>();
+    entry->numSamplesPerChannel = static_cast<uint64_t> (audioFile.getNumSamplesPerChannel());
+    entry->sampleRate = audioFile.getSampleRate();
+    entry->bitDepth = audioFile.getBitDepth();
+    entry->privateSamples = std::move (audioFile.samples);
+
+    for (const auto& channel : entry->privateSamples)
+        entry->channels.push_back (channel.data());
+
+    return entry;
+}
+
+//=============================================================
+template <class T>
+void SharedMemoryAudioCache<T>::reportError (std::string errorMessage)
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
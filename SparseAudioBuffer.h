@@ -0,0 +1,164 @@
+//=======================================================================
+/** @file SparseAudioBuffer.h
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+#include "AudioFile.h"
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+//=============================================================
+/** Read-only storage for decoded audio that doesn't store silence.
+ *
+ * Each channel is split into fixed-size blocks, and blocks that are digital silence
+ * (every sample is exactly zero, or the midpoint of the range for unsigned integer
+ * samples) take up no memory at all. This is useful for stems and multitrack recordings
+ * where much of each track is silent. Reading a silent block simply fills the
+ * destination with silence.
+ *
+ * Optionally, blocks where every sample is within a threshold of silence can be treated as
+ * silent too, in which case they are read back as silence (so storage is no longer lossless).
+ */
+template <class T>
+class SparseAudioBuffer
+{
+public:
+    
+    //=============================================================
+    /** Constructor
+     * @param numSamplesPerBlock the number of samples per channel in each block
+     */
+    SparseAudioBuffer (int numSamplesPerBlock = 4096);
+    
+    //=============================================================
+    /** Loads an audio file from a given file path.
+     * @Returns true if the file was successfully loaded
+     */
+    bool load (const std::string& filePath);
+    
+    /** Loads an audio file from data in memory */
+    bool loadFromMemory (std::vector<uint8_t>& fileData);
+    
+    /** Stores the audio of an AudioFile
+     * @Returns false if the AudioFile has no audio
+     */
+    bool store (const AudioFile<T>& audioFile);
+    
+    /** Saves the audio to a file. Silent blocks are written with a fast fill rather than
+     * encoding every sample, but note that this still temporarily needs as much memory
+     * as the audio would take in an AudioFile.
+     * @Returns true if the file was successfully saved
+     */
+    bool save (const std::string& filePath, AudioFileFormat format = AudioFileFormat::Wave) const;
+    
+    /** Removes all audio */
+    void clear();
+    
+    //=============================================================
+    /** Sets how far from silence every sample in a block can be for the block to be treated
+     * as silent. By default this is zero, which means only digital silence is treated as
+     * silent. This applies to audio that is loaded or stored after it is set.
+     */
+    void setSilenceThreshold (T threshold);
+    
+    //=============================================================
+    /** @Returns the sample rate */
+    uint32_t getSampleRate() const;
+    
+    /** @Returns the number of audio channels */
+    int getNumChannels() const;
+    
+    /** @Returns the bit depth of the audio */
+    int getBitDepth() const;
+    
+    /** @Returns the number of samples per channel */
+    int getNumSamplesPerChannel() const;
+    
+    /** @Returns the length in seconds of the audio */
+    double getLengthInSeconds() const;
+    
+    /** @Returns the number of samples per channel in each block */
+    int getNumSamplesPerBlock() const;
+    
+    //=============================================================
+    /** @Returns a single sample */
+    T getSample (int channel, int sampleIndex) const;
+    
+    /** Copies a range of samples from one channel into the destination buffer, which
+     * must have room for numSamples samples. The range must lie within the audio.
+     */
+    void readSamples (int channel, int startSample, int numSamples, T* destination) const;
+    
+    /** @Returns true if the sample at the given index is in a block that is stored as silence */
+    bool isSilent (int channel, int sampleIndex) const;
+    
+    /** Copies all of the audio into an AudioFile
+     * @Returns false if there is no audio
+     */
+    bool copyTo (AudioFile<T>& audioFile) const;
+    
+    //=============================================================
+    /** @Returns the number of blocks, over all channels, that are stored as silence */
+    int getNumSilentBlocks() const;
+    
+    /** @Returns the number of bytes used to store the audio */
+    size_t getSizeInBytes() const;
+    
+    //=============================================================
+    /** Sets whether the buffer should log error messages to the console. By default this is true */
+    void shouldLogErrorsToConsole (bool logErrors);
+    
+private:
+    
+    //=============================================================
+    typedef std::vector<std::vector<T>> Blocks;
+    
+    //=============================================================
+    void storeChannel (const std::vector<T>& channelSamples, Blocks& channelBlocks) const;
+    bool isSilentSample (T sample) const;
+    static T getSilentSample (int bitDepth);
+    
+    //=============================================================
+    void reportError (std::string errorMessage);
+    
+    //=============================================================
+    std::vector<Blocks> channels;   // an empty block is silent
+    int blockSize;
+    int numSamplesPerChannel {0};
+    uint32_t sampleRate {0};
+    int bitDepth {0};
+    T silenceThreshold {0};
+    T silentSample {};
+    bool logErrorsToConsole {true};
+};
+
+#include "SparseAudioBuffer.inl"
@@ -0,0 +1,323 @@
+//=======================================================================
+/** @file SparseAudioBuffer.inl
+ *  @author Adam Stark
+ *  @copyright Copyright (C) 2017  Adam Stark
+ *
+ * This file is part of the 'AudioFile' library
+ *
+ * MIT License
+ *
+ * Copyright (c) 2017 Adam Stark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+//=======================================================================
+
+#pragma once
+
+//=============================================================
+template <class T>
+SparseAudioBuffer<T>::SparseAudioBuffer (int numSamplesPerBlock)
+ : blockSize (std::max (numSamplesPerBlock, 1))
+{
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::load (const std::string& filePath)
+{
+    AudioFile<T> audioFile;
+    audioFile.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    return audioFile.load (filePath) && store (audioFile);
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::loadFromMemory (std::vector<uint8_t>& fileData)
+{
+    AudioFile<T> audioFile;
+    audioFile.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    return audioFile.loadFromMemory (fileData) && store (audioFile);
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::store (const AudioFile<T>& audioFile)
+{
+    clear();
+    
+    if (audioFile.getNumChannels() == 0)
+    {
+        reportError ("ERROR: there is no audio to store");
+        return false;
+    }
+    
+    numSamplesPerChannel = audioFile.getNumSamplesPerChannel();
+    sampleRate = audioFile.getSampleRate();
+    bitDepth = audioFile.getBitDepth();
+    silentSample = getSilentSample (bitDepth);
+    
+    channels.resize (audioFile.getNumChannels());
+    
+    for (size_t channel = 0; channel < channels.size(); channel++)
+        storeChannel (audioFile.samples[channel], channels[channel]);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::save (const std::string& filePath, AudioFileFormat format) const
+{
+    AudioFile<T> audioFile;
+    audioFile.shouldLogErrorsToConsole (logErrorsToConsole);
+    
+    return copyTo (audioFile) && audioFile.save (filePath, format);
+}
+
+//=============================================================
+template <class T>
+void SparseAudioBuffer<T>::clear()
+{
+    channels.clear();
+    numSamplesPerChannel = 0;
+    sampleRate = 0;
+    bitDepth = 0;
+    silentSample = T();
+}
+
+//=============================================================
+template <class T>
+void SparseAudioBuffer<T>::setSilenceThreshold (T threshold)
+{
+    silenceThreshold = threshold;
+}
+
+//=============================================================
+template <class T>
+uint32_t SparseAudioBuffer<T>::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//=============================================================
+template <class T>
+int SparseAudioBuffer<T>::getNumChannels() const
+{
+    return static_cast<int> (channels.size());
+}
+
+//=============================================================
+template <class T>
+int SparseAudioBuffer<T>::getBitDepth() const
+{
+    return bitDepth;
+}
+
+//=============================================================
+template <class T>
+int SparseAudioBuffer<T>::getNumSamplesPerChannel() const
+{
+    return numSamplesPerChannel;
+}
+
+//=============================================================
+template <class T>
+double SparseAudioBuffer<T>::getLengthInSeconds() const
+{
+    if (sampleRate == 0)
+        return 0.;
+    
+    return static_cast<double> (numSamplesPerChannel) / static_cast<double> (sampleRate);
+}
+
+//=============================================================
+template <class T>
+int SparseAudioBuffer<T>::getNumSamplesPerBlock() const
+{
+    return blockSize;
+}
+
+//=============================================================
+template <class T>
+T SparseAudioBuffer<T>::getSample (int channel, int sampleIndex) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    assert (sampleIndex >= 0 && sampleIndex < numSamplesPerChannel);
+    
+    const std::vector<T>& block = channels[channel][sampleIndex / blockSize];
+    
+    return block.empty() ? silentSample : block[sampleIndex % blockSize];
+}
+
+//=============================================================
+template <class T>
+void SparseAudioBuffer<T>::readSamples (int channel, int startSample, int numSamples, T* destination) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    assert (startSample >= 0 && numSamples >= 0 && startSample + numSamples <= numSamplesPerChannel);
+    
+    while (numSamples > 0)
+    {
+        int blockIndex = startSample / blockSize;
+        int offsetInBlock = startSample - blockIndex * blockSize;
+        int numSamplesToCopy = std::min (numSamples, blockSize - offsetInBlock);
+        
+        const std::vector<T>& block = channels[channel][blockIndex];
+        
+        if (block.empty())
+            std::fill (destination, destination + numSamplesToCopy, silentSample);
+        else
+            std::copy (block.begin() + offsetInBlock, block.begin() + offsetInBlock + numSamplesToCopy, destination);
+        
+        startSample += numSamplesToCopy;
+        numSamples -= numSamplesToCopy;
+        destination += numSamplesToCopy;
+    }
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::isSilent (int channel, int sampleIndex) const
+{
+    assert (channel >= 0 && channel < getNumChannels());
+    assert (sampleIndex >= 0 && sampleIndex < numSamplesPerChannel);
+    
+    return channels[channel][sampleIndex / blockSize].empty();
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::copyTo (AudioFile<T>& audioFile) const
+{
+    if (channels.empty())
+        return false;
+    
+    std::vector<std::vector<T>> newSamples (getNumChannels(), std::vector<T> (numSamplesPerChannel));
+    
+    for (int channel = 0; channel < getNumChannels(); channel++)
+        readSamples (channel, 0, numSamplesPerChannel, newSamples[channel].data());
+    
+    // moving the samples in means copies of the AudioFile can still share them
+    audioFile.setAudioBuffer (std::move (newSamples));
+    audioFile.setBitDepth (bitDepth);
+    audioFile.setSampleRate (sampleRate);
+    
+    return true;
+}
+
+//=============================================================
+template <class T>
+int SparseAudioBuffer<T>::getNumSilentBlocks() const
+{
+    int numSilentBlocks = 0;
+    
+    for (auto& channelBlocks : channels)
+        numSilentBlocks += static_cast<int> (std::count_if (channelBlocks.begin(), channelBlocks.end(), [] (const std::vector<T>& block) { return block.empty(); }));
+    
+    return numSilentBlocks;
+}
+
+//=============================================================
+template <class T>
+size_t SparseAudioBuffer<T>::getSizeInBytes() const
+{
+    size_t numBytes = 0;
+    
+    for (auto& channelBlocks : channels)
+    {
+        numBytes += channelBlocks.capacity() * sizeof (std::vector<T>);
+        
+        for (auto& block : channelBlocks)
+            numBytes += block.capacity() * sizeof (T);
+    }
+    
+    return numBytes;
+}
+
+//=============================================================
+template <class T>
+void SparseAudioBuffer<T>::shouldLogErrorsToConsole (bool logErrors)
+{
+    logErrorsToConsole = logErrors;
+}
+
+//=============================================================
+template <class T>
+void SparseAudioBuffer<T>::storeChannel (const std::vector<T>& channelSamples, Blocks& channelBlocks) const
+{
+    int numBlocks = (numSamplesPerChannel + blockSize - 1) / blockSize;
+    channelBlocks.resize (numBlocks);
+    
+    for (int blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+    {
+        auto start = channelSamples.begin() + static_cast<size_t> (blockIndex) * blockSize;
+        auto end = start + std::min (blockSize, numSamplesPerChannel - blockIndex * blockSize);
+        
+        bool silent = std::all_of (start, end, [this] (T sample) { return isSilentSample (sample); });
+        
+        if (! silent)
+            channelBlocks[blockIndex].assign (start, end);
+    }
+}
+
+//=============================================================
+template <class T>
+bool SparseAudioBuffer<T>::isSilentSample (T sample) const
+{
+    if constexpr (std::is_unsigned<T>::value)
+    {
+        T distanceFromSilence = sample > silentSample ? sample - silentSample : silentSample - sample;
+        return distanceFromSilence <= silenceThreshold;
+    }
+    else
+    {
+        // without a threshold, only samples with exactly the bit pattern of silence are dropped,
+        // so that -0.0 is kept rather than being read back as 0.0
+        if (silenceThreshold == T())
+            return std::memcmp (&sample, &silentSample, sizeof (T)) == 0;
+        
+        return sample <= silenceThreshold && sample >= -silenceThreshold;
+    }
+}
+
+//=============================================================
+template <class T>
+T SparseAudioBuffer<T>::getSilentSample (int bitDepth)
+{
+    // unsigned integer samples are offset so that silence is in the middle of the range
+    if constexpr (std::is_unsigned<T>::value)
+    {
+        int numBits = std::max (std::min (bitDepth, std::numeric_limits<T>::digits), 1);
+        return static_cast<T> (static_cast<T> (1) << (numBits - 1));
+    }
+    else
+    {
+        return T();
+    }
+}
+
+//=============================================================
+template <class T>
+void SparseAudioBuffer<T>::reportError (std::string errorMessage)
+{
+    if (logErrorsToConsole)
+        std::cout << errorMessage << std::endl;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <AudioFile.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+//=============================================================
+void runCompressionBenchmarks();
+void runInterleavingBenchmarks();
+void runResamplingBenchmarks();
+void runSavingBenchmarks();
+
+//=============================================================
+/** Runs a function a number of times and returns the fastest time in seconds */
+template <typename Function>
+double getFastestTimeInSeconds (int numRepeats, Function&& function)
+{
+    double fastest = std::numeric_limits<double>::max();
+    
+    for (int i = 0; i < numRepeats; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        
+        fastest = std::min (fastest, std::chrono::duration<double> (end - start).count());
+    }
+    
+    return fastest;
+}
+
+//=============================================================
+/** @Returns a throughput in megabytes per second */
+inline double getMegabytesPerSecond (size_t numBytes, double seconds)
+{
+    return static_cast<double> (numBytes) / (1024. * 1024.) / seconds;
+}
+
+//=============================================================
+/** Fills an AudioFile with a music-like test signal: a few decaying harmonic
+ * notes with a little noise, which compresses about as well as real recordings
+ */
+template <typename T>
+void fillWithTestSignal (AudioFile<T>& audioFile, int numChannels, int numSamplesPerChannel, int bitDepth)
+{
+    audioFile.setAudioBufferSize (numChannels, numSamplesPerChannel);
+    audioFile.setBitDepth (bitDepth);
+    audioFile.setSampleRate (48000);
+    
+    std::mt19937 randomGenerator (1234);
+    std::normal_distribution<double> noise (0., 0.0005);
+    
+    const double twoPi = 6.283185307179586;
+    const double noteFrequencies[] = { 110., 164.81, 220., 277.18, 329.63 };
+    const int noteLength = 24000;
+    
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        for (int i = 0; i < numSamplesPerChannel; i++)
+        {
+            double frequency = noteFrequencies[(i / noteLength + channel) % 5];
+            double envelope = std::exp (-3. * (i % noteLength) / noteLength);
+            double value = 0.;
+            
+            for (int harmonic = 1; harmonic <= 6; harmonic++)
+                value += std::sin (twoPi * frequency * harmonic * i / 48000.) / (harmonic * 2.);
+            
+            value = value * 0.5 * envelope + noise (randomGenerator);
+            
+            if (std::numeric_limits<T>::is_integer)
+                audioFile.samples[channel][i] = static_cast<T> (std::round (value * ((1 << (bitDepth - 1)) - 1)));
+            else
+                audioFile.samples[channel][i] = static_cast<T> (value);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "Benchmarks.h"
+#include <CompressedAudioBuffer.h>
+#include <iomanip>
+#include <iostream>
+
+//=============================================================
+static void benchmarkCompression (int bitDepth)
+{
+    const int numChannels = 2;
+    const int numSamplesPerChannel = 48000 * 60;
+    
+    AudioFile<int32_t> pcmAudio;
+    fillWithTestSignal (pcmAudio, numChannels, numSamplesPerChannel, bitDepth);
+    
+    CompressedAudioBuffer<float> compressed;
+    
+    double compressionTime = getFastestTimeInSeconds (3, [&]() { compressed.compress (pcmAudio); });
+    
+    AudioFile<float> decompressed;
+    double decompressionTime = getFastestTimeInSeconds (5, [&]() { compressed.decompress (decompressed); });
+    
+    // short reads from random positions, as a sampler voice might make
+    const int numReads = 20000;
+    const int readLength = 512;
+    std::vector<float> readBuffer (readLength);
+    std::mt19937 randomGenerator (42);
+    std::uniform_int_distribution<int> startPositions (0, numSamplesPerChannel - readLength);
+    
+    double randomReadTime = getFastestTimeInSeconds (3, [&]()
+    {
+        for (int i = 0; i < numReads; i++)
+            compressed.readSamples (i % numChannels, startPositions (randomGenerator), readLength, readBuffer.data());
+    });
+    
+    size_t pcmBytes = compressed.getPCMSizeInBytes();
+    size_t floatBytes = static_cast<size_t> (numChannels) * numSamplesPerChannel * sizeof (float);
+    size_t compressedBytes = compressed.getCompressedSizeInBytes();
+    
+    std::cout << std::fixed << std::setprecision (2);
+    std::cout << bitDepth << "-bit stereo, 60 seconds" << std::endl;
+    std::cout << "    compressed size:        " << compressedBytes / 1024 << " KB" << std::endl;
+    std::cout << "    ratio to PCM:           " << static_cast<double> (compressedBytes) / pcmBytes << std::endl;
+    std::cout << "    ratio to float samples: " << static_cast<double> (compressedBytes) / floatBytes << std::endl;
+    std::cout << "    compress:               " << getMegabytesPerSecond (pcmBytes, compressionTime) << " MB/s (of PCM)" << std::endl;
+    std::cout << "    decompress to float:    " << getMegabytesPerSecond (pcmBytes, decompressionTime) << " MB/s (of PCM), "
+              << getMegabytesPerSecond (floatBytes, decompressionTime) << " MB/s (of float)" << std::endl;
+    std::cout << "    random 512 sample read: " << randomReadTime / numReads * 1e6 << " us" << std::endl;
+}
+
+//=============================================================
+void runCompressionBenchmarks()
+{
+    std::cout << "==== CompressedAudioBuffer ====" << std::endl;
+    
+    benchmarkCompression (16);
+    benchmarkCompression (24);
+    
+    std::cout << std::endl;
+}
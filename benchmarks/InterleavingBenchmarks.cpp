@@ -0,0 +1,99 @@
+#include "Benchmarks.h"
+#include <InterleavedAudioFile.h>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+//=============================================================
+template <typename T>
+static void benchmarkInterleaving (int numChannels, int bitDepth)
+{
+    const int numSamplesPerChannel = (48000 * 240) / numChannels;
+    const std::string filePath = "interleaving-benchmark.wav";
+    
+    AudioFile<T> audioFile;
+    fillWithTestSignal (audioFile, numChannels, numSamplesPerChannel, bitDepth);
+    
+    double saveTime = getFastestTimeInSeconds (5, [&]() { audioFile.save (filePath); });
+    
+    std::ifstream file (filePath, std::ios::binary);
+    std::vector<uint8_t> fileData ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove (filePath.c_str());
+    
+    AudioFile<T> loaded;
+    double loadTime = getFastestTimeInSeconds (10, [&]() { loaded.loadFromMemory (fileData); });
+    
+    size_t pcmBytes = static_cast<size_t> (numChannels) * numSamplesPerChannel * (bitDepth / 8);
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << std::setw (3) << numChannels << " channels, " << bitDepth << "-bit:  "
+              << "load " << std::setw (7) << getMegabytesPerSecond (pcmBytes, loadTime) << " MB/s,  "
+              << "save " << std::setw (7) << getMegabytesPerSecond (pcmBytes, saveTime) << " MB/s" << std::endl;
+}
+
+//=============================================================
+static void benchmarkInterleavedAudioFile (int numChannels, int bitDepth)
+{
+    const int numSamplesPerChannel = (48000 * 240) / numChannels;
+    const std::string filePath = "interleaving-benchmark.wav";
+    
+    AudioFile<float> audioFile;
+    fillWithTestSignal (audioFile, numChannels, numSamplesPerChannel, bitDepth);
+    
+    InterleavedAudioFile<float> interleaved;
+    interleaved.setAudioBufferSize (numChannels, numSamplesPerChannel);
+    interleaved.setBitDepth (bitDepth);
+    
+    for (int i = 0; i < numSamplesPerChannel; i++)
+        for (int channel = 0; channel < numChannels; channel++)
+            interleaved.frames[i * numChannels + channel] = audioFile.samples[channel][i];
+    
+    double saveTime = getFastestTimeInSeconds (5, [&]() { interleaved.save (filePath); });
+    
+    std::ifstream file (filePath, std::ios::binary);
+    std::vector<uint8_t> fileData ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove (filePath.c_str());
+    
+    InterleavedAudioFile<float> loaded;
+    double loadTime = getFastestTimeInSeconds (10, [&]() { loaded.loadFromMemory (fileData); });
+    
+    size_t pcmBytes = static_cast<size_t> (numChannels) * numSamplesPerChannel * (bitDepth / 8);
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << std::setw (3) << numChannels << " channels, " << bitDepth << "-bit:  "
+              << "load " << std::setw (7) << getMegabytesPerSecond (pcmBytes, loadTime) << " MB/s,  "
+              << "save " << std::setw (7) << getMegabytesPerSecond (pcmBytes, saveTime) << " MB/s" << std::endl;
+}
+
+//=============================================================
+void runInterleavingBenchmarks()
+{
+    std::cout << "==== Interleaved sample data (AudioFile<float>, WAV) ====" << std::endl;
+    
+    for (int bitDepth : { 16, 24 })
+        for (int numChannels : { 2, 8, 32, 128 })
+            benchmarkInterleaving<float> (numChannels, bitDepth);
+    
+    // sample types that match the file, so samples are copied rather than converted
+    std::cout << "==== Matching sample types (WAV) ====" << std::endl;
+    std::cout << "  AudioFile<int16_t>" << std::endl;
+    
+    for (int numChannels : { 1, 2, 8 })
+        benchmarkInterleaving<int16_t> (numChannels, 16);
+    
+    std::cout << "  AudioFile<float>" << std::endl;
+    
+    for (int numChannels : { 1, 2, 8 })
+        benchmarkInterleaving<float> (numChannels, 32);
+    
+    std::cout << "==== InterleavedAudioFile<float> (WAV) ====" << std::endl;
+    
+    for (int numChannels : { 2, 8, 32, 128 })
+        benchmarkInterleavedAudioFile (numChannels, 24);
+    
+    std::cout << std::endl;
+}
@@ -0,0 +1,159 @@
+#include "Benchmarks.h"
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+//=============================================================
+static void benchmarkResamplingSpeed (uint32_t sourceRate, uint32_t targetRate, int numChannels)
+{
+    const int numSamplesPerChannel = 48000 * 60;
+    
+    AudioFile<float> original;
+    fillWithTestSignal (original, numChannels, numSamplesPerChannel, 24);
+    original.setSampleRate (sourceRate);
+    
+    AudioResampler<float> resampler (sourceRate, targetRate, numChannels);
+    
+    double resampleTime = getFastestTimeInSeconds (3, [&]()
+    {
+        AudioFile<float> audioFile (original);
+        audioFile.resample (targetRate);
+    });
+    
+    double secondsOfAudio = static_cast<double> (numSamplesPerChannel) / sourceRate;
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << std::setw (6) << sourceRate << " -> " << std::setw (6) << targetRate << " Hz, "
+              << numChannels << " channels, " << std::setw (3) << resampler.getNumTaps() << " taps:  "
+              << std::setw (6) << numSamplesPerChannel * static_cast<double> (numChannels) / resampleTime / 1e6 << " M input samples/s,  "
+              << std::setw (6) << secondsOfAudio / resampleTime << "x real time" << std::endl;
+}
+
+//=============================================================
+/** Resamples a sine, and @Returns the level of the output in dB relative to the input, along
+ * with the level of whatever differs from the same sine at the new rate (i.e. any error, images
+ * or aliases), both measured away from the ends of the output
+ */
+static std::pair<double, double> measureResampledSine (uint32_t sourceRate, uint32_t targetRate, double frequency)
+{
+    const double twoPi = 6.283185307179586;
+    const int numSamples = static_cast<int> (sourceRate);
+    
+    AudioFile<double> audioFile;
+    audioFile.setAudioBufferSize (1, numSamples);
+    audioFile.setSampleRate (sourceRate);
+    
+    for (int i = 0; i < numSamples; i++)
+        audioFile.samples[0][i] = std::sin (twoPi * frequency * i / sourceRate);
+    
+    audioFile.resample (targetRate);
+    
+    const auto& output = audioFile.samples[0];
+    bool isInPassband = frequency < std::min (sourceRate, targetRate) / 2.;
+    double signalSum = 0.;
+    double errorSum = 0.;
+    size_t numMeasured = 0;
+    
+    for (size_t i = 1000; i + 1000 < output.size(); i++, numMeasured++)
+    {
+        double expected = isInPassband ? std::sin (twoPi * frequency * i / targetRate) : 0.;
+        signalSum += output[i] * output[i];
+        errorSum += (output[i] - expected) * (output[i] - expected);
+    }
+    
+    return { 10. * std::log10 (signalSum / numMeasured / 0.5), 10. * std::log10 (errorSum / numMeasured / 0.5) };
+}
+
+//=============================================================
+static void benchmarkResamplingQuality (uint32_t sourceRate, uint32_t targetRate)
+{
+    double nyquist = std::min (sourceRate, targetRate) / 2.;
+    auto middle = measureResampledSine (sourceRate, targetRate, 0.5 * nyquist);
+    auto top = measureResampledSine (sourceRate, targetRate, 0.88 * nyquist);
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << std::setw (6) << sourceRate << " -> " << std::setw (6) << targetRate << " Hz:  "
+              << "gain at 0.5 / 0.88 Nyquist " << std::setw (5) << middle.first << " / " << std::setw (5) << top.first << " dB,  "
+              << "error " << std::setw (6) << middle.second << " / " << std::setw (6) << top.second << " dB";
+    
+    // when downsampling, a tone above the new Nyquist frequency can only reach the output as an alias
+    if (sourceRate > targetRate)
+        std::cout << ",  alias of 1.1 Nyquist " << std::setw (6) << measureResampledSine (sourceRate, targetRate, 1.1 * nyquist).first << " dB";
+    
+    std::cout << std::endl;
+}
+
+//=============================================================
+static void benchmarkLoadAs (int numChannels, uint32_t newSampleRate)
+{
+    const int numSamplesPerChannel = 48000 * 300;
+    const std::string filePath = "resampling-benchmark.wav";
+    
+    {
+        AudioFile<float> audioFile;
+        fillWithTestSignal (audioFile, numChannels, numSamplesPerChannel, 24);
+        audioFile.save (filePath);
+    }
+    
+    // load the whole file, mix it to mono and then resample it, as separate passes...
+    double separateTime = getFastestTimeInSeconds (3, [&]()
+    {
+        AudioFile<float> audioFile;
+        audioFile.load (filePath);
+        
+        std::vector<float> mono (static_cast<size_t> (audioFile.getNumSamplesPerChannel()));
+        
+        for (int channel = 0; channel < audioFile.getNumChannels(); channel++)
+        {
+            const auto& channelSamples = static_cast<const AudioFile<float>&> (audioFile).samples[channel];
+            
+            for (size_t i = 0; i < mono.size(); i++)
+                mono[i] += channelSamples[i] / numChannels;
+        }
+        
+        audioFile.setAudioBuffer (std::vector<std::vector<float>> { std::move (mono) });
+        audioFile.resample (newSampleRate);
+    });
+    
+    // ...or a block at a time
+    double loadAsTime = getFastestTimeInSeconds (3, [&]()
+    {
+        AudioFile<float> audioFile;
+        audioFile.loadAs (filePath, newSampleRate, 1);
+    });
+    
+    std::remove (filePath.c_str());
+    
+    size_t pcmBytes = static_cast<size_t> (numChannels) * numSamplesPerChannel * 3;
+    size_t outputBytes = static_cast<size_t> (numSamplesPerChannel / (48000 / newSampleRate)) * sizeof (float);
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << numChannels << " channels, 24-bit, 48000 -> " << newSampleRate << " Hz mono:  "
+              << "load, mix, resample " << std::setw (6) << getMegabytesPerSecond (pcmBytes, separateTime) << " MB/s,  "
+              << "loadAs " << std::setw (6) << getMegabytesPerSecond (pcmBytes, loadAsTime) << " MB/s  "
+              << "(file " << pcmBytes / (1024 * 1024) << " MB, output " << outputBytes / (1024 * 1024) << " MB)" << std::endl;
+}
+
+//=============================================================
+void runResamplingBenchmarks()
+{
+    const std::pair<uint32_t, uint32_t> rates[] = { { 44100, 48000 }, { 48000, 44100 }, { 48000, 96000 }, { 96000, 48000 }, { 44100, 44101 } };
+    
+    std::cout << "==== Resampling speed (AudioFile<float>::resample) ====" << std::endl;
+    
+    for (auto& rate : rates)
+        benchmarkResamplingSpeed (rate.first, rate.second, 2);
+    
+    std::cout << "==== Resampling quality (sines resampled by AudioFile<double>::resample) ====" << std::endl;
+    
+    for (auto& rate : rates)
+        benchmarkResamplingQuality (rate.first, rate.second);
+    
+    // the separate passes hold the file, the decoded audio and the mixed audio in memory at
+    // once, where loadAs() only holds a block of each alongside the output
+    std::cout << "==== Loading as 16kHz mono (AudioFile<float>, WAV) ====" << std::endl;
+    
+    for (int numChannels : { 2, 8 })
+        benchmarkLoadAs (numChannels, 16000);
+}
@@ -0,0 +1,85 @@
+#include "Benchmarks.h"
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+//=============================================================
+static void benchmarkEncodingThreads (int numChannels, int bitDepth, DitherType ditherType, int numThreads)
+{
+    const int numSamplesPerChannel = (48000 * 600) / numChannels;
+    const std::string filePath = "saving-benchmark.wav";
+    
+    AudioFile<float> audioFile;
+    fillWithTestSignal (audioFile, numChannels, numSamplesPerChannel, bitDepth);
+    audioFile.setDither (ditherType);
+    audioFile.setNumEncodingThreads (numThreads);
+    
+    double saveTime = getFastestTimeInSeconds (3, [&]() { audioFile.save (filePath); });
+    std::remove (filePath.c_str());
+    
+    size_t pcmBytes = static_cast<size_t> (numChannels) * numSamplesPerChannel * (bitDepth / 8);
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << std::setw (3) << numChannels << " channels, " << bitDepth << "-bit, "
+              << std::setw (2) << numThreads << " threads:  "
+              << "save " << std::setw (7) << getMegabytesPerSecond (pcmBytes, saveTime) << " MB/s" << std::endl;
+}
+
+//=============================================================
+static void benchmarkMappedSaving (int numChannels, int bitDepth, int numThreads)
+{
+    const int numSamplesPerChannel = (48000 * 600) / numChannels;
+    const std::string filePath = "saving-benchmark.wav";
+    
+    AudioFile<float> audioFile;
+    fillWithTestSignal (audioFile, numChannels, numSamplesPerChannel, bitDepth);
+    audioFile.setNumEncodingThreads (numThreads);
+    
+    double bufferedTime = getFastestTimeInSeconds (3, [&]() { audioFile.save (filePath); });
+    double mappedTime = getFastestTimeInSeconds (3, [&]() { audioFile.saveMapped (filePath); });
+    double mappedSyncTime = getFastestTimeInSeconds (3, [&]() { audioFile.saveMapped (filePath, AudioFileFormat::Wave, MappedFileSync::OnClose); });
+    std::remove (filePath.c_str());
+    
+    size_t pcmBytes = static_cast<size_t> (numChannels) * numSamplesPerChannel * (bitDepth / 8);
+    
+    std::cout << std::fixed << std::setprecision (1);
+    std::cout << "    " << std::setw (3) << numChannels << " channels, " << bitDepth << "-bit, "
+              << std::setw (2) << numThreads << " threads:  "
+              << "buffered " << std::setw (7) << getMegabytesPerSecond (pcmBytes, bufferedTime) << " MB/s,  "
+              << "mapped " << std::setw (7) << getMegabytesPerSecond (pcmBytes, mappedTime) << " MB/s,  "
+              << "mapped + sync " << std::setw (7) << getMegabytesPerSecond (pcmBytes, mappedSyncTime) << " MB/s" << std::endl;
+}
+
+//=============================================================
+void runSavingBenchmarks()
+{
+    const int numThreadsToTry[] = { 1, 2, 4, 8 };
+    
+    std::cout << "==== Encoding threads (AudioFile<float>, WAV, "
+              << std::thread::hardware_concurrency() << " cores) ====" << std::endl;
+    
+    for (int bitDepth : { 16, 24 })
+        for (int numThreads : numThreadsToTry)
+            benchmarkEncodingThreads (8, bitDepth, DitherType::None, numThreads);
+    
+    std::cout << "  Triangular dither" << std::endl;
+    
+    for (int numThreads : numThreadsToTry)
+        benchmarkEncodingThreads (8, 16, DitherType::Triangular, numThreads);
+    
+    std::cout << "  Noise shaped dither (split by channel)" << std::endl;
+    
+    for (int numThreads : numThreadsToTry)
+        benchmarkEncodingThreads (8, 16, DitherType::NoiseShaped, numThreads);
+    
+    // buffered saves copy the whole file through a vector and a stream, where mapped saves
+    // encode into the file's pages. "sync" waits for the file to reach the disk
+    std::cout << "==== Buffered and memory-mapped saves (AudioFile<float>, WAV) ====" << std::endl;
+    
+    for (int bitDepth : { 16, 24 })
+        for (int numThreads : { 1, 4 })
+            benchmarkMappedSaving (8, bitDepth, numThreads);
+    
+    std::cout << std::endl;
+}
@@ -0,0 +1,45 @@
+#include "Benchmarks.h"
+#include <iostream>
+#include <map>
+#include <string>
+
+//=============================================================
+// Runs all benchmarks, or just those named on the command line, e.g.
+//
+//      ./Benchmarks compression
+//
+// Build in release mode to get meaningful figures.
+//=============================================================
+int main (int argc, char** argv)
+{
+    std::map<std::string, void (*)()> benchmarks
+    {
+        { "compression", runCompressionBenchmarks },
+        { "interleaving", runInterleavingBenchmarks },
+        { "resampling", runResamplingBenchmarks },
+        { "saving", runSavingBenchmarks }
+    };
+    
+    if (argc < 2)
+    {
+        for (auto& benchmark : benchmarks)
+            benchmark.second();
+        
+        return 0;
+    }
+    
+    for (int i = 1; i < argc; i++)
+    {
+        auto benchmark = benchmarks.find (argv[i]);
+        
+        if (benchmark == benchmarks.end())
+        {
+            std::cout << "Unknown benchmark: " << argv[i] << std::endl;
+            return 1;
+        }
+        
+        benchmark->second();
+    }
+    
+    return 0;
+}
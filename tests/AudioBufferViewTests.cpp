@@ -0,0 +1,227 @@
+#include "doctest.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <AudioFile.h>
+#include <LazyAudioFile.h>
+
+//=============================================================
+TEST_SUITE ("AudioBufferView Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    
+    //=============================================================
+    std::vector<uint8_t> readSavedViewFile (const std::string& filePath)
+    {
+        std::ifstream file (filePath, std::ios::binary);
+        return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioBufferViewTests::StridesAndRanges")
+    {
+        // three channels of planar audio in one buffer
+        std::vector<float> planar (3 * 10);
+        
+        for (size_t i = 0; i < planar.size(); i++)
+            planar[i] = static_cast<float> (i);
+        
+        AudioBufferView<float> view (planar.data(), 3, 10, 10, 1);
+        CHECK (view.getNumChannels() == 3);
+        CHECK (view.getNumSamples() == 10);
+        CHECK (view (0, 0) == 0.f);
+        CHECK (view (2, 4) == 24.f);
+        
+        auto range = view.getChannelRange (1, 2).getSampleRange (3, 5);
+        CHECK (range.getNumChannels() == 2);
+        CHECK (range.getNumSamples() == 5);
+        CHECK (range (0, 0) == 13.f);
+        CHECK (range (1, 4) == 27.f);
+        
+        // interleaved stereo frames, padded to four samples each
+        std::vector<int16_t> frames (4 * 8);
+        auto interleaved = AudioBufferView<int16_t>::interleaved (frames.data(), 2, 8, 4);
+        
+        for (int i = 0; i < 8; i++)
+        {
+            interleaved (0, i) = static_cast<int16_t> (i);
+            interleaved (1, i) = static_cast<int16_t> (-i);
+        }
+        
+        CHECK (frames[4 * 5] == 5);
+        CHECK (frames[4 * 5 + 1] == -5);
+        CHECK (frames[4 * 5 + 2] == 0);
+        CHECK (interleaved.getSampleRange (2, 4).getChannelRange (1, 1) (0, 1) == -3);
+        
+        // separate channels, read through a read-only view
+        std::vector<int16_t> left { 1, 2, 3 }, right { 4, 5, 6 };
+        int16_t* channels[] = { left.data(), right.data() };
+        AudioBufferView<const int16_t> separate = AudioBufferView<int16_t> (channels, 2, 3);
+        CHECK (separate.getSampleRange (1, 2) (1, 1) == 6);
+        CHECK (separate.getChannelRange (1, 1).getPointer (0) == right.data());
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioBufferViewTests::SetAudioBufferFromView")
+    {
+        std::vector<double> frames { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6 };
+        
+        AudioFile<double> audioFile;
+        REQUIRE (audioFile.setAudioBuffer (AudioBufferView<const double>::interleaved (frames.data(), 2, 3)));
+        REQUIRE (audioFile.getNumChannels() == 2);
+        REQUIRE (audioFile.getNumSamplesPerChannel() == 3);
+        CHECK (audioFile.samples[0][2] == 0.5);
+        CHECK (audioFile.samples[1][0] == 0.2);
+    }
+    
+    //=============================================================
+    template <typename S>
+    void checkSavedViewMatchesAudioFile (int bitDepth, AudioFileFormat format)
+    {
+        const int numChannels = 2;
+        const int numSamples = 5000;
+        const int startSample = 300;
+        const int numSamplesToSave = 4000;
+        const int frameStride = 3;
+        
+        std::vector<S> frames (numSamples * frameStride);
+        
+        AudioFile<S> reference;
+        reference.setAudioBufferSize (numChannels, numSamplesToSave);
+        reference.setBitDepth (bitDepth);
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+            {
+                S sample = static_cast<S> (0.8 * std::sin (0.01 * (channel + 1) * i));
+                
+                // some silence, so silent blocks are written too
+                if (i > 2000 && i < 3500)
+                    sample = 0;
+                
+                frames[i * frameStride + channel] = sample;
+                
+                if (i >= startSample && i < startSample + numSamplesToSave)
+                    reference.samples[channel][i - startSample] = sample;
+            }
+        }
+        
+        std::string extension = format == AudioFileFormat::Wave ? ".wav" : ".aif";
+        std::string referencePath = projectBuildDirectory + "/audio-write-tests/view-reference" + extension;
+        std::string viewPath = projectBuildDirectory + "/audio-write-tests/view-saved" + extension;
+        
+        REQUIRE (reference.save (referencePath, format));
+        
+        AudioFile<S> writer;
+        writer.setBitDepth (bitDepth);
+        auto view = AudioBufferView<const S>::interleaved (frames.data(), numChannels, numSamples, frameStride);
+        REQUIRE (writer.save (viewPath, view.getSampleRange (startSample, numSamplesToSave), format));
+        
+        CHECK (readSavedViewFile (viewPath) == readSavedViewFile (referencePath));
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioBufferViewTests::SaveFromView")
+    {
+        for (auto format : { AudioFileFormat::Wave, AudioFileFormat::Aiff })
+        {
+            checkSavedViewMatchesAudioFile<float> (16, format);
+            checkSavedViewMatchesAudioFile<float> (24, format);
+            checkSavedViewMatchesAudioFile<double> (32, format);
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioBufferViewTests::AdoptedBuffers")
+    {
+        const int numSamples = 3000;
+        int numTimesDeleted = 0;
+        
+        AudioFile<float> reference;
+        reference.setAudioBufferSize (2, numSamples);
+        
+        float* left = new float[numSamples];
+        float* right = new float[numSamples];
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            left[i] = reference.samples[0][i] = static_cast<float> (0.5 * std::sin (0.02 * i));
+            right[i] = reference.samples[1][i] = static_cast<float> (0.5 * std::cos (0.03 * i));
+        }
+        
+        std::string referencePath = projectBuildDirectory + "/audio-write-tests/adopted-reference.wav";
+        std::string adoptedPath = projectBuildDirectory + "/audio-write-tests/adopted.wav";
+        REQUIRE (reference.save (referencePath));
+        
+        {
+            AdoptedAudioBuffer<float> copy;
+            
+            {
+                float* channels[] = { left, right };
+                
+                AdoptedAudioBuffer<float> adopted (channels, 2, numSamples, [&]
+                {
+                    delete[] left;
+                    delete[] right;
+                    numTimesDeleted++;
+                });
+                
+                copy = adopted;
+            }
+            
+            // the channel pointers were copied, so the buffer is still usable here
+            CHECK (numTimesDeleted == 0);
+            REQUIRE (copy.getNumChannels() == 2);
+            REQUIRE (copy.getNumSamples() == numSamples);
+            CHECK (copy.getView().getPointer (1) == right);
+            
+            AudioFile<float> writer;
+            REQUIRE (writer.save (adoptedPath, copy));
+            CHECK (readSavedViewFile (adoptedPath) == readSavedViewFile (referencePath));
+        }
+        
+        CHECK (numTimesDeleted == 1);
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioBufferViewTests::LazyDecodeIntoView")
+    {
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav";
+        
+        AudioFile<float> reference;
+        REQUIRE (reference.load (filePath));
+        
+        LazyAudioFile<float> lazy;
+        REQUIRE (lazy.load (filePath));
+        
+        // decode a range into the second and third channels of a planar buffer with four channels
+        const int startSample = 777;
+        const int numSamples = 3000;
+        std::vector<float> planar (4 * numSamples, -2.f);
+        AudioBufferView<float> view (planar.data(), 4, numSamples, numSamples, 1);
+        REQUIRE (lazy.decodeInto (view.getChannelRange (1, 2), startSample));
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            REQUIRE (planar[i] == -2.f);
+            REQUIRE (planar[numSamples + i] == reference.samples[0][startSample + i]);
+            REQUIRE (planar[2 * numSamples + i] == reference.samples[1][startSample + i]);
+            REQUIRE (planar[3 * numSamples + i] == -2.f);
+        }
+        
+        // every other sample of each channel
+        std::vector<float> spaced (2 * 2 * numSamples, -2.f);
+        REQUIRE (lazy.decodeInto (AudioBufferView<float> (spaced.data(), 2, numSamples, 2 * numSamples, 2)));
+        CHECK (spaced[2 * 100] == reference.samples[0][100]);
+        CHECK (spaced[2 * numSamples + 2 * 100] == reference.samples[1][100]);
+        CHECK (spaced[2 * 100 + 1] == -2.f);
+        
+        lazy.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (lazy.decodeInto (view.getChannelRange (0, 3)));
+        CHECK_FALSE (lazy.decodeInto (view.getChannelRange (0, 2), reference.getNumSamplesPerChannel() - 10));
+    }
+}
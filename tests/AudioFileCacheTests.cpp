@@ -0,0 +1,191 @@
+#include "doctest.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <AudioFileCache.h>
+
+//=============================================================
+TEST_SUITE ("AudioFileCache Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+
+    //=============================================================
+    std::string writeCacheTestFile (const std::string& fileName, int numSamples, float value)
+    {
+        AudioFile<float> audioFile;
+        audioFile.setAudioBufferSize (2, numSamples);
+
+        for (int channel = 0; channel < audioFile.getNumChannels(); channel++)
+            std::fill (audioFile.samples[channel].begin(), audioFile.samples[channel].end(), value);
+
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/" + fileName;
+        REQUIRE (audioFile.save (filePath, AudioFileFormat::Wave));
+        return filePath;
+    }
+
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::HitsShareTheDecodedFile")
+    {
+        AudioFileCache<float> cache;
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav";
+
+        auto a = cache.load (filePath);
+        auto b = cache.load (filePath);
+
+        REQUIRE (a != nullptr);
+        CHECK (a.get() == b.get());
+
+        AudioFile<float> reference;
+        reference.load (filePath);
+        CHECK (a->getNumSamplesPerChannel() == reference.getNumSamplesPerChannel());
+        CHECK (a->samples[1][1000] == reference.samples[1][1000]);
+
+        auto statistics = cache.getStatistics();
+        CHECK (statistics.hits == 1);
+        CHECK (statistics.misses == 1);
+        CHECK (statistics.numEntries == 1);
+        CHECK (statistics.sizeInBytes == AudioFileCache<float>::getSizeInBytes (*a));
+    }
+
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::MissingFilesAreNotCached")
+    {
+        AudioFileCache<float> cache;
+        cache.shouldLogErrorsToConsole (false);
+
+        CHECK (cache.load (projectBuildDirectory + "/test-audio/does_not_exist.wav") == nullptr);
+        CHECK (cache.getStatistics().misses == 1);
+        CHECK (cache.getStatistics().numEntries == 0);
+    }
+
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::LeastRecentlyUsedFilesAreEvicted")
+    {
+        std::string filePathA = writeCacheTestFile ("cache_a.wav", 1000, 0.1f);
+        std::string filePathB = writeCacheTestFile ("cache_b.wav", 1000, 0.2f);
+        std::string filePathC = writeCacheTestFile ("cache_c.wav", 1000, 0.3f);
+
+        AudioFileCache<float> cache;
+        auto a = cache.load (filePathA);
+        REQUIRE (a != nullptr);
+
+        // room for two files but not three
+        cache.setMaximumSizeInBytes (AudioFileCache<float>::getSizeInBytes (*a) * 2 + 100);
+
+        cache.load (filePathB);
+        cache.load (filePathA); // makes B the least recently used
+        cache.load (filePathC);
+
+        auto statistics = cache.getStatistics();
+        CHECK (statistics.evictions == 1);
+        CHECK (statistics.numEntries == 2);
+        CHECK (statistics.sizeInBytes <= cache.getMaximumSizeInBytes());
+
+        cache.resetStatistics();
+        CHECK (cache.load (filePathA).get() == a.get());
+        cache.load (filePathB);
+        CHECK (cache.getStatistics().hits == 1);
+        CHECK (cache.getStatistics().misses == 1);
+
+        // evicted files stay valid for anyone still holding them
+        cache.clear();
+        CHECK (a->samples[0][10] == doctest::Approx (0.1f).epsilon (0.001));
+    }
+
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::ChangedFilesAreDecodedAgain")
+    {
+        std::string filePath = writeCacheTestFile ("cache_changed.wav", 1000, 0.25f);
+
+        AudioFileCache<float> cache;
+        auto before = cache.load (filePath);
+        REQUIRE (before != nullptr);
+
+        writeCacheTestFile ("cache_changed.wav", 2000, -0.25f);
+
+        auto after = cache.load (filePath);
+        REQUIRE (after != nullptr);
+        CHECK (after.get() != before.get());
+        CHECK (after->getNumSamplesPerChannel() == 2000);
+        CHECK (before->getNumSamplesPerChannel() == 1000);
+        CHECK (cache.getStatistics().misses == 2);
+        CHECK (cache.getStatistics().invalidations == 1);
+    }
+
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::ConcurrentLoadsDecodeOnce")
+    {
+        AudioFileCache<float> cache;
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_24bit_48000.wav";
+
+        std::vector<std::thread> threads;
+        std::vector<AudioFileCache<float>::SharedAudioFile> results (8);
+
+        for (size_t i = 0; i < results.size(); i++)
+            threads.emplace_back ([&, i] { results[i] = cache.load (filePath); });
+
+        for (auto& thread : threads)
+            thread.join();
+
+        for (auto& result : results)
+            CHECK (result.get() == results[0].get());
+
+        // threads that arrive while the file is being decoded wait for it rather than counting as hits
+        auto statistics = cache.getStatistics();
+        CHECK (statistics.misses == 1);
+        CHECK (statistics.hits + statistics.waits == results.size() - 1);
+    }
+
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::LoadsDontWaitForAnOlderVersionOfAFile")
+    {
+        std::string filePath = writeCacheTestFile ("cache_pending.wav", 4000000, 0.25f);
+        std::string newFilePath = writeCacheTestFile ("cache_pending_new.wav", 1000, -0.25f);
+
+        AudioFileCache<float> cache;
+        std::thread oldLoad ([&] { cache.load (filePath); });
+
+        // replace the file while (or soon after) the old version is being decoded
+        while (cache.getStatistics().misses == 0)
+            std::this_thread::yield();
+
+        REQUIRE (std::rename (newFilePath.c_str(), filePath.c_str()) == 0);
+
+        auto after = cache.load (filePath);
+        oldLoad.join();
+
+        REQUIRE (after != nullptr);
+        CHECK (after->getNumSamplesPerChannel() == 1000);
+        CHECK (after->samples[0][0] < 0.f);
+
+        auto cached = cache.load (filePath);
+        REQUIRE (cached != nullptr);
+        CHECK (cached->getNumSamplesPerChannel() == 1000);
+    }
+
+#if defined (__linux__)
+    //=============================================================
+    TEST_CASE ("AudioFileCacheTests::WatchedFilesAreInvalidatedWhenTheyChange")
+    {
+        std::string filePath = writeCacheTestFile ("cache_watched.wav", 1000, 0.5f);
+
+        AudioFileCache<float> cache;
+        REQUIRE (cache.setWatchForFileChanges (true));
+
+        REQUIRE (cache.load (filePath) != nullptr);
+        CHECK (cache.getStatistics().numEntries == 1);
+
+        writeCacheTestFile ("cache_watched.wav", 1000, -0.5f);
+
+        for (int i = 0; i < 200 && cache.getStatistics().numEntries > 0; i++)
+            std::this_thread::sleep_for (std::chrono::milliseconds (10));
+
+        CHECK (cache.getStatistics().numEntries == 0);
+        CHECK (cache.getStatistics().invalidations >= 1);
+        CHECK (cache.load (filePath)->samples[0][0] == doctest::Approx (-0.5f).epsilon (0.001));
+    }
+#endif
+}
@@ -0,0 +1,230 @@
+#include "doctest.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <AudioFile.h>
+
+//=============================================================
+TEST_SUITE ("AudioResampler Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    const double pi = 3.14159265358979323846;
+    
+    //=============================================================
+    std::vector<double> createResamplerSine (double frequency, uint32_t sampleRate, int numSamples, double gain = 0.5)
+    {
+        std::vector<double> sine (numSamples);
+        
+        for (int i = 0; i < numSamples; i++)
+            sine[i] = gain * std::sin (2. * pi * frequency * i / sampleRate);
+        
+        return sine;
+    }
+    
+    //=============================================================
+    /** Resamples a mono signal, passing it to the resampler in blocks of the given size */
+    std::vector<double> resampleInBlocks (AudioResampler<double>& resampler, const std::vector<double>& input, int blockSize)
+    {
+        std::vector<double> output (static_cast<size_t> (resampler.getNumOutputSamples (static_cast<int64_t> (input.size()))));
+        int numInput = static_cast<int> (input.size());
+        int numWritten = 0;
+        
+        for (int start = 0; start < numInput; start += blockSize)
+        {
+            const double* inputChannel = input.data() + start;
+            double* outputChannel = output.data() + numWritten;
+            int numInBlock = std::min (blockSize, numInput - start);
+            
+            int maxNumOutputSamples = resampler.getMaxNumOutputSamples (numInBlock);
+            int numOutputSamples = resampler.process (AudioBufferView<const double> (&inputChannel, 1, numInBlock), AudioBufferView<double> (&outputChannel, 1, static_cast<int> (output.size()) - numWritten));
+            
+            CHECK (numOutputSamples <= maxNumOutputSamples);
+            numWritten += numOutputSamples;
+        }
+        
+        double* outputChannel = output.data() + numWritten;
+        numWritten += resampler.flush (AudioBufferView<double> (&outputChannel, 1, static_cast<int> (output.size()) - numWritten));
+        
+        CHECK (numWritten == static_cast<int> (output.size()));
+        return output;
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioResamplerTests::OutputLengths")
+    {
+        AudioResampler<float> upsampler (44100, 48000, 2);
+        CHECK (upsampler.getNumOutputSamples (44100) == 48000);
+        CHECK (upsampler.getNumOutputSamples (1) == 2);
+        CHECK (upsampler.getNumOutputSamples (0) == 0);
+        CHECK (upsampler.getNumTaps() % 8 == 0);
+        
+        AudioResampler<float> downsampler (96000, 48000, 2);
+        CHECK (downsampler.getNumOutputSamples (96001) == 48001);
+        CHECK (downsampler.getNumTaps() > upsampler.getNumTaps());
+        CHECK (downsampler.getSourceSampleRate() == 96000);
+        CHECK (downsampler.getTargetSampleRate() == 48000);
+        CHECK (downsampler.getNumChannels() == 2);
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioResamplerTests::SinesKeepTheirAmplitudeAndPhase")
+    {
+        for (auto rates : std::vector<std::pair<uint32_t, uint32_t>> { { 44100, 48000 }, { 48000, 44100 }, { 48000, 96000 }, { 96000, 48000 }, { 44100, 44101 } })
+        {
+            AudioResampler<double> resampler (rates.first, rates.second, 1);
+            auto output = resampleInBlocks (resampler, createResamplerSine (1000., rates.first, static_cast<int> (rates.first) / 4), 4096);
+            auto expected = createResamplerSine (1000., rates.second, static_cast<int> (output.size()));
+            
+            // away from the ends, the output is the sine at the new rate, with no delay
+            double maximumError = 0.;
+            
+            for (size_t i = 200; i < output.size() - 200; i++)
+                maximumError = std::max (maximumError, std::abs (output[i] - expected[i]));
+            
+            CHECK (maximumError < 1e-5);
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioResamplerTests::BlockSizeDoesNotChangeTheOutput")
+    {
+        auto input = createResamplerSine (440., 44100, 20000);
+        
+        AudioResampler<double> resampler (44100, 48000, 1);
+        auto wholeOutput = resampleInBlocks (resampler, input, 20000);
+        
+        for (int blockSize : { 1, 7, 100, 1023 })
+        {
+            resampler.reset();
+            CHECK (resampleInBlocks (resampler, input, blockSize) == wholeOutput);
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioResamplerTests::AliasesAreRejected")
+    {
+        // a 30kHz tone at 96kHz would alias to 18kHz at 48kHz
+        AudioResampler<double> resampler (96000, 48000, 1);
+        auto output = resampleInBlocks (resampler, createResamplerSine (30000., 96000, 48000, 1.), 4096);
+        
+        double sumOfSquares = 0.;
+        
+        for (size_t i = 200; i < output.size() - 200; i++)
+            sumOfSquares += output[i] * output[i];
+        
+        double level = 10. * std::log10 (sumOfSquares / (output.size() - 400) / 0.5);
+        CHECK (level < -80.);
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioResamplerTests::ResamplingAnAudioFile")
+    {
+        AudioFile<float> audioFile;
+        audioFile.shouldLogErrorsToConsole (false);
+        audioFile.setSampleRate (48000);
+        audioFile.setAudioBufferSize (2, 48000);
+        
+        for (int i = 0; i < 48000; i++)
+        {
+            audioFile.samples[0][i] = static_cast<float> (0.5 * std::sin (2. * pi * 1000. * i / 48000.));
+            audioFile.samples[1][i] = 0.25f;
+        }
+        
+        double lengthInSeconds = audioFile.getLengthInSeconds();
+        
+        REQUIRE (audioFile.resample (44100));
+        CHECK (audioFile.getSampleRate() == 44100);
+        CHECK (audioFile.getNumChannels() == 2);
+        CHECK (audioFile.getNumSamplesPerChannel() == 44100);
+        CHECK (audioFile.getLengthInSeconds() == doctest::Approx (lengthInSeconds));
+        
+        for (int i = 200; i < 44100 - 200; i += 97)
+        {
+            CHECK (audioFile.samples[0][i] == doctest::Approx (0.5 * std::sin (2. * pi * 1000. * i / 44100.)).epsilon (1e-4));
+            CHECK (audioFile.samples[1][i] == doctest::Approx (0.25).epsilon (1e-4));
+        }
+        
+        CHECK_FALSE (audioFile.resample (0));
+        CHECK (audioFile.getSampleRate() == 44100);
+    }
+    
+    //=============================================================
+    TEST_CASE ("AudioResamplerTests::LoadAs")
+    {
+        for (std::string fileName : { "wav_stereo_16bit_44100.wav", "aiff_stereo_24bit_48000.aif" })
+        {
+            std::string filePath = projectBuildDirectory + "/test-audio/" + fileName;
+            
+            AudioFile<float> original;
+            REQUIRE (original.load (filePath));
+            
+            // loading, mixing and resampling separately gives exactly the same audio
+            AudioFile<float> expected;
+            expected.setSampleRate (original.getSampleRate());
+            expected.setAudioBufferSize (1, original.getNumSamplesPerChannel());
+            
+            for (int i = 0; i < original.getNumSamplesPerChannel(); i++)
+                expected.samples[0][i] = 0.5f * original.samples[0][i] + 0.5f * original.samples[1][i];
+            
+            REQUIRE (expected.resample (16000));
+            
+            AudioFile<float> mono;
+            REQUIRE (mono.loadAs (filePath, 16000, 1));
+            CHECK (mono.getSampleRate() == 16000);
+            CHECK (mono.getBitDepth() == original.getBitDepth());
+            CHECK (mono.samples == expected.samples);
+            
+            AudioFile<float> mixed;
+            REQUIRE (mixed.loadAs (filePath, 16000, std::vector<std::vector<float>> { { 0.5f, 0.5f } }));
+            CHECK (mixed.samples == expected.samples);
+            
+            // without a change of rate or channels, the file is loaded as it is
+            AudioFile<float> unchanged;
+            REQUIRE (unchanged.loadAs (filePath, original.getSampleRate(), 2));
+            CHECK (unchanged.samples == original.samples);
+            
+            // channels can be swapped, dropped or repeated
+            AudioFile<float> swapped;
+            REQUIRE (swapped.loadAs (filePath, original.getSampleRate(), std::vector<std::vector<float>> { { 0.f, 1.f }, { 1.f, 0.f }, { 0.f, 1.f } }));
+            REQUIRE (swapped.getNumChannels() == 3);
+            CHECK (swapped.samples[0] == original.samples[1]);
+            CHECK (swapped.samples[1] == original.samples[0]);
+            CHECK (swapped.samples[2] == original.samples[1]);
+            
+            // only the channels chosen with setChannelsToLoad() are mixed
+            AudioFile<float> right;
+            right.setChannelsToLoad ({ 1 });
+            REQUIRE (right.loadAs (filePath, original.getSampleRate(), 2));
+            REQUIRE (right.getNumChannels() == 2);
+            CHECK (right.samples[0] == original.samples[1]);
+            CHECK (right.samples[1] == original.samples[1]);
+            
+            REQUIRE (right.loadAs (filePath, original.getSampleRate(), std::vector<std::vector<float>> { { 0.5f } }));
+            REQUIRE (right.getNumChannels() == 1);
+            CHECK (right.samples[0][1000] == 0.5f * original.samples[1][1000]);
+            
+            right.shouldLogErrorsToConsole (false);
+            CHECK_FALSE (right.loadAs (filePath, original.getSampleRate(), std::vector<std::vector<float>> { { 0.5f, 0.5f } }));
+        }
+        
+        // a mono file is copied to every channel
+        AudioFile<double> mono;
+        REQUIRE (mono.load (projectBuildDirectory + "/test-audio/wav_mono_16bit_48000.wav"));
+        
+        AudioFile<double> stereo;
+        REQUIRE (stereo.loadAs (projectBuildDirectory + "/test-audio/wav_mono_16bit_48000.wav", 44100, 2));
+        CHECK (stereo.getNumChannels() == 2);
+        CHECK (stereo.samples[0] == stereo.samples[1]);
+        
+        REQUIRE (mono.resample (44100));
+        CHECK (stereo.samples[0] == mono.samples[0]);
+        
+        AudioFile<float> audioFile;
+        audioFile.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (audioFile.loadAs (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav", 16000, std::vector<std::vector<float>> { { 1.f } }));
+        CHECK_FALSE (audioFile.loadAs (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav", 0, 1));
+        CHECK_FALSE (audioFile.loadAs (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav", 16000, 0));
+        CHECK_FALSE (audioFile.loadAs (projectBuildDirectory + "/test-audio/does_not_exist.wav", 16000, 1));
+    }
+}
@@ -0,0 +1,118 @@
+#include "doctest.h"
+#include <iostream>
+#include <vector>
+#include <CompactAudioBuffer.h>
+
+//=============================================================
+TEST_SUITE ("CompactAudioBuffer Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    
+    //=============================================================
+    template <typename S>
+    void checkMatchesAudioFile (const CompactAudioBuffer<S>& compact, const AudioFile<S>& reference)
+    {
+        REQUIRE (compact.getNumChannels() == reference.getNumChannels());
+        REQUIRE (compact.getNumSamplesPerChannel() == reference.getNumSamplesPerChannel());
+        CHECK (compact.getSampleRate() == reference.getSampleRate());
+        CHECK (compact.getBitDepth() == reference.getBitDepth());
+        
+        AudioFile<S> copy;
+        REQUIRE (compact.copyTo (copy));
+        CHECK (copy.samples == reference.samples);
+        
+        int numSamples = compact.getNumSamplesPerChannel();
+        std::vector<S> range (100);
+        compact.readSamples (0, numSamples / 2, 100, range.data());
+        CHECK (std::equal (range.begin(), range.end(), reference.samples[0].begin() + numSamples / 2));
+        
+        for (int i = 0; i < numSamples; i += 1001)
+            CHECK (compact.getSample (compact.getNumChannels() - 1, i) == reference.samples.back()[i]);
+    }
+    
+    //=============================================================
+    TEST_CASE ("CompactAudioBufferTests::SamplesMatchAudioFile")
+    {
+        for (auto fileName : { "wav_stereo_8bit_44100.wav", "wav_stereo_16bit_44100.wav", "wav_stereo_24bit_48000.wav",
+                               "wav_stereo_32bit_44100.wav", "aiff_stereo_8bit_44100.aif", "aiff_stereo_16bit_48000.aif",
+                               "aiff_stereo_24bit_44100.aif", "aiff_stereo_32bit_48000.aif" })
+        {
+            SUBCASE (fileName)
+            {
+                std::string filePath = projectBuildDirectory + "/test-audio/" + fileName;
+                
+                AudioFile<float> reference;
+                REQUIRE (reference.load (filePath));
+                
+                CompactAudioBuffer<float> compact;
+                REQUIRE (compact.load (filePath));
+                CHECK (compact.getStorageBitDepth() == reference.getBitDepth());
+                CHECK (compact.getSizeInBytes() == reference.getNumChannels() * reference.getNumSamplesPerChannel() * reference.getBitDepth() / 8);
+                
+                checkMatchesAudioFile (compact, reference);
+            }
+        }
+        
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_16bit_48000.wav";
+        
+        AudioFile<int16_t> integerReference;
+        REQUIRE (integerReference.load (filePath));
+        
+        CompactAudioBuffer<int16_t> integerCompact;
+        REQUIRE (integerCompact.load (filePath));
+        checkMatchesAudioFile (integerCompact, integerReference);
+    }
+    
+    //=============================================================
+    TEST_CASE ("CompactAudioBufferTests::PaddedSamplesAreStoredNarrower")
+    {
+        // 16-bit audio padded out to 24 bits
+        AudioFile<int32_t> padded;
+        padded.setBitDepth (24);
+        padded.setAudioBufferSize (2, 10000);
+        
+        for (int i = 0; i < 10000; i++)
+        {
+            padded.samples[0][i] = ((i * 37) % 65535 - 32767) * 256;
+            padded.samples[1][i] = -padded.samples[0][i];
+        }
+        
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/compact_padded_24bit.wav";
+        REQUIRE (padded.save (filePath));
+        
+        AudioFile<double> reference;
+        REQUIRE (reference.load (filePath));
+        
+        CompactAudioBuffer<double> compact;
+        REQUIRE (compact.load (filePath));
+        CHECK (compact.getBitDepth() == 24);
+        CHECK (compact.getStorageBitDepth() == 16);
+        CHECK (compact.getSizeInBytes() == 2 * 10000 * 2);
+        
+        checkMatchesAudioFile (compact, reference);
+        
+        // a single sample using the low byte means every byte is needed
+        padded.samples[1][5000] += 1;
+        
+        CompactAudioBuffer<double> full;
+        REQUIRE (full.pack (padded));
+        CHECK (full.getStorageBitDepth() == 24);
+    }
+    
+    //=============================================================
+    TEST_CASE ("CompactAudioBufferTests::InvalidInput")
+    {
+        CompactAudioBuffer<float> compact;
+        compact.shouldLogErrorsToConsole (false);
+        
+        CHECK_FALSE (compact.load (projectBuildDirectory + "/test-audio/does_not_exist.wav"));
+        
+        AudioFile<float> audioFile;
+        CHECK_FALSE (compact.copyTo (audioFile));
+        
+        CompactAudioBuffer<int32_t> integerCompact;
+        integerCompact.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (integerCompact.load (projectBuildDirectory + "/test-audio/wav_stereo_32bit_44100.wav"));
+    }
+}
@@ -0,0 +1,108 @@
+#include "doctest.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <CompressedAudioBuffer.h>
+
+//=============================================================
+TEST_SUITE ("CompressedAudioBuffer Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    
+    //=============================================================
+    template <typename S>
+    void checkRoundTrip (const std::string& fileName)
+    {
+        std::string filePath = projectBuildDirectory + "/test-audio/" + fileName;
+        
+        AudioFile<S> reference;
+        REQUIRE (reference.load (filePath));
+        
+        CompressedAudioBuffer<S> compressed (1000, 4);
+        REQUIRE (compressed.load (filePath));
+        
+        REQUIRE (compressed.getNumChannels() == reference.getNumChannels());
+        REQUIRE (compressed.getNumSamplesPerChannel() == reference.getNumSamplesPerChannel());
+        CHECK (compressed.getSampleRate() == reference.getSampleRate());
+        CHECK (compressed.getBitDepth() == reference.getBitDepth());
+        
+        AudioFile<S> decompressed;
+        REQUIRE (compressed.decompress (decompressed));
+        CHECK (decompressed.samples == reference.samples);
+        CHECK (decompressed.getBitDepth() == reference.getBitDepth());
+        
+        // random access, including ranges that cross block boundaries
+        int numSamples = compressed.getNumSamplesPerChannel();
+        int channel = compressed.getNumChannels() - 1;
+        std::vector<S> range (2500);
+        
+        for (int start : { 0, 999, 1500, numSamples - 2500 })
+        {
+            compressed.readSamples (channel, start, 2500, range.data());
+            CHECK (std::equal (range.begin(), range.end(), reference.samples[channel].begin() + start));
+        }
+        
+        for (int i = 0; i < numSamples; i += 997)
+            CHECK (compressed.getSample (0, i) == reference.samples[0][i]);
+    }
+    
+    //=============================================================
+    TEST_CASE ("CompressedAudioBufferTests::RoundTripIsLossless")
+    {
+        for (auto fileName : { "wav_stereo_8bit_44100.wav", "wav_stereo_16bit_44100.wav", "wav_stereo_24bit_48000.wav",
+                               "wav_stereo_32bit_44100.wav", "aiff_stereo_8bit_44100.aif", "aiff_stereo_16bit_48000.aif",
+                               "aiff_stereo_24bit_44100.aif", "aiff_stereo_32bit_48000.aif", "wav_mono_16bit_44100.wav" })
+        {
+            SUBCASE (fileName)
+            {
+                checkRoundTrip<float> (fileName);
+                checkRoundTrip<double> (fileName);
+            }
+        }
+        
+        checkRoundTrip<int16_t> ("wav_stereo_16bit_48000.wav");
+        checkRoundTrip<int32_t> ("aiff_stereo_24bit_48000.aif");
+        checkRoundTrip<uint8_t> ("wav_stereo_8bit_48000.wav");
+    }
+    
+    //=============================================================
+    TEST_CASE ("CompressedAudioBufferTests::CompressesIntegerAudio")
+    {
+        CompressedAudioBuffer<float> compressed;
+        REQUIRE (compressed.load (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav"));
+        CHECK (compressed.getCompressedSizeInBytes() < compressed.getPCMSizeInBytes());
+        
+        // a full-scale signal with large jumps between samples needs escaped values
+        AudioFile<int32_t> pcmAudio;
+        pcmAudio.setBitDepth (32);
+        pcmAudio.setAudioBufferSize (1, 20000);
+        
+        for (int i = 0; i < 20000; i++)
+            pcmAudio.samples[0][i] = (i % 3 == 0) ? std::numeric_limits<int32_t>::max() : ((i % 3 == 1) ? std::numeric_limits<int32_t>::min() : static_cast<int32_t> (std::sin (i * 0.01) * 1000.));
+        
+        CompressedAudioBuffer<int32_t> extreme;
+        REQUIRE (extreme.compress (pcmAudio));
+        
+        AudioFile<int32_t> decompressed;
+        REQUIRE (extreme.decompress (decompressed));
+        CHECK (decompressed.samples == pcmAudio.samples);
+    }
+    
+    //=============================================================
+    TEST_CASE ("CompressedAudioBufferTests::InvalidInput")
+    {
+        CompressedAudioBuffer<float> compressed;
+        compressed.shouldLogErrorsToConsole (false);
+        
+        CHECK_FALSE (compressed.load (projectBuildDirectory + "/test-audio/does_not_exist.wav"));
+        
+        AudioFile<float> audioFile;
+        CHECK_FALSE (compressed.decompress (audioFile));
+        
+        // a 24-bit file doesn't fit into 16-bit samples
+        CompressedAudioBuffer<int16_t> tooSmall;
+        tooSmall.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (tooSmall.load (projectBuildDirectory + "/test-audio/wav_stereo_24bit_44100.wav"));
+    }
+}
@@ -2,7 +2,10 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <fstream>
+#include <iterator>
 #include <AudioFile.h>
+#include <InterleavedAudioFile.h>
 
 //=============================================================
 const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
@@ -177,6 +180,34 @@ TEST_SUITE ("Writing Tests")
         }
     }
 
+    //=============================================================
+    TEST_CASE ("WritingTest::WriteManyChannels")
+    {
+        const int numChannels = 128;
+        const int numSamples = 3000;
+        
+        AudioFile<double> audioFileWriter;
+        audioFileWriter.setAudioBufferSize (numChannels, numSamples);
+        audioFileWriter.setBitDepth (32);
+        
+        for (int channel = 0; channel < numChannels; channel++)
+            for (int i = 0; i < numSamples; i++)
+                audioFileWriter.samples[channel][i] = std::sin ((channel + 1) * i * 0.001) * 0.9;
+        
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/many_channels.wav";
+        REQUIRE (audioFileWriter.save (filePath));
+        
+        AudioFile<double> audioFileReader;
+        REQUIRE (audioFileReader.load (filePath));
+        REQUIRE (audioFileReader.getNumChannels() == numChannels);
+        REQUIRE (audioFileReader.getNumSamplesPerChannel() == numSamples);
+        
+        // 32-bit WAV files store floats, so we should get back exactly the samples rounded to float
+        for (int channel = 0; channel < numChannels; channel++)
+            for (int i = 0; i < numSamples; i++)
+                REQUIRE (audioFileReader.samples[channel][i] == static_cast<float> (audioFileWriter.samples[channel][i]));
+    }
+    
     //=============================================================
     TEST_CASE ("WritingTest::WriteFromCopiedSampleBuffer")
     {
@@ -189,4 +220,337 @@ TEST_SUITE ("Writing Tests")
         bool savedOK = audioFile2.save (projectBuildDirectory + "/audio-write-tests/copied_audio_file.aif", AudioFileFormat::Aiff);
         CHECK (savedOK);
     }
+    
+    //=============================================================
+    TEST_CASE ("WritingTest::DitheredSaves")
+    {
+        const int numSamples = 44100;
+        const double lowLevel = 0.3 / 32767.;
+        
+        AudioFile<float> audioFile;
+        audioFile.setAudioBufferSize (2, numSamples);
+        audioFile.setBitDepth (16);
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            audioFile.samples[0][i] = (float) lowLevel;
+            audioFile.samples[1][i] = (float) (std::sin (i * 0.01) * 0.8);
+        }
+        
+        std::string unditheredPath = projectBuildDirectory + "/audio-write-tests/undithered.wav";
+        REQUIRE (audioFile.save (unditheredPath));
+        
+        AudioFile<int16_t> undithered;
+        REQUIRE (undithered.load (unditheredPath));
+        
+        for (auto ditherType : {DitherType::Triangular, DitherType::NoiseShaped})
+        {
+            audioFile.setDither (ditherType);
+            
+            std::string firstPath = projectBuildDirectory + "/audio-write-tests/dithered_1.wav";
+            std::string secondPath = projectBuildDirectory + "/audio-write-tests/dithered_2.aif";
+            REQUIRE (audioFile.save (firstPath));
+            REQUIRE (audioFile.save (secondPath, AudioFileFormat::Aiff));
+            
+            AudioFile<int16_t> first, second;
+            REQUIRE (first.load (firstPath));
+            REQUIRE (second.load (secondPath));
+            
+            // the noise only depends on the audio, so every save is the same
+            CHECK (first.samples == second.samples);
+            CHECK (first.samples != undithered.samples);
+            
+            // a level of a fraction of a step survives as the average of the dithered steps
+            double sum = 0.;
+            
+            for (int i = 0; i < numSamples; i++)
+                sum += first.samples[0][i];
+            
+            CHECK (sum / numSamples == doctest::Approx (0.3).epsilon (0.05));
+            
+            if (ditherType == DitherType::Triangular)
+                for (int i = 0; i < numSamples; i++)
+                    REQUIRE (std::abs (first.samples[1][i] - undithered.samples[1][i]) <= 2);
+        }
+        
+        // integer samples are never dithered
+        AudioFile<int16_t> integerFile;
+        integerFile.setAudioBuffer (undithered.samples);
+        integerFile.setDither (DitherType::Triangular);
+        REQUIRE (integerFile.save (projectBuildDirectory + "/audio-write-tests/integer_dither.wav"));
+        
+        AudioFile<int16_t> integerReader;
+        REQUIRE (integerReader.load (projectBuildDirectory + "/audio-write-tests/integer_dither.wav"));
+        CHECK (integerReader.samples == undithered.samples);
+        
+        // interleaved frames are dithered with the same noise
+        InterleavedAudioFile<float> interleavedFile;
+        interleavedFile.setAudioBufferSize (2, numSamples);
+        interleavedFile.setBitDepth (16);
+        interleavedFile.setDither (DitherType::NoiseShaped);
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            interleavedFile.frames[i * 2] = audioFile.samples[0][i];
+            interleavedFile.frames[i * 2 + 1] = audioFile.samples[1][i];
+        }
+        
+        std::string interleavedPath = projectBuildDirectory + "/audio-write-tests/dithered_interleaved.wav";
+        REQUIRE (interleavedFile.save (interleavedPath));
+        
+        AudioFile<int16_t> interleavedReader, planarReader;
+        REQUIRE (interleavedReader.load (interleavedPath));
+        REQUIRE (planarReader.load (projectBuildDirectory + "/audio-write-tests/dithered_1.wav"));
+        CHECK (interleavedReader.samples == planarReader.samples);
+    }
+    
+    //=============================================================
+    TEST_CASE ("WritingTest::ParallelEncodingMatchesOneThread")
+    {
+        const int numChannels = 3;
+        const int numSamples = 100001;
+        
+        AudioFile<float> audioFile;
+        audioFile.setAudioBufferSize (numChannels, numSamples);
+        
+        // a stretch of silence that doesn't start on a block boundary
+        for (int channel = 0; channel < numChannels; channel++)
+            for (int i = 0; i < numSamples; i++)
+                audioFile.samples[channel][i] = (i > 20500 && i < 60000) ? 0.f : (float) std::sin ((channel + 1) * i * 0.003);
+        
+        auto saveAndRead = [&] (int numThreads, AudioFileFormat format)
+        {
+            std::string filePath = projectBuildDirectory + "/audio-write-tests/parallel_encoding.wav";
+            audioFile.setNumEncodingThreads (numThreads);
+            REQUIRE (audioFile.save (filePath, format));
+            
+            std::ifstream file (filePath, std::ios::binary);
+            return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+        };
+        
+        for (int bitDepth : {8, 16, 24, 32})
+        {
+            for (auto ditherType : {DitherType::None, DitherType::Triangular, DitherType::NoiseShaped})
+            {
+                audioFile.setBitDepth (bitDepth);
+                audioFile.setDither (ditherType);
+                
+                for (auto format : {AudioFileFormat::Wave, AudioFileFormat::Aiff})
+                {
+                    auto oneThread = saveAndRead (1, format);
+                    CHECK (saveAndRead (4, format) == oneThread);
+                    CHECK (saveAndRead (0, format) == oneThread);
+                }
+            }
+        }
+        
+        // interleaved frames, and samples with a stride between them
+        std::vector<float> frames (static_cast<size_t> (numSamples) * numChannels);
+        
+        for (int i = 0; i < numSamples; i++)
+            for (int channel = 0; channel < numChannels; channel++)
+                frames[i * numChannels + channel] = audioFile.samples[channel][i];
+        
+        auto interleaved = AudioBufferView<const float>::interleaved (frames.data(), numChannels, numSamples);
+        auto everyOtherChannel = AudioBufferView<const float> (frames.data(), 2, numSamples, 2, numChannels);
+        
+        for (auto view : {interleaved, everyOtherChannel})
+        {
+            std::string filePath = projectBuildDirectory + "/audio-write-tests/parallel_encoding_view.wav";
+            std::vector<uint8_t> savedBytes[2];
+            
+            for (int numThreads : {1, 4})
+            {
+                AudioFile<float> writer;
+                writer.setBitDepth (24);
+                writer.setNumEncodingThreads (numThreads);
+                REQUIRE (writer.save (filePath, view));
+                
+                std::ifstream file (filePath, std::ios::binary);
+                savedBytes[numThreads == 1 ? 0 : 1].assign ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+            }
+            
+            CHECK (savedBytes[0] == savedBytes[1]);
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("WritingTest::MappedSavesMatchBufferedSaves")
+    {
+        AudioFile<float> audioFile;
+        REQUIRE (audioFile.load (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav"));
+        audioFile.iXMLChunk = "<BWFXML><IXML_VERSION>1.5</IXML_VERSION></BWFXML>";
+        
+        auto readBytes = [] (const std::string& filePath)
+        {
+            std::ifstream file (filePath, std::ios::binary);
+            return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+        };
+        
+        std::string bufferedPath = projectBuildDirectory + "/audio-write-tests/buffered_save";
+        std::string mappedPath = projectBuildDirectory + "/audio-write-tests/mapped_save";
+        
+        for (int bitDepth : {16, 24, 32})
+        {
+            for (auto format : {AudioFileFormat::Wave, AudioFileFormat::Aiff})
+            {
+                for (auto sync : {MappedFileSync::Kernel, MappedFileSync::OnClose})
+                {
+                    audioFile.setBitDepth (bitDepth);
+                    REQUIRE (audioFile.save (bufferedPath, format));
+                    REQUIRE (audioFile.saveMapped (mappedPath, format, sync));
+                    CHECK (readBytes (mappedPath) == readBytes (bufferedPath));
+                }
+            }
+        }
+        
+        // saving over a larger file replaces it
+        audioFile.setBitDepth (32);
+        REQUIRE (audioFile.saveMapped (mappedPath));
+        audioFile.setBitDepth (8);
+        REQUIRE (audioFile.saveMapped (mappedPath));
+        REQUIRE (audioFile.save (bufferedPath));
+        CHECK (readBytes (mappedPath) == readBytes (bufferedPath));
+        
+        // a file that can't be created
+        audioFile.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (audioFile.saveMapped (projectBuildDirectory + "/no-such-directory/mapped_save.wav"));
+    }
+    
+    //=============================================================
+    TEST_CASE ("WritingTest::SaveToMemory")
+    {
+        AudioFile<float> audioFile;
+        REQUIRE (audioFile.load (projectBuildDirectory + "/test-audio/aiff_stereo_24bit_48000.aif"));
+        
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/saved_to_memory";
+        
+        for (auto format : {AudioFileFormat::Wave, AudioFileFormat::Aiff})
+        {
+            audioFile.iXMLChunk = format == AudioFileFormat::Wave ? "<BWFXML><IXML_VERSION>1.5</IXML_VERSION></BWFXML>" : "";
+            REQUIRE (audioFile.save (filePath, format));
+            
+            std::ifstream file (filePath, std::ios::binary);
+            std::vector<uint8_t> savedFile ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+            
+            CHECK (audioFile.computeEncodedSize (format) == savedFile.size());
+            
+            std::vector<uint8_t> inMemory = audioFile.saveToMemory (format);
+            CHECK (inMemory == savedFile);
+            
+            // encoding into a larger buffer leaves the bytes after the file alone
+            std::vector<uint8_t> buffer (savedFile.size() + 16, 0xAB);
+            REQUIRE (audioFile.saveToMemory (buffer.data(), buffer.size(), format));
+            CHECK (std::equal (savedFile.begin(), savedFile.end(), buffer.begin()));
+            CHECK (std::all_of (buffer.begin() + savedFile.size(), buffer.end(), [] (uint8_t byte) { return byte == 0xAB; }));
+            
+            AudioFile<float> loaded, loadedFromFile;
+            REQUIRE (loaded.loadFromMemory (inMemory));
+            REQUIRE (loadedFromFile.load (filePath));
+            CHECK (loaded.samples == loadedFromFile.samples);
+            
+            // a buffer that is too small
+            audioFile.shouldLogErrorsToConsole (false);
+            CHECK_FALSE (audioFile.saveToMemory (buffer.data(), savedFile.size() - 1, format));
+            audioFile.shouldLogErrorsToConsole (true);
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("WritingTest::AsyncSaves")
+    {
+        auto readBytes = [] (const std::string& filePath)
+        {
+            std::ifstream file (filePath, std::ios::binary);
+            return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+        };
+        
+        AudioFile<float> audioFile;
+        REQUIRE (audioFile.load (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav"));
+        
+        std::string expectedPath = projectBuildDirectory + "/audio-write-tests/async_expected.wav";
+        std::string asyncPath = projectBuildDirectory + "/audio-write-tests/async_saved.wav";
+        std::string cancelledPath = projectBuildDirectory + "/audio-write-tests/async_cancelled.wav";
+        REQUIRE (audioFile.save (expectedPath));
+        std::remove (asyncPath.c_str());
+        std::remove (cancelledPath.c_str());
+        
+        // a pointer the caller took before saving
+        float* rightChannel = audioFile.samples[1].data();
+        
+        AudioFileWriterPool pool (1);
+        
+        // hold up the writer thread, so the next saves stay queued
+        std::mutex blocker;
+        std::unique_lock<std::mutex> blockWriter (blocker);
+        pool.add ([&] (const std::atomic<bool>&) { std::lock_guard<std::mutex> guard (blocker); return true; });
+        
+        std::atomic<int> numCallbacks {0};
+        SaveStatus reportedStatus = SaveStatus::Queued;
+        
+        SaveHandle save = audioFile.saveAsync (asyncPath, AudioFileFormat::Wave, [&] (SaveStatus status)
+        {
+            reportedStatus = status;
+            numCallbacks++;
+        }, pool);
+        
+        SaveHandle cancelledSave = audioFile.saveAsync (cancelledPath, AudioFileFormat::Wave, [&] (SaveStatus status)
+        {
+            CHECK (status == SaveStatus::Cancelled);
+            numCallbacks++;
+        }, pool);
+        
+        // the file is saved as the audio was when the save was started
+        audioFile.samples[0][100] = 0.5f;
+        rightChannel[200] = 0.25f;
+        audioFile.setBitDepth (24);
+        
+        CHECK (save.getStatus() == SaveStatus::Queued);
+        CHECK_FALSE (save.waitFor (10));
+        
+        cancelledSave.cancel();
+        CHECK (cancelledSave.getStatus() == SaveStatus::Cancelled);
+        CHECK (numCallbacks == 1);
+        
+        blockWriter.unlock();
+        
+        CHECK (save.wait() == SaveStatus::Saved);
+        CHECK (cancelledSave.wait() == SaveStatus::Cancelled);
+        CHECK (save.isFinished());
+        CHECK (numCallbacks == 2);
+        CHECK (reportedStatus == SaveStatus::Saved);
+        
+        CHECK (readBytes (asyncPath) == readBytes (expectedPath));
+        CHECK_FALSE (std::ifstream (cancelledPath).good());
+        
+        // a save that fails
+        audioFile.shouldLogErrorsToConsole (false);
+        SaveHandle failedSave = audioFile.saveAsync (projectBuildDirectory + "/no-such-directory/async.wav", AudioFileFormat::Wave, {}, pool);
+        CHECK (failedSave.wait() == SaveStatus::Failed);
+        
+        // a callback can wait for its own save, which already has its final status
+        std::unique_lock<std::mutex> blockWriterAgain (blocker);
+        pool.add ([&] (const std::atomic<bool>&) { std::lock_guard<std::mutex> guard (blocker); return true; });
+        
+        SaveHandle waitingSave;
+        SaveStatus statusInCallback = SaveStatus::Queued;
+        bool finishedInCallback = false;
+        
+        waitingSave = audioFile.saveAsync (asyncPath, AudioFileFormat::Wave, [&] (SaveStatus)
+        {
+            finishedInCallback = waitingSave.isFinished();
+            statusInCallback = waitingSave.wait();
+        }, pool);
+        
+        blockWriterAgain.unlock();
+        
+        REQUIRE (waitingSave.waitFor (10000));
+        CHECK (statusInCallback == SaveStatus::Saved);
+        CHECK (finishedInCallback);
+        
+        // the default pool
+        audioFile.setBitDepth (16);
+        audioFile.samples[0][100] = 0.f;
+        CHECK (audioFile.saveAsync (asyncPath).wait() == SaveStatus::Saved);
+    }
 }
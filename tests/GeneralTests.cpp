@@ -1,5 +1,7 @@
 #include "doctest.h"
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <vector>
 #include <math.h>
 #include <AudioFile.h>
@@ -31,6 +33,13 @@ TEST_SUITE ("General Tests")
         }
     }
 
+    //=============================================================
+    std::vector<uint8_t> readBytesFromFile (const std::string& filePath)
+    {
+        std::ifstream file (filePath, std::ios::binary);
+        return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    }
+
     //=============================================================
     TEST_CASE ("GeneralTests::CopyConstructor")
     {
@@ -107,4 +116,364 @@ TEST_SUITE ("General Tests")
             
         checkFilesAreExactlyTheSame<int16_t> (a, b);
     }
+
+    //=============================================================
+    TEST_CASE ("GeneralTests::FixedPointFormat")
+    {
+        // 16-bit files load into Q15 exactly as they would as integers
+        AudioFile<int16_t> sixteenBit (projectBuildDirectory + "/test-audio/aiff_stereo_16bit_44100.aif");
+        AudioFile<Q15> q15 (projectBuildDirectory + "/test-audio/aiff_stereo_16bit_44100.aif");
+        
+        REQUIRE (q15.getNumSamplesPerChannel() == sixteenBit.getNumSamplesPerChannel());
+        
+        for (int i = 0; i < q15.getNumSamplesPerChannel(); i++)
+            REQUIRE (q15.samples[1][i].value == sixteenBit.samples[1][i]);
+        
+        // 24-bit files load into Q31 at the top of each sample
+        AudioFile<int32_t> twentyFourBit (projectBuildDirectory + "/test-audio/wav_stereo_24bit_48000.wav");
+        AudioFile<Q31> q31 (projectBuildDirectory + "/test-audio/wav_stereo_24bit_48000.wav");
+        
+        REQUIRE (q31.getNumSamplesPerChannel() == twentyFourBit.getNumSamplesPerChannel());
+        
+        for (int i = 0; i < q31.getNumSamplesPerChannel(); i++)
+            REQUIRE (q31.samples[0][i].value == twentyFourBit.samples[0][i] * 256);
+        
+        // and both save the same files as the integer types
+        for (auto format : { AudioFileFormat::Wave, AudioFileFormat::Aiff })
+        {
+            std::string extension = format == AudioFileFormat::Wave ? ".wav" : ".aif";
+            
+            REQUIRE (sixteenBit.save (projectBuildDirectory + "/audio-write-tests/fixed-point-int16" + extension, format));
+            REQUIRE (q15.save (projectBuildDirectory + "/audio-write-tests/fixed-point-q15" + extension, format));
+            REQUIRE (twentyFourBit.save (projectBuildDirectory + "/audio-write-tests/fixed-point-int32" + extension, format));
+            REQUIRE (q31.save (projectBuildDirectory + "/audio-write-tests/fixed-point-q31" + extension, format));
+            
+            AudioFile<int16_t> a (projectBuildDirectory + "/audio-write-tests/fixed-point-int16" + extension);
+            AudioFile<int16_t> b (projectBuildDirectory + "/audio-write-tests/fixed-point-q15" + extension);
+            CHECK (a.samples == b.samples);
+            
+            AudioFile<int32_t> c (projectBuildDirectory + "/audio-write-tests/fixed-point-int32" + extension);
+            AudioFile<int32_t> d (projectBuildDirectory + "/audio-write-tests/fixed-point-q31" + extension);
+            CHECK (c.getBitDepth() == 24);
+            CHECK (c.samples == d.samples);
+        }
+    }
+    
+    //=============================================================
+    float sumOfChannel (const std::vector<float>& channel)
+    {
+        float sum = 0.f;
+        
+        for (float sample : channel)
+            sum += sample;
+        
+        return sum;
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::SamplesAreVectorsOfVectors")
+    {
+        AudioFile<float> a;
+        a.load (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav");
+        
+        // the samples can be used anywhere a vector of vectors can
+        std::vector<std::vector<float>>& buffer = a.samples;
+        std::vector<float>& left = a.samples[0];
+        CHECK (&buffer[0] == &left);
+        CHECK (sumOfChannel (a.samples[1]) == sumOfChannel (buffer[1]));
+        
+        a.samples[0].at (10) = 0.5f;
+        a.samples[0].insert (a.samples[0].begin(), 0.25f);
+        a.samples[0].erase (a.samples[0].begin());
+        a.samples.emplace_back (a.samples[1]);
+        CHECK (a.getNumChannels() == 3);
+        CHECK (a.samples[0][10] == 0.5f);
+        
+        // and copying an AudioFile copies them
+        AudioFile<float> b (a);
+        b.samples[1][1000] = 0.5f;
+        CHECK (b.samples[0] == a.samples[0]);
+        CHECK (a.samples[1][1000] != 0.5f);
+        CHECK (b.samples[0].data() != a.samples[0].data());
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::SampleBufferCopiesShareSamplesUntilModified")
+    {
+        AudioFile<float> audioFile;
+        audioFile.load (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav");
+        AudioFile<float>::AudioBuffer original = audioFile.samples;
+        
+        // moving the samples of an AudioFile in doesn't copy them
+        const float* right = audioFile.samples[1].data();
+        AudioSampleBuffer<float> a (std::move (audioFile.samples));
+        
+        AudioSampleBuffer<float> b (a);
+        const AudioSampleBuffer<float>& constA = a;
+        const AudioSampleBuffer<float>& constB = b;
+        
+        CHECK (constA[1].data() == right);
+        CHECK (b[0].isSharedWith (a[0]));
+        CHECK (b[1].isSharedWith (a[1]));
+        CHECK (constB[0][1000] == constA[0][1000]);
+        CHECK (b[0].isSharedWith (a[0]));
+        
+        // writing to one channel of the copy only copies that channel
+        float originalSample = constB[1][1000];
+        b[1][1000] = 0.5f;
+        
+        CHECK (b[0].isSharedWith (a[0]));
+        CHECK_FALSE (b[1].isSharedWith (a[1]));
+        CHECK (constA[1][1000] == originalSample);
+        CHECK (b[1][1000] == 0.5f);
+        
+        // the samples can be read as vectors, and set back into an AudioFile
+        const std::vector<float>& rightChannel = constA[1];
+        CHECK (rightChannel.size() == original[1].size());
+        
+        AudioFile<float> c;
+        REQUIRE (c.setAudioBuffer (a));
+        CHECK (c.samples == original);
+        CHECK (std::vector<std::vector<float>> (a) == original);
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::SampleBufferCopiesAreIndependentOfPointersIntoTheOriginal")
+    {
+        AudioSampleBuffer<float> a (2);
+        a[0].resize (1000);
+        a[1].resize (1000);
+        
+        // a pointer taken before the copy still only writes to the original...
+        float* left = a[0].data();
+        float& right = a[1][10];
+        
+        AudioSampleBuffer<float> b = a;
+        AudioSampleBuffer<float> c;
+        c = a;
+        
+        CHECK_FALSE (b[0].isSharedWith (a[0]));
+        CHECK_FALSE (c[1].isSharedWith (a[1]));
+        
+        left[0] = 1.f;
+        right = 0.5f;
+        
+        const AudioSampleBuffer<float>& constA = a;
+        const AudioSampleBuffer<float>& constB = b;
+        const AudioSampleBuffer<float>& constC = c;
+        CHECK (constA[0][0] == 1.f);
+        CHECK (constA[1][10] == 0.5f);
+        CHECK (constB[0][0] == 0.f);
+        CHECK (constC[1][10] == 0.f);
+        
+        // ...until the pointers are released, after which copies share the samples again
+        a.releaseWritableReferences();
+        AudioSampleBuffer<float> d = a;
+        CHECK (d[0].isSharedWith (a[0]));
+        CHECK (d[1].isSharedWith (a[1]));
+        
+        a[0][0] = 0.25f;
+        CHECK_FALSE (d[0].isSharedWith (a[0]));
+        CHECK (static_cast<const AudioSampleBuffer<float>&> (d)[0][0] == 1.f);
+        
+        // channels that can be written to are never merged with identical channels
+        AudioSampleBuffer<float> buffer (2);
+        buffer[0].resize (100);
+        buffer[1].resize (100);
+        float* second = buffer[1].data();
+        CHECK (buffer.shareIdenticalChannels() == 0);
+        second[0] = 1.f;
+        CHECK (static_cast<const AudioSampleBuffer<float>&> (buffer)[0][0] == 0.f);
+        
+        second[0] = 0.f;
+        buffer.releaseWritableReferences();
+        CHECK (buffer.shareIdenticalChannels() == 1);
+        
+        // empty channels can be read through a const reference
+        const AudioSampleChannel<float> empty;
+        CHECK (empty.data() == nullptr);
+        CHECK (empty.begin() == empty.end());
+        CHECK (empty.size() == 0);
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::MovedBuffersAreTakenOver")
+    {
+        std::vector<std::vector<float>> vectors (2, std::vector<float> (50000, 0.25f));
+        const float* left = vectors[0].data();
+        
+        AudioFile<float> a;
+        REQUIRE (a.setAudioBuffer (std::move (vectors)));
+        REQUIRE (a.getNumChannels() == 2);
+        REQUIRE (a.getNumSamplesPerChannel() == 50000);
+        CHECK (a.samples[0].data() == left);
+        
+        // buffers that are copied in are not
+        AudioFile<float>::AudioBuffer buffer = a.samples;
+        const float* right = buffer[1].data();
+        
+        AudioFile<float> b;
+        REQUIRE (b.setAudioBuffer (buffer));
+        CHECK (b.samples[1].data() != right);
+        
+        REQUIRE (b.setAudioBuffer (std::move (buffer)));
+        CHECK (b.samples[1].data() == right);
+        CHECK (b.samples == a.samples);
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::IdenticalChannelsShareOneBuffer")
+    {
+        AudioFile<float> source;
+        source.load (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav");
+        
+        // four channels, where the third and fourth are copies of the first
+        AudioFile<float>::AudioBuffer buffer (4);
+        buffer[0] = source.samples[0];
+        buffer[1] = source.samples[1];
+        buffer[2] = source.samples[0];
+        buffer[3] = source.samples[0];
+        
+        AudioFile<float> multi;
+        multi.setAudioBuffer (buffer);
+        multi.setBitDepth (16);
+        multi.setSampleRate (44100);
+        
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/duplicate-channels.wav";
+        REQUIRE (multi.save (filePath));
+        
+        AudioFile<float> a;
+        a.load (filePath);
+        
+        AudioFile<float> b;
+        b.load (filePath);
+        
+        AudioSampleBuffer<float> shared (std::move (b.samples));
+        CHECK_FALSE (shared[2].isSharedWith (shared[0]));
+        CHECK (shared.shareIdenticalChannels() == 2);
+        
+        REQUIRE (shared.size() == 4);
+        CHECK (shared[2].isSharedWith (shared[0]));
+        CHECK (shared[3].isSharedWith (shared[0]));
+        CHECK_FALSE (shared[1].isSharedWith (shared[0]));
+        
+        // every channel is still written out, exactly as without sharing
+        std::string unsharedPath = projectBuildDirectory + "/audio-write-tests/duplicate-channels-unshared.wav";
+        std::string sharedPath = projectBuildDirectory + "/audio-write-tests/duplicate-channels-shared.wav";
+        REQUIRE (b.setAudioBuffer (shared));
+        CHECK (b.samples == a.samples);
+        REQUIRE (a.save (unsharedPath));
+        REQUIRE (b.save (sharedPath));
+        CHECK (readBytesFromFile (sharedPath) == readBytesFromFile (unsharedPath));
+        
+        // modifying a shared channel doesn't change the others
+        shared[2][0] = 0.25f;
+        CHECK_FALSE (shared[2].isSharedWith (shared[0]));
+        CHECK (shared[3].isSharedWith (shared[0]));
+        CHECK (static_cast<const AudioSampleBuffer<float>&> (shared)[0][0] == a.samples[0][0]);
+        
+        // values that compare equal but have different bits are not shared
+        AudioSampleBuffer<float> zeros { { 0.f, 0.f }, { 0.f, -0.f } };
+        CHECK (zeros.shareIdenticalChannels() == 0);
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::LoadRangeOfSamples")
+    {
+        for (auto fileName : { "wav_stereo_16bit_44100.wav", "wav_stereo_24bit_48000.wav", "wav_stereo_32bit_44100.wav",
+                               "aiff_stereo_8bit_44100.aif", "aiff_stereo_24bit_48000.aif", "aiff_stereo_32bit_44100.aif" })
+        {
+            SUBCASE (fileName)
+            {
+                std::string filePath = projectBuildDirectory + "/test-audio/" + fileName;
+                
+                AudioFile<float> whole;
+                REQUIRE (whole.load (filePath));
+                
+                AudioFile<float> part;
+                REQUIRE (part.load (filePath, 1000, 2500));
+                
+                REQUIRE (part.getNumChannels() == whole.getNumChannels());
+                REQUIRE (part.getNumSamplesPerChannel() == 2500);
+                CHECK (part.getSampleRate() == whole.getSampleRate());
+                CHECK (part.getBitDepth() == whole.getBitDepth());
+                CHECK (part.isFloatingPointFormat() == whole.isFloatingPointFormat());
+                
+                for (int channel = 0; channel < part.getNumChannels(); channel++)
+                    CHECK (std::equal (part.samples[channel].begin(), part.samples[channel].end(), whole.samples[channel].begin() + 1000));
+                
+                // ranges running past the end are cut short
+                int numSamples = whole.getNumSamplesPerChannel();
+                REQUIRE (part.load (filePath, numSamples - 10, 100));
+                CHECK (part.getNumSamplesPerChannel() == 10);
+                CHECK (part.samples[1][9] == whole.samples[1][numSamples - 1]);
+                
+                // ranges given in seconds
+                double sampleRate = whole.getSampleRate();
+                REQUIRE (part.loadTimeRange (filePath, 100. / sampleRate, 0.01));
+                CHECK (part.getNumSamplesPerChannel() == static_cast<int> (std::round (0.01 * sampleRate)));
+                CHECK (part.samples[0][0] == whole.samples[0][100]);
+            }
+        }
+        
+        AudioFile<float> audioFile;
+        audioFile.shouldLogErrorsToConsole (false);
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav";
+        
+        CHECK_FALSE (audioFile.load (filePath, -1, 100));
+        CHECK_FALSE (audioFile.load (filePath, 100000000, 100));
+        CHECK_FALSE (audioFile.load (projectBuildDirectory + "/test-audio/does_not_exist.wav", 0, 100));
+    }
+    
+    //=============================================================
+    TEST_CASE ("GeneralTests::LoadSomeOfTheChannels")
+    {
+        AudioFile<float> source;
+        source.setAudioBufferSize (6, 40000);
+        source.setBitDepth (24);
+        source.setSampleRate (48000);
+        
+        for (int channel = 0; channel < 6; channel++)
+            for (int i = 0; i < 40000; i++)
+                source.samples[channel][i] = static_cast<float> (((i * 13 + channel * 701) % 2001) - 1000) / 1000.f;
+        
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/six-channels.wav";
+        REQUIRE (source.save (filePath));
+        
+        AudioFile<float> all;
+        REQUIRE (all.load (filePath));
+        REQUIRE (all.getNumChannels() == 6);
+        
+        AudioFile<float> some;
+        some.setChannelsToLoad ({ 4, 1 });
+        REQUIRE (some.load (filePath));
+        REQUIRE (some.getNumChannels() == 2);
+        CHECK (some.getNumSamplesPerChannel() == 40000);
+        CHECK (some.samples[0] == all.samples[4]);
+        CHECK (some.samples[1] == all.samples[1]);
+        
+        // files in memory are decoded in the same way
+        std::ifstream file (filePath, std::ios::binary);
+        std::vector<uint8_t> fileData ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+        
+        AudioFile<float> fromMemory;
+        fromMemory.setChannelsToLoad ({ 4, 1 });
+        REQUIRE (fromMemory.loadFromMemory (fileData));
+        CHECK (fromMemory.samples == some.samples);
+        
+        // the channels can be combined with a range of samples
+        REQUIRE (some.load (filePath, 100, 50));
+        REQUIRE (some.getNumChannels() == 2);
+        CHECK (some.getNumSamplesPerChannel() == 50);
+        CHECK (some.samples[0][0] == all.samples[4][100]);
+        CHECK (some.samples[1][49] == all.samples[1][149]);
+        
+        some.shouldLogErrorsToConsole (false);
+        some.setChannelsToLoad ({ 0, 6 });
+        CHECK_FALSE (some.load (filePath));
+        
+        some.setChannelsToLoad ({});
+        REQUIRE (some.load (filePath));
+        CHECK (some.samples == all.samples);
+    }
 }
@@ -0,0 +1,123 @@
+#include "doctest.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <InterleavedAudioFile.h>
+
+//=============================================================
+TEST_SUITE ("InterleavedAudioFile Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    
+    //=============================================================
+    std::vector<uint8_t> readInterleavedTestFile (const std::string& filePath)
+    {
+        std::ifstream file (filePath, std::ios::binary);
+        return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    }
+    
+    //=============================================================
+    template <typename S>
+    void checkFramesMatchFile (const std::string& filePath)
+    {
+        AudioFile<S> reference;
+        REQUIRE (reference.load (filePath));
+        
+        InterleavedAudioFile<S> interleaved;
+        REQUIRE (interleaved.load (filePath));
+        
+        std::vector<uint8_t> fileData = readInterleavedTestFile (filePath);
+        InterleavedAudioFile<S> fromMemory;
+        REQUIRE (fromMemory.loadFromMemory (fileData));
+        CHECK (fromMemory.frames == interleaved.frames);
+        
+        REQUIRE (interleaved.getNumChannels() == reference.getNumChannels());
+        REQUIRE (interleaved.getNumSamplesPerChannel() == reference.getNumSamplesPerChannel());
+        CHECK (interleaved.getSampleRate() == reference.getSampleRate());
+        CHECK (interleaved.getBitDepth() == reference.getBitDepth());
+        CHECK (interleaved.isFloatingPointFormat() == reference.isFloatingPointFormat());
+        
+        int numChannels = interleaved.getNumChannels();
+        
+        for (int i = 0; i < interleaved.getNumSamplesPerChannel(); i++)
+            for (int channel = 0; channel < numChannels; channel++)
+                REQUIRE (interleaved.frames[i * numChannels + channel] == reference.samples[channel][i]);
+    }
+    
+    //=============================================================
+    TEST_CASE ("InterleavedAudioFileTests::FramesMatchAudioFile")
+    {
+        for (auto fileName : { "wav_mono_16bit_44100.wav", "wav_stereo_8bit_44100.wav", "wav_stereo_16bit_44100.wav",
+                               "wav_stereo_24bit_48000.wav", "wav_stereo_32bit_44100.wav", "aiff_stereo_8bit_44100.aif",
+                               "aiff_stereo_16bit_48000.aif", "aiff_stereo_24bit_44100.aif", "aiff_stereo_32bit_48000.aif" })
+        {
+            SUBCASE (fileName)
+            {
+                std::string filePath = projectBuildDirectory + "/test-audio/" + fileName;
+                
+                checkFramesMatchFile<float> (filePath);
+                checkFramesMatchFile<int32_t> (filePath);
+            }
+        }
+        
+        // samples that are read straight into the frames
+        checkFramesMatchFile<int16_t> (projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav");
+        checkFramesMatchFile<uint8_t> (projectBuildDirectory + "/test-audio/wav_stereo_8bit_44100.wav");
+    }
+    
+    //=============================================================
+    TEST_CASE ("InterleavedAudioFileTests::SavedFilesMatchAudioFile")
+    {
+        const int numChannels = 3;
+        const int numSamples = 5000;
+        
+        AudioFile<float> audioFile;
+        audioFile.setAudioBufferSize (numChannels, numSamples);
+        audioFile.setSampleRate (48000);
+        audioFile.iXMLChunk = "<BWFXML></BWFXML>";
+        
+        InterleavedAudioFile<float> interleaved;
+        interleaved.setAudioBufferSize (numChannels, numSamples);
+        interleaved.setSampleRate (48000);
+        interleaved.iXMLChunk = audioFile.iXMLChunk;
+        
+        for (int i = 0; i < numSamples; i++)
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+            {
+                // with some silence, which is written differently
+                float sample = i < 2048 ? 0.f : std::sin (i * 0.01f * (channel + 1)) * 0.5f;
+                audioFile.samples[channel][i] = sample;
+                interleaved.frames[i * numChannels + channel] = sample;
+            }
+        }
+        
+        for (int bitDepth : { 8, 16, 24, 32 })
+        {
+            audioFile.setBitDepth (bitDepth);
+            interleaved.setBitDepth (bitDepth);
+            
+            std::string expectedPath = projectBuildDirectory + "/audio-write-tests/interleaved-expected.wav";
+            std::string filePath = projectBuildDirectory + "/audio-write-tests/interleaved.wav";
+            REQUIRE (audioFile.save (expectedPath));
+            REQUIRE (interleaved.save (filePath));
+            CHECK (readInterleavedTestFile (filePath) == readInterleavedTestFile (expectedPath));
+        }
+        
+        // AIFF files can only be mono or stereo
+        audioFile.setNumChannels (2);
+        interleaved.setAudioBufferSize (2, numSamples);
+        
+        for (int i = 0; i < numSamples; i++)
+            for (int channel = 0; channel < 2; channel++)
+                interleaved.frames[i * 2 + channel] = audioFile.samples[channel][i];
+        
+        std::string expectedPath = projectBuildDirectory + "/audio-write-tests/interleaved-expected.aif";
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/interleaved.aif";
+        REQUIRE (audioFile.save (expectedPath, AudioFileFormat::Aiff));
+        REQUIRE (interleaved.save (filePath, AudioFileFormat::Aiff));
+        CHECK (readInterleavedTestFile (filePath) == readInterleavedTestFile (expectedPath));
+    }
+}
@@ -0,0 +1,155 @@
+#include "doctest.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <LazyAudioFile.h>
+
+//=============================================================
+TEST_SUITE ("LazyAudioFile Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    
+    //=============================================================
+    TEST_CASE ("LazyAudioFileTests::SamplesMatchAudioFile")
+    {
+        for (auto fileName : { "wav_mono_16bit_44100.wav", "wav_stereo_8bit_44100.wav", "wav_stereo_16bit_44100.wav",
+                               "wav_stereo_24bit_48000.wav", "wav_stereo_32bit_44100.wav", "aiff_stereo_8bit_44100.aif",
+                               "aiff_stereo_16bit_48000.aif", "aiff_stereo_24bit_44100.aif", "aiff_stereo_32bit_48000.aif" })
+        {
+            SUBCASE (fileName)
+            {
+                std::string filePath = projectBuildDirectory + "/test-audio/" + fileName;
+                
+                AudioFile<float> reference;
+                REQUIRE (reference.load (filePath));
+                
+                LazyAudioFile<float> lazy;
+                REQUIRE (lazy.load (filePath));
+                
+                REQUIRE (lazy.getNumChannels() == reference.getNumChannels());
+                REQUIRE (lazy.getNumSamplesPerChannel() == reference.getNumSamplesPerChannel());
+                CHECK (lazy.getSampleRate() == reference.getSampleRate());
+                CHECK (lazy.getBitDepth() == reference.getBitDepth());
+                CHECK (lazy.getLengthInSeconds() == reference.getLengthInSeconds());
+                CHECK (lazy.isFloatingPointFormat() == reference.isFloatingPointFormat());
+                
+                int numSamples = lazy.getNumSamplesPerChannel();
+                std::vector<float> range (100);
+                lazy.readSamples (lazy.getNumChannels() - 1, numSamples / 2, 100, range.data());
+                CHECK (std::equal (range.begin(), range.end(), reference.samples.back().begin() + numSamples / 2));
+                
+                for (int i = 0; i < numSamples; i += 1001)
+                    CHECK (lazy.getSample (0, i) == reference.samples[0][i]);
+                
+                CHECK_FALSE (lazy.isFullyDecoded());
+                
+                const AudioFile<float>& audioFile = lazy.getAudioFile();
+                CHECK (lazy.isFullyDecoded());
+                CHECK (audioFile.samples == reference.samples);
+                CHECK (audioFile.getSampleRate() == reference.getSampleRate());
+                CHECK (audioFile.getBitDepth() == reference.getBitDepth());
+            }
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("LazyAudioFileTests::HeaderOnly")
+    {
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/lazy-header.wav";
+        
+        AudioFile<int32_t> audioFile;
+        audioFile.setAudioBufferSize (3, 10000);
+        audioFile.setBitDepth (24);
+        audioFile.setSampleRate (96000);
+        audioFile.iXMLChunk = "<BWFXML></BWFXML>";
+        
+        for (int channel = 0; channel < 3; channel++)
+            for (int i = 0; i < 10000; i++)
+                audioFile.samples[channel][i] = (i * 97 + channel * 1013) % 20001 - 10000;
+        
+        REQUIRE (audioFile.save (filePath));
+        
+        AudioHeader<int32_t> header;
+        REQUIRE (header.loadHeader (filePath));
+        CHECK (header.getAudioFormat() == AudioFileFormat::Wave);
+        CHECK (header.getNumChannels() == 3);
+        CHECK (header.getNumSamplesPerChannel() == 10000);
+        CHECK (header.getSampleRate() == 96000);
+        CHECK (header.getBitDepth() == 24);
+        CHECK (header.getIXMLChunk() == audioFile.iXMLChunk);
+        
+        LazyAudioFile<int32_t> lazy;
+        REQUIRE (lazy.load (filePath));
+        CHECK (lazy.getSample (2, 9999) == audioFile.samples[2][9999]);
+        CHECK (lazy.getAudioFile().iXMLChunk == audioFile.iXMLChunk);
+        CHECK (lazy.getAudioFile().samples == audioFile.samples);
+        
+        // files that can't be loaded with this sample type are rejected up front
+        LazyAudioFile<int16_t> tooSmall;
+        tooSmall.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (tooSmall.load (filePath));
+        CHECK (tooSmall.getNumChannels() == 0);
+        
+        LazyAudioFile<float> missing;
+        missing.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (missing.load (projectBuildDirectory + "/test-audio/does_not_exist.wav"));
+    }
+    
+    //=============================================================
+    TEST_CASE ("LazyAudioFileTests::DecodeIntoOwnBuffers")
+    {
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_24bit_48000.wav";
+        
+        AudioFile<float> reference;
+        REQUIRE (reference.load (filePath));
+        int numSamples = reference.getNumSamplesPerChannel();
+        
+        // decode from a copy of the file in memory
+        std::ifstream file (filePath, std::ios::binary);
+        std::vector<uint8_t> fileData ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+        
+        LazyAudioFile<float> lazy;
+        REQUIRE (lazy.loadFromMemory (fileData.data(), fileData.size()));
+        REQUIRE (lazy.getNumChannels() == 2);
+        REQUIRE (lazy.getNumSamplesPerChannel() == numSamples);
+        
+        std::vector<float> left (numSamples), right (numSamples);
+        float* channels[] = { left.data(), right.data() };
+        REQUIRE (lazy.decodeInto (channels, 2, numSamples));
+        CHECK (std::equal (left.begin(), left.end(), reference.samples[0].begin()));
+        CHECK (std::equal (right.begin(), right.end(), reference.samples[1].begin()));
+        
+        // a range, into frames with room for four channels
+        const int frameStride = 4;
+        const int startSample = 1234;
+        const int numFrames = 5000;
+        std::vector<float> frames (numFrames * frameStride, -2.f);
+        REQUIRE (lazy.decodeInterleavedInto (startSample, numFrames, frames.data(), frameStride, numFrames));
+        
+        for (int i = 0; i < numFrames; i++)
+        {
+            REQUIRE (frames[i * frameStride] == reference.samples[0][startSample + i]);
+            REQUIRE (frames[i * frameStride + 1] == reference.samples[1][startSample + i]);
+            REQUIRE (frames[i * frameStride + 2] == -2.f);
+        }
+        
+        // buffers that don't fit are rejected before anything is written
+        lazy.shouldLogErrorsToConsole (false);
+        std::vector<float> small (100, -2.f);
+        float* smallChannels[] = { small.data(), small.data() };
+        CHECK_FALSE (lazy.decodeInto (smallChannels, 2, 100));
+        CHECK_FALSE (lazy.decodeInto (channels, 1, numSamples));
+        CHECK_FALSE (lazy.decodeInto (numSamples - 10, 20, channels, 2, numSamples));
+        CHECK_FALSE (lazy.decodeInterleavedInto (small.data(), 2, 50));
+        CHECK_FALSE (lazy.decodeInterleavedInto (0, 10, small.data(), 1, 100));
+        CHECK (std::all_of (small.begin(), small.end(), [] (float sample) { return sample == -2.f; }));
+        
+        // data that stops part way through the samples
+        LazyAudioFile<float> truncated;
+        truncated.shouldLogErrorsToConsole (false);
+        CHECK_FALSE (truncated.loadFromMemory (fileData.data(), fileData.size() / 2));
+        CHECK_FALSE (truncated.decodeInto (channels, 2, numSamples));
+    }
+}
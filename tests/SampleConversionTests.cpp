@@ -769,3 +769,284 @@ TEST_SUITE ("SampleConversionTests::32-bit Conversions")
         REQUIRE_EQ (AudioSampleConverter<int64_t>::sampleToThirtyTwoBitInt (std::numeric_limits<int64_t>::min()), -2147483648);
     }
 }
+
+//=============================================================
+TEST_SUITE ("SampleConversionTests::Samples Stored As Is")
+{
+    //=============================================================
+    TEST_CASE ("Samples Stored As Is::isStoredAsIs")
+    {
+        bool littleEndian = AudioSampleConverter<float>::isLittleEndianMachine();
+        
+        REQUIRE_EQ (AudioSampleConverter<int16_t>::isStoredAsIs (16, AudioFileFormat::Wave, false), littleEndian);
+        REQUIRE_EQ (AudioSampleConverter<int32_t>::isStoredAsIs (32, AudioFileFormat::Wave, false), littleEndian);
+        REQUIRE_EQ (AudioSampleConverter<float>::isStoredAsIs (32, AudioFileFormat::Wave, true), littleEndian);
+        REQUIRE (AudioSampleConverter<uint8_t>::isStoredAsIs (8, AudioFileFormat::Wave, false));
+        REQUIRE (AudioSampleConverter<int8_t>::isStoredAsIs (8, AudioFileFormat::Aiff, false));
+        
+        REQUIRE_FALSE (AudioSampleConverter<int16_t>::isStoredAsIs (16, AudioFileFormat::Aiff, false));
+        REQUIRE_FALSE (AudioSampleConverter<int32_t>::isStoredAsIs (32, AudioFileFormat::Wave, true));
+        REQUIRE_FALSE (AudioSampleConverter<int32_t>::isStoredAsIs (24, AudioFileFormat::Wave, false));
+        REQUIRE_FALSE (AudioSampleConverter<float>::isStoredAsIs (32, AudioFileFormat::Wave, false));
+        REQUIRE_FALSE (AudioSampleConverter<uint16_t>::isStoredAsIs (16, AudioFileFormat::Wave, false));
+        REQUIRE_FALSE (AudioSampleConverter<uint8_t>::isStoredAsIs (8, AudioFileFormat::Aiff, false));
+        REQUIRE_FALSE (AudioSampleConverter<int8_t>::isStoredAsIs (8, AudioFileFormat::Wave, false));
+    }
+    
+    //=============================================================
+    TEST_CASE ("Samples Stored As Is::copying matches converting")
+    {
+        // the copy must give exactly what converting each sample would
+        std::vector<uint8_t> bytes;
+        
+        for (int i = 0; i < 3 * 256; i++)
+            bytes.push_back (static_cast<uint8_t> (i * 37 + (i >> 8)));
+        
+        const int numFrames = 128;
+        std::vector<int16_t> copied (numFrames);
+        AudioSampleConverter<int16_t>::decodeSamples (bytes.data() + 2, 6, numFrames, 16, AudioFileFormat::Wave, false, copied.data());
+        
+        for (int i = 0; i < numFrames; i++)
+        {
+            const uint8_t* b = bytes.data() + 2 + i * 6;
+            REQUIRE_EQ (copied[i], AudioSampleConverter<int16_t>::sixteenBitIntToSample (static_cast<int16_t> ((b[1] << 8) | b[0])));
+        }
+        
+        std::vector<uint8_t> encoded (bytes.size(), 0);
+        AudioSampleConverter<int16_t>::encodeSamples (copied.data(), numFrames, 16, AudioFileFormat::Wave, false, encoded.data() + 2, 6);
+        
+        for (int i = 0; i < numFrames; i++)
+        {
+            REQUIRE_EQ (encoded[2 + i * 6], bytes[2 + i * 6]);
+            REQUIRE_EQ (encoded[3 + i * 6], bytes[3 + i * 6]);
+            REQUIRE_EQ (encoded[4 + i * 6], 0);
+        }
+        
+        // interleaved floats, both aligned and not aligned for the sample type
+        std::vector<float> samples (numFrames);
+        
+        for (int i = 0; i < numFrames; i++)
+            samples[i] = static_cast<float> (i - 64) / 64.f;
+        
+        for (size_t offset : { 4, 1 })
+        {
+            std::vector<uint8_t> frames (numFrames * 8 + 8, 0);
+            AudioSampleConverter<float>::encodeSamples (samples.data(), numFrames, 32, AudioFileFormat::Wave, true, frames.data() + offset, 8);
+            
+            for (int i = 0; i < numFrames; i++)
+            {
+                const uint8_t* b = frames.data() + offset + i * 8;
+                int32_t sampleAsInt = (b[3] << 24) | (b[2] << 16) | (b[1] << 8) | b[0];
+                float sampleAsFloat;
+                std::memcpy (&sampleAsFloat, &sampleAsInt, sizeof (float));
+                
+                REQUIRE_EQ (sampleAsFloat, samples[i]);
+                REQUIRE_EQ (b[4], 0);
+            }
+        }
+    }
+}
+
+//=============================================================
+TEST_SUITE ("SampleConversionTests::Runs of Samples")
+{
+    //=============================================================
+    template <typename T>
+    void checkRunsMatchSingleSamples()
+    {
+        using Converter = AudioSampleConverter<T>;
+        
+        const int numValues = 65536;
+        std::vector<int8_t> signedBytes (numValues);
+        std::vector<uint8_t> unsignedBytes (numValues);
+        std::vector<int16_t> sixteenBitInts (numValues);
+        std::vector<int32_t> twentyFourBitInts (numValues), thirtyTwoBitInts (numValues);
+        std::vector<T> samples (numValues);
+        
+        for (int i = 0; i < numValues; i++)
+        {
+            signedBytes[i] = static_cast<int8_t> (i);
+            unsignedBytes[i] = static_cast<uint8_t> (i);
+            sixteenBitInts[i] = static_cast<int16_t> (i - 32768);
+            twentyFourBitInts[i] = (i - 32768) * 256 + (i & 0xFF);
+            thirtyTwoBitInts[i] = static_cast<int32_t> (static_cast<uint32_t> (i) * 65537u + 12345u);
+            
+            if constexpr (std::is_floating_point<T>::value)
+                samples[i] = static_cast<T> ((i - 32768) / 30000.);
+            else
+                samples[i] = static_cast<T> (thirtyTwoBitInts[i]);
+        }
+        
+        std::vector<T> decoded (numValues);
+        
+        Converter::signedBytesToSamples (signedBytes.data(), decoded.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (decoded[i], Converter::signedByteToSample (signedBytes[i]));
+        
+        Converter::unsignedBytesToSamples (unsignedBytes.data(), decoded.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (decoded[i], Converter::unsignedByteToSample (unsignedBytes[i]));
+        
+        Converter::sixteenBitIntsToSamples (sixteenBitInts.data(), decoded.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (decoded[i], Converter::sixteenBitIntToSample (sixteenBitInts[i]));
+        
+        Converter::twentyFourBitIntsToSamples (twentyFourBitInts.data(), decoded.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (decoded[i], Converter::twentyFourBitIntToSample (twentyFourBitInts[i]));
+        
+        Converter::thirtyTwoBitIntsToSamples (thirtyTwoBitInts.data(), decoded.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (decoded[i], Converter::thirtyTwoBitIntToSample (thirtyTwoBitInts[i]));
+        
+        std::vector<int8_t> encodedSignedBytes (numValues);
+        Converter::samplesToSignedBytes (samples.data(), encodedSignedBytes.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (encodedSignedBytes[i], Converter::sampleToSignedByte (samples[i]));
+        
+        std::vector<uint8_t> encodedUnsignedBytes (numValues);
+        Converter::samplesToUnsignedBytes (samples.data(), encodedUnsignedBytes.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (encodedUnsignedBytes[i], Converter::sampleToUnsignedByte (samples[i]));
+        
+        std::vector<int16_t> encodedSixteenBitInts (numValues);
+        Converter::samplesToSixteenBitInts (samples.data(), encodedSixteenBitInts.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (encodedSixteenBitInts[i], Converter::sampleToSixteenBitInt (samples[i]));
+        
+        std::vector<int32_t> encodedInts (numValues);
+        Converter::samplesToTwentyFourBitInts (samples.data(), encodedInts.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (encodedInts[i], Converter::sampleToTwentyFourBitInt (samples[i]));
+        
+        Converter::samplesToThirtyTwoBitInts (samples.data(), encodedInts.data(), numValues);
+        for (int i = 0; i < numValues; i++)
+            REQUIRE_EQ (encodedInts[i], Converter::sampleToThirtyTwoBitInt (samples[i]));
+    }
+    
+    //=============================================================
+    TEST_CASE ("Runs of Samples::runs match single samples")
+    {
+        checkRunsMatchSingleSamples<float>();
+        checkRunsMatchSingleSamples<double>();
+        checkRunsMatchSingleSamples<int8_t>();
+        checkRunsMatchSingleSamples<uint8_t>();
+        checkRunsMatchSingleSamples<int16_t>();
+        checkRunsMatchSingleSamples<uint16_t>();
+        checkRunsMatchSingleSamples<int32_t>();
+        checkRunsMatchSingleSamples<uint32_t>();
+    }
+    
+    //=============================================================
+    TEST_CASE ("Runs of Samples::strides")
+    {
+        // one channel of interleaved stereo, into every third sample of the destination
+        std::vector<int16_t> frames { 100, -1, 200, -1, 300, -1, 400, -1 };
+        std::vector<float> samples (12, 5.f);
+        
+        AudioSampleConverter<float>::sixteenBitIntsToSamples (frames.data(), samples.data(), 4, 2, 3);
+        
+        for (int i = 0; i < 4; i++)
+        {
+            REQUIRE_EQ (samples[i * 3], AudioSampleConverter<float>::sixteenBitIntToSample (static_cast<int16_t> (100 * (i + 1))));
+            REQUIRE_EQ (samples[i * 3 + 1], 5.f);
+            REQUIRE_EQ (samples[i * 3 + 2], 5.f);
+        }
+        
+        std::vector<int16_t> encoded (8, 7);
+        AudioSampleConverter<float>::samplesToSixteenBitInts (samples.data(), encoded.data(), 4, 3, 2);
+        
+        for (int i = 0; i < 4; i++)
+        {
+            REQUIRE_EQ (encoded[i * 2], AudioSampleConverter<float>::sampleToSixteenBitInt (samples[i * 3]));
+            REQUIRE_EQ (encoded[i * 2 + 1], 7);
+        }
+    }
+}
+
+//=============================================================
+TEST_SUITE ("SampleConversionTests::Fixed Point Conversions")
+{
+    //=============================================================
+    Q15 q15 (int16_t value) { return Q15 { value }; }
+    Q31 q31 (int32_t value) { return Q31 { value }; }
+    
+    //=============================================================
+    TEST_CASE ("Fixed Point Conversions::integer codes to fixed point")
+    {
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sixteenBitIntToSample (-32768).value, -32768);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sixteenBitIntToSample (12345).value, 12345);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::sixteenBitIntToSample (-2).value, -131072);
+        
+        REQUIRE_EQ (AudioSampleConverter<Q31>::twentyFourBitIntToSample (8388607).value, 2147483392);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::twentyFourBitIntToSample (-8388608).value, std::numeric_limits<int32_t>::min());
+        
+        // codes with more bits are rounded to the nearest value, saturating at the top of the range
+        REQUIRE_EQ (AudioSampleConverter<Q15>::twentyFourBitIntToSample (127).value, 0);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::twentyFourBitIntToSample (128).value, 1);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::twentyFourBitIntToSample (-129).value, -1);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::twentyFourBitIntToSample (8388607).value, 32767);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::twentyFourBitIntToSample (-8388608).value, -32768);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::thirtyTwoBitIntToSample (std::numeric_limits<int32_t>::max()).value, 32767);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::thirtyTwoBitIntToSample (-5).value, -5);
+        
+        REQUIRE_EQ (AudioSampleConverter<Q15>::signedByteToSample (-128).value, -32768);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::signedByteToSample (127).value, 32512);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::unsignedByteToSample (0).value, -32768);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::unsignedByteToSample (128).value, 0);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::unsignedByteToSample (255).value, 127 << 24);
+    }
+    
+    //=============================================================
+    TEST_CASE ("Fixed Point Conversions::fixed point to integer codes")
+    {
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToSixteenBitInt (q15 (-32768)), -32768);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToSixteenBitInt (q15 (321)), 321);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToTwentyFourBitInt (q15 (-1)), -256);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToThirtyTwoBitInt (q15 (32767)), 32767 << 16);
+        
+        REQUIRE_EQ (AudioSampleConverter<Q31>::sampleToThirtyTwoBitInt (q31 (-7)), -7);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::sampleToSixteenBitInt (q31 (std::numeric_limits<int32_t>::max())), 32767);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::sampleToSixteenBitInt (q31 (std::numeric_limits<int32_t>::min())), -32768);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::sampleToSixteenBitInt (q31 (0x8000)), 1);
+        REQUIRE_EQ (AudioSampleConverter<Q31>::sampleToTwentyFourBitInt (q31 (0x7FFFFF80)), 8388607);
+        
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToSignedByte (q15 (32767)), 127);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToSignedByte (q15 (-32768)), -128);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToUnsignedByte (q15 (32767)), 255);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToUnsignedByte (q15 (-32768)), 0);
+        REQUIRE_EQ (AudioSampleConverter<Q15>::sampleToUnsignedByte (q15 (0)), 128);
+    }
+    
+    //=============================================================
+    TEST_CASE ("Fixed Point Conversions::floating point data")
+    {
+        auto decodeFloat = [] (float value)
+        {
+            uint8_t bytes[4];
+            memcpy (bytes, &value, 4);
+            
+            if (! AudioSampleConverter<Q15>::isLittleEndianMachine())
+                std::reverse (bytes, bytes + 4);
+            
+            Q15 sample;
+            AudioSampleConverter<Q15>::decodeSamples (bytes, 4, 1, 32, AudioFileFormat::Wave, true, &sample);
+            return sample.value;
+        };
+        
+        REQUIRE_EQ (decodeFloat (0.5f), 16384);
+        REQUIRE_EQ (decodeFloat (-1.f), -32768);
+        REQUIRE_EQ (decodeFloat (1.f), 32767);
+        REQUIRE_EQ (decodeFloat (-3.f), -32768);
+        REQUIRE_EQ (decodeFloat (std::numeric_limits<float>::quiet_NaN()), 0);
+    }
+    
+    //=============================================================
+    TEST_CASE ("Fixed Point Conversions::stored as is")
+    {
+        REQUIRE (AudioSampleConverter<Q15>::isStoredAsIs (16, AudioFileFormat::Wave, false) == AudioSampleConverter<Q15>::isLittleEndianMachine());
+        REQUIRE (AudioSampleConverter<Q31>::isStoredAsIs (32, AudioFileFormat::Wave, false) == AudioSampleConverter<Q31>::isLittleEndianMachine());
+        REQUIRE_FALSE (AudioSampleConverter<Q31>::isStoredAsIs (32, AudioFileFormat::Wave, true));
+        REQUIRE_FALSE (AudioSampleConverter<Q15>::isStoredAsIs (16, AudioFileFormat::Aiff, false));
+    }
+}
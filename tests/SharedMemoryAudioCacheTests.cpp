@@ -0,0 +1,251 @@
+#include "doctest.h"
+#include <iostream>
+#include <vector>
+#include <SharedMemoryAudioCache.h>
+
+#if ! defined (_WIN32)
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
+
+//=============================================================
+TEST_SUITE ("SharedMemoryAudioCache Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+
+    //=============================================================
+    std::string getTestCacheName (const std::string& testName)
+    {
+    #if defined (_WIN32)
+        return "aftest-" + testName;
+    #else
+        return "aftest-" + testName + "-" + std::to_string (getpid());
+    #endif
+    }
+
+    //=============================================================
+    template <typename S>
+    void checkEntryMatchesFile (const typename SharedMemoryAudioCache<S>::Entry& entry, AudioFile<S>& audioFile)
+    {
+        REQUIRE (entry.getNumChannels() == audioFile.getNumChannels());
+        REQUIRE (entry.getNumSamplesPerChannel() == audioFile.getNumSamplesPerChannel());
+        CHECK (entry.getSampleRate() == audioFile.getSampleRate());
+        CHECK (entry.getBitDepth() == audioFile.getBitDepth());
+
+        for (int channel = 0; channel < entry.getNumChannels(); channel++)
+        {
+            const S* samples = entry.getReadPointer (channel);
+            CHECK (std::equal (samples, samples + entry.getNumSamplesPerChannel(), audioFile.samples[channel].begin()));
+        }
+    }
+
+    //=============================================================
+    TEST_CASE ("SharedMemoryAudioCacheTests::DecodedAudioIsShared")
+    {
+        std::string cacheName = getTestCacheName ("shared");
+        SharedMemoryAudioCache<float>::remove (cacheName);
+
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_16bit_44100.wav";
+
+        AudioFile<float> reference;
+        REQUIRE (reference.load (filePath));
+
+        SharedMemoryAudioCache<float> firstCache (cacheName);
+        SharedMemoryAudioCache<float> secondCache (cacheName);
+        REQUIRE (firstCache.isConnected());
+        REQUIRE (secondCache.isConnected());
+
+        auto a = firstCache.load (filePath);
+        auto b = secondCache.load (filePath);
+
+        REQUIRE (a != nullptr);
+        REQUIRE (b != nullptr);
+        CHECK (a->isInSharedMemory());
+        CHECK (b->isInSharedMemory());
+        CHECK (firstCache.getStatistics().misses == 1);
+        CHECK (secondCache.getStatistics().hits == 1);
+
+        checkEntryMatchesFile<float> (*a, reference);
+        checkEntryMatchesFile<float> (*b, reference);
+
+        AudioFile<float> copy;
+        b->copyTo (copy);
+        CHECK (copy.samples == reference.samples);
+
+        // a different sample type must never attach to these buffers
+        SharedMemoryAudioCache<double> doubleCache (cacheName);
+        auto c = doubleCache.load (filePath);
+        REQUIRE (c != nullptr);
+        CHECK (doubleCache.getStatistics().misses == 1);
+        CHECK (doubleCache.getStatistics().hits == 0);
+
+        // nor must a fixed point type attach to the buffers of an integer type of the same size
+        SharedMemoryAudioCache<uint16_t> unsignedCache (cacheName);
+        SharedMemoryAudioCache<Q15> fixedPointCache (cacheName);
+        REQUIRE (unsignedCache.load (filePath) != nullptr);
+        auto d = fixedPointCache.load (filePath);
+        REQUIRE (d != nullptr);
+        CHECK (fixedPointCache.getStatistics().misses == 1);
+        CHECK (fixedPointCache.getStatistics().hits == 0);
+
+        AudioFile<Q15> fixedPointReference (filePath);
+        REQUIRE (d->getNumSamplesPerChannel() == fixedPointReference.getNumSamplesPerChannel());
+        CHECK (d->getReadPointer (1)[1000].value == fixedPointReference.samples[1][1000].value);
+
+        SharedMemoryAudioCache<float>::remove (cacheName);
+
+        // audio that is already mapped stays valid after the cache is removed
+        checkEntryMatchesFile<float> (*b, reference);
+    }
+
+    //=============================================================
+    TEST_CASE ("SharedMemoryAudioCacheTests::MissingFiles")
+    {
+        std::string cacheName = getTestCacheName ("missing");
+        SharedMemoryAudioCache<float>::remove (cacheName);
+
+        SharedMemoryAudioCache<float> cache (cacheName);
+        cache.shouldLogErrorsToConsole (false);
+
+        CHECK (cache.load (projectBuildDirectory + "/test-audio/does_not_exist.wav") == nullptr);
+
+        SharedMemoryAudioCache<float>::remove (cacheName);
+    }
+
+    //=============================================================
+    TEST_CASE ("SharedMemoryAudioCacheTests::ChangedFilesReuseTheirSlot")
+    {
+        std::string cacheName = getTestCacheName ("changing");
+        SharedMemoryAudioCache<float>::remove (cacheName);
+
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/shared-cache-changing.wav";
+        const uint32_t numIndexSlots = 4;
+
+        SharedMemoryAudioCache<float> cache (cacheName, numIndexSlots);
+        SharedMemoryAudioCache<float> otherCache (cacheName);
+        REQUIRE (cache.isConnected());
+
+        AudioFile<float> previousVersion;
+        SharedMemoryAudioCache<float>::SharedEntry previousEntry;
+
+        // every version of the file has a different size, so the cache sees it as changed
+        for (int version = 0; version < static_cast<int> (numIndexSlots) * 3; version++)
+        {
+            AudioFile<float> audioFile;
+            audioFile.setAudioBufferSize (1, 1000 + version);
+            audioFile.setBitDepth (16);
+
+            for (int i = 0; i < audioFile.getNumSamplesPerChannel(); i++)
+                audioFile.samples[0][i] = static_cast<float> ((i + version) % 100) / 200.f;
+
+            REQUIRE (audioFile.save (filePath));
+
+            AudioFile<float> reference;
+            REQUIRE (reference.load (filePath));
+
+            auto entry = cache.load (filePath);
+            REQUIRE (entry != nullptr);
+            CHECK (entry->isInSharedMemory());
+            checkEntryMatchesFile<float> (*entry, reference);
+
+            auto otherEntry = otherCache.load (filePath);
+            REQUIRE (otherEntry != nullptr);
+            CHECK (otherEntry->isInSharedMemory());
+
+            // audio of the old version that is still mapped stays valid
+            if (previousEntry != nullptr)
+                checkEntryMatchesFile<float> (*previousEntry, previousVersion);
+
+            previousEntry = entry;
+            previousVersion = reference;
+        }
+
+        CHECK (cache.getStatistics().misses == numIndexSlots * 3);
+        CHECK (cache.getStatistics().privateLoads == 0);
+        CHECK (otherCache.getStatistics().hits == numIndexSlots * 3);
+        CHECK (otherCache.getStatistics().privateLoads == 0);
+
+        SharedMemoryAudioCache<float>::remove (cacheName);
+    }
+
+#if ! defined (_WIN32)
+    //=============================================================
+    TEST_CASE ("SharedMemoryAudioCacheTests::ManyProcessesDecodeOnce")
+    {
+        std::string cacheName = getTestCacheName ("processes");
+        SharedMemoryAudioCache<float>::remove (cacheName);
+
+        std::string filePath = projectBuildDirectory + "/test-audio/wav_stereo_24bit_48000.wav";
+
+        AudioFile<float> reference;
+        REQUIRE (reference.load (filePath));
+
+        enum ChildResult { Attached = 0, Decoded = 1, BadStatistics = 2, NotShared = 3, WrongAudio = 4 };
+
+        const int numProcesses = 6;
+        std::vector<pid_t> children;
+
+        for (int i = 0; i < numProcesses; i++)
+        {
+            pid_t child = fork();
+            REQUIRE (child >= 0);
+
+            if (child == 0)
+            {
+                SharedMemoryAudioCache<float> cache (cacheName);
+                auto entry = cache.load (filePath);
+
+                if (entry == nullptr || ! entry->isInSharedMemory())
+                    _exit (NotShared);
+
+                for (int channel = 0; channel < entry->getNumChannels(); channel++)
+                {
+                    const float* samples = entry->getReadPointer (channel);
+
+                    if (! std::equal (samples, samples + entry->getNumSamplesPerChannel(), reference.samples[channel].begin()))
+                        _exit (WrongAudio);
+                }
+
+                auto statistics = cache.getStatistics();
+
+                if (statistics.misses == 1 && statistics.hits == 0)
+                    _exit (Decoded);
+                else if (statistics.misses == 0 && statistics.hits == 1)
+                    _exit (Attached);
+
+                _exit (BadStatistics);
+            }
+
+            children.push_back (child);
+        }
+
+        int numDecoded = 0;
+        int numAttached = 0;
+
+        for (pid_t child : children)
+        {
+            int status = 0;
+            REQUIRE (waitpid (child, &status, 0) == child);
+            REQUIRE (WIFEXITED (status));
+
+            int result = WEXITSTATUS (status);
+            CHECK (result <= Decoded);
+            numDecoded += result == Decoded ? 1 : 0;
+            numAttached += result == Attached ? 1 : 0;
+        }
+
+        CHECK (numDecoded == 1);
+        CHECK (numAttached == numProcesses - 1);
+
+        // the audio outlives the process that decoded it
+        SharedMemoryAudioCache<float> cache (cacheName);
+        auto entry = cache.load (filePath);
+        REQUIRE (entry != nullptr);
+        CHECK (cache.getStatistics().hits == 1);
+        checkEntryMatchesFile<float> (*entry, reference);
+
+        SharedMemoryAudioCache<float>::remove (cacheName);
+    }
+#endif
+}
@@ -0,0 +1,198 @@
+#include "doctest.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <cmath>
+#include <SparseAudioBuffer.h>
+
+//=============================================================
+TEST_SUITE ("SparseAudioBuffer Tests")
+{
+    //=============================================================
+    const std::string projectBuildDirectory = PROJECT_BINARY_DIR;
+    
+    //=============================================================
+    std::vector<uint8_t> readFile (const std::string& filePath)
+    {
+        std::ifstream file (filePath, std::ios::binary);
+        return std::vector<uint8_t> ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char>());
+    }
+    
+    //=============================================================
+    // a tone that only plays for one second in every three (starting part way through a block)
+    template <typename S>
+    void fillWithMostlySilentAudio (AudioFile<S>& audioFile, int numChannels, int numSamples, double amplitude)
+    {
+        audioFile.setAudioBufferSize (numChannels, numSamples);
+        audioFile.setSampleRate (44100);
+        
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            for (int i = 0; i < numSamples; i++)
+            {
+                bool isPlaying = ((i + 1000) / 44100) % 3 == 0;
+                double value = isPlaying ? amplitude * std::sin (i * 0.05 * (channel + 1)) : 0.;
+                audioFile.samples[channel][i] = static_cast<S> (value);
+            }
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("SparseAudioBufferTests::SilentBlocksTakeNoMemory")
+    {
+        AudioFile<float> audioFile;
+        fillWithMostlySilentAudio (audioFile, 2, 44100 * 9, 0.5);
+        
+        SparseAudioBuffer<float> sparse;
+        REQUIRE (sparse.store (audioFile));
+        
+        CHECK (sparse.getNumChannels() == 2);
+        CHECK (sparse.getNumSamplesPerChannel() == audioFile.getNumSamplesPerChannel());
+        CHECK (sparse.getNumSilentBlocks() > 0);
+        CHECK (sparse.getSizeInBytes() < audioFile.getNumChannels() * audioFile.getNumSamplesPerChannel() * sizeof (float) / 2);
+        
+        CHECK (sparse.isSilent (0, 44100 * 2));
+        CHECK_FALSE (sparse.isSilent (0, 100));
+        CHECK (sparse.getSample (1, 44100 * 2) == 0.f);
+        
+        AudioFile<float> copy;
+        REQUIRE (sparse.copyTo (copy));
+        CHECK (copy.samples == audioFile.samples);
+        
+        // a range spanning silent and non-silent blocks
+        std::vector<float> range (20000);
+        sparse.readSamples (1, 40000, 20000, range.data());
+        CHECK (std::equal (range.begin(), range.end(), copy.samples[1].begin() + 40000));
+    }
+    
+    //=============================================================
+    // a short burst of sound, then silence that includes negative zeros. The reference files
+    // in test-audio/reference-saves hold this audio as saved by the original encoder
+    void fillWithSignedZeros (AudioFile<float>& audioFile)
+    {
+        audioFile.setAudioBufferSize (2, 3072);
+        audioFile.setSampleRate (44100);
+        
+        for (int channel = 0; channel < 2; channel++)
+        {
+            for (int i = 0; i < 3072; i++)
+            {
+                float value = 0.f;
+                
+                if (i < 1000)
+                    value = static_cast<float> ((i * 37 + channel * 11) % 255 - 127) / 128.f;
+                else if (i >= 1024 && i < 2048)
+                    value = channel == 1 && i % 2 == 1 ? -0.f : 0.f;
+                else if (i >= 2048)
+                    value = channel == 1 ? -0.f : 0.f;
+                
+                audioFile.samples[channel][i] = value;
+            }
+        }
+    }
+    
+    //=============================================================
+    TEST_CASE ("SparseAudioBufferTests::SavedFilesAreUnchanged")
+    {
+        for (auto format : { AudioFileFormat::Wave, AudioFileFormat::Aiff })
+        {
+            for (int bitDepth : { 8, 16, 24, 32 })
+            {
+                AudioFile<float> audioFile;
+                fillWithSignedZeros (audioFile);
+                audioFile.setBitDepth (bitDepth);
+                
+                std::string fileName = "sparse_stereo_" + std::to_string (bitDepth) + "bit" + (format == AudioFileFormat::Wave ? ".wav" : ".aif");
+                std::string denseFilePath = projectBuildDirectory + "/audio-write-tests/dense-" + fileName;
+                std::string sparseFilePath = projectBuildDirectory + "/audio-write-tests/" + fileName;
+                
+                std::vector<uint8_t> reference = readFile (projectBuildDirectory + "/test-audio/reference-saves/" + fileName);
+                REQUIRE_FALSE (reference.empty());
+                
+                REQUIRE (audioFile.save (denseFilePath, format));
+                CHECK (readFile (denseFilePath) == reference);
+                
+                SparseAudioBuffer<float> sparse (256);
+                REQUIRE (sparse.store (audioFile));
+                REQUIRE (sparse.save (sparseFilePath, format));
+                CHECK (readFile (sparseFilePath) == reference);
+                
+                // only the blocks of positive zeros are digital silence
+                CHECK (sparse.getNumSilentBlocks() == 8);
+                CHECK (std::signbit (sparse.getSample (1, 1025)));
+                CHECK (std::signbit (sparse.getSample (1, 3000)));
+            }
+        }
+        
+        // silence for unsigned types isn't written as zero bytes
+        AudioFile<uint16_t> unsignedAudio;
+        unsignedAudio.setBitDepth (16);
+        unsignedAudio.setAudioBufferSize (2, 5000);
+        unsignedAudio.samples[0][4999] = 65535;
+        
+        std::string filePath = projectBuildDirectory + "/audio-write-tests/sparse-unsigned.wav";
+        REQUIRE (unsignedAudio.save (filePath));
+        
+        AudioFile<uint16_t> reloaded;
+        REQUIRE (reloaded.load (filePath));
+        CHECK (reloaded.samples == unsignedAudio.samples);
+    }
+    
+    //=============================================================
+    TEST_CASE ("SparseAudioBufferTests::SilenceThreshold")
+    {
+        AudioFile<int16_t> audioFile;
+        audioFile.setBitDepth (16);
+        fillWithMostlySilentAudio (audioFile, 1, 44100 * 3, 10000.);
+        
+        // low level noise in the silent parts
+        for (int i = 0; i < audioFile.getNumSamplesPerChannel(); i++)
+        {
+            if (audioFile.samples[0][i] == 0)
+                audioFile.samples[0][i] = static_cast<int16_t> ((i % 7) - 3);
+        }
+        
+        SparseAudioBuffer<int16_t> lossless;
+        REQUIRE (lossless.store (audioFile));
+        CHECK (lossless.getNumSilentBlocks() == 0);
+        
+        SparseAudioBuffer<int16_t> thresholded;
+        thresholded.setSilenceThreshold (3);
+        REQUIRE (thresholded.store (audioFile));
+        CHECK (thresholded.getNumSilentBlocks() > 0);
+        CHECK (thresholded.getSample (0, 44100 + 5000) == 0);
+        CHECK (thresholded.getSample (0, 10) == audioFile.samples[0][10]);
+    }
+    
+    //=============================================================
+    TEST_CASE ("SparseAudioBufferTests::UnsignedSilenceIsTheMidpoint")
+    {
+        AudioFile<uint8_t> audioFile;
+        audioFile.setBitDepth (8);
+        audioFile.setAudioBufferSize (1, 4096 * 3);
+        
+        for (int i = 0; i < audioFile.getNumSamplesPerChannel(); i++)
+            audioFile.samples[0][i] = 128;
+        
+        // a loud negative sample in the second block and low level noise in the third
+        audioFile.samples[0][4096 + 10] = 1;
+        audioFile.samples[0][4096 * 2 + 10] = 130;
+        
+        SparseAudioBuffer<uint8_t> lossless;
+        REQUIRE (lossless.store (audioFile));
+        CHECK (lossless.getNumSilentBlocks() == 1);
+        CHECK (lossless.getSample (0, 10) == 128);
+        
+        SparseAudioBuffer<uint8_t> thresholded;
+        thresholded.setSilenceThreshold (3);
+        REQUIRE (thresholded.store (audioFile));
+        CHECK (thresholded.getNumSilentBlocks() == 2);
+        CHECK (thresholded.getSample (0, 4096 + 10) == 1);
+        CHECK (thresholded.getSample (0, 4096 * 2 + 10) == 128);
+        
+        AudioFile<uint8_t> copy;
+        REQUIRE (lossless.copyTo (copy));
+        CHECK (copy.samples == audioFile.samples);
+    }
+}